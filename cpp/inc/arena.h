@@ -0,0 +1,93 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "page_mapping.h"
+#include "span.h"
+
+/**
+ * @brief Bump allocator for scratch space that is thrown away in bulk.
+ *
+ * Allocation is a pointer bump; nothing is freed until `reset`, which
+ * makes all of it reusable at once. When a reset finds the memory spread
+ * over several blocks it merges them, so after the first few resets a
+ * repeated workload runs out of a single block without allocating.
+ *
+ * Large arenas can ask for huge pages, which cuts TLB misses when the
+ * data in them is read at random. Blocks are then mapped in 2 MB units;
+ * `huge_page_coverage` reports what the kernel actually provided.
+ */
+class Arena
+{
+private:
+
+  struct Block {
+    std::unique_ptr<unsigned char[]> heap;
+    Page_mapping mapping;
+    unsigned char* data;
+    std::size_t size;
+  };
+
+  bool m_huge_pages;
+  std::vector<Block> m_blocks {};
+  std::size_t m_block {0};
+  std::size_t m_offset {0};
+  std::size_t m_used {0};
+  std::size_t m_high_water {0};
+
+  [[nodiscard]] auto make_block(std::size_t size) const -> Block;
+
+  [[nodiscard]] auto allocate_slow(std::size_t bytes, std::size_t align)
+      -> void*;
+
+public:
+
+  static constexpr std::size_t default_capacity {64 * 1024};
+  static constexpr std::size_t default_align {alignof(std::max_align_t)};
+
+  explicit Arena(std::size_t capacity = default_capacity,
+                 bool huge_pages = false);
+
+  /// `bytes` of storage aligned to `align`, a power of two
+  [[nodiscard]] auto allocate(std::size_t bytes,
+                              std::size_t align = default_align) -> void*;
+
+  /// `count` value-initialized objects, never destroyed
+  template <typename T>
+  [[nodiscard]] auto make_array(const std::size_t count) -> Span<T>
+  {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena objects are never destroyed");
+    T* const data {
+        static_cast<T*>(allocate(count * sizeof(T), alignof(T)))};
+    std::uninitialized_value_construct_n(data, count);
+    return {data, count};
+  }
+
+  /// Make every allocation reusable; pointers handed out dangle
+  void reset();
+
+  /// Bytes handed out since the last reset, including padding
+  [[nodiscard]] auto used() const noexcept -> std::size_t
+  {
+    return m_used;
+  }
+
+  /// Most bytes ever in use between resets
+  [[nodiscard]] auto high_water() const noexcept -> std::size_t
+  {
+    return m_high_water;
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t;
+
+  /// Huge-page coverage of every block, as the kernel reports it now
+  [[nodiscard]] auto huge_page_coverage() const -> Huge_page_coverage;
+};
+
+#endif
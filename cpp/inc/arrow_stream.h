@@ -0,0 +1,84 @@
+#ifndef ARROW_STREAM_H
+#define ARROW_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "result_writer.h"
+
+/**
+ * @brief A table written as an Apache Arrow IPC stream.
+ *
+ * Columns are non-nullable 32-bit or 64-bit integers, doubles, or
+ * strings. Strings are dictionary encoded: each distinct value is stored
+ * once, in order of first appearance, and the column holds 32-bit
+ * indices into it. The stream is a schema message, one dictionary batch
+ * per string column, a single record batch and the end-of-stream marker,
+ * with every buffer 8-byte aligned so readers can map it without
+ * copying.
+ *
+ * Adding a column whose length differs from `rows()` throws
+ * `std::invalid_argument`.
+ */
+class Arrow_table
+{
+public:
+
+  enum class Column_type : std::uint8_t {
+    int32,
+    int64,
+    float64,
+    dictionary
+  };
+
+  struct Column {
+    std::string name {};
+    Column_type type {Column_type::int32};
+    /// Little-endian values; dictionary indices for strings
+    std::vector<unsigned char> values {};
+    std::vector<std::string> dictionary {};
+  };
+
+private:
+
+  std::size_t m_rows;
+  std::vector<Column> m_columns {};
+
+  void add(std::string name, Column_type type, const void* values,
+           std::size_t count, std::size_t width);
+
+public:
+
+  explicit Arrow_table(std::size_t rows);
+
+  void add_int32(std::string name,
+                 const std::vector<std::int32_t>& values);
+
+  void add_int64(std::string name,
+                 const std::vector<std::int64_t>& values);
+
+  void add_float64(std::string name, const std::vector<double>& values);
+
+  void add_strings(std::string name,
+                   const std::vector<std::string>& values);
+
+  [[nodiscard]] auto rows() const noexcept -> std::size_t
+  {
+    return m_rows;
+  }
+
+  [[nodiscard]] auto columns() const noexcept
+      -> const std::vector<Column>&
+  {
+    return m_columns;
+  }
+
+  /// Hand the whole stream to `sink`, one message at a time
+  void write(const Byte_sink& sink) const;
+
+  [[nodiscard]] auto encode() const -> std::vector<unsigned char>;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Minimum-cost rectangular assignment (the Hungarian method).
+ *
+ * Every row is matched to a distinct column in O(rows² · columns). The
+ * solver keeps its scratch space between calls, so solving many small
+ * problems allocates nothing after the first.
+ */
+class Assignment_solver
+{
+private:
+
+  std::vector<double> m_row_potential {};
+  std::vector<double> m_column_potential {};
+  std::vector<std::size_t> m_row_of_column {};
+  std::vector<std::size_t> m_previous {};
+  std::vector<double> m_slack {};
+  std::vector<bool> m_used {};
+  std::vector<std::size_t> m_column_of_row {};
+
+public:
+
+  static constexpr std::size_t unmatched {~std::size_t {0}};
+
+  /**
+   * `cost` is row-major, `rows * columns` entries, and `rows` may not
+   * exceed `columns`. Returns the column of every row; the reference is
+   * valid until the next call.
+   */
+  auto solve(std::size_t rows, std::size_t columns, const double* cost)
+      -> const std::vector<std::size_t>&;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef ASYNC_FILE_H
+#define ASYNC_FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "page_mapping.h"
+#include "result_writer.h"
+
+enum class Write_backend : std::uint8_t {
+  /// Writes queued through io_uring while the next buffer fills
+  io_uring,
+  /// Synchronous `pwrite`, for kernels without io_uring
+  pwrite
+};
+
+struct Async_file_params {
+  /// Size of each of the two buffers; rounded up to whole pages
+  std::size_t buffer_bytes {std::size_t {4} << 20};
+  /// Bypass the page cache where the file system allows it
+  bool direct {true};
+  /// Skip io_uring even where the kernel has it
+  bool force_pwrite {false};
+};
+
+/**
+ * @brief Append-only file written in large aligned blocks.
+ *
+ * Appends fill one of two page-aligned buffers. A full buffer is queued
+ * as a single write and appends carry on in the other one, so the caller
+ * only waits when it fills a buffer before the previous write finished.
+ * With `O_DIRECT` the final partial block is padded for the write and
+ * the file truncated back to the bytes appended.
+ *
+ * Throws `std::runtime_error` if the file cannot be opened or written.
+ */
+class Async_file_writer
+{
+private:
+
+  class Ring;
+
+  int m_descriptor {-1};
+  bool m_direct {false};
+  bool m_failed {false};
+  std::unique_ptr<Ring> m_ring;
+  std::array<Page_mapping, 2> m_buffers {};
+  std::array<bool, 2> m_in_flight {};
+  /// Length and file offset of each buffer's latest write
+  std::array<std::size_t, 2> m_length {};
+  std::array<std::uint64_t, 2> m_position {};
+  std::size_t m_current {0};
+  std::size_t m_used {0};
+  std::uint64_t m_offset {0};
+  std::uint64_t m_bytes {0};
+
+  void submit(std::size_t buffer, std::size_t length);
+
+  void wait(std::size_t buffer);
+
+  /// Finish the write at `offset` synchronously
+  void write_rest(const unsigned char* data, std::size_t length,
+                  std::uint64_t offset);
+
+  /// Where to resume after a short write of `wrote` bytes
+  [[nodiscard]] auto resume_point(std::size_t wrote) const noexcept
+      -> std::size_t;
+
+  /// Give up on every queued write and close the file
+  void abandon() noexcept;
+
+public:
+
+  /// Creates or truncates `path`
+  explicit Async_file_writer(const std::string& path,
+                             const Async_file_params& params = {});
+
+  Async_file_writer(const Async_file_writer&) = delete;
+  auto operator=(const Async_file_writer&) -> Async_file_writer& = delete;
+  Async_file_writer(Async_file_writer&&)                         = delete;
+  auto operator=(Async_file_writer&&) -> Async_file_writer&      = delete;
+
+  /// Closes the file; an unreported failure to write the tail ends the
+  /// program rather than losing data quietly, unless another exception
+  /// is already unwinding
+  ~Async_file_writer();
+
+  void append(const unsigned char* data, std::size_t size);
+
+  /// Write everything appended and close the file; later calls do
+  /// nothing
+  void close();
+
+  [[nodiscard]] auto backend() const noexcept -> Write_backend
+  {
+    return m_ring ? Write_backend::io_uring : Write_backend::pwrite;
+  }
+
+  /// Whether the file was opened with `O_DIRECT`
+  [[nodiscard]] auto direct() const noexcept -> bool
+  {
+    return m_direct;
+  }
+
+  /// Bytes appended so far
+  [[nodiscard]] auto bytes() const noexcept -> std::uint64_t
+  {
+    return m_bytes;
+  }
+
+  /// Appends to this file, which must outlive the sink
+  [[nodiscard]] auto sink() -> Byte_sink;
+};
+
+#endif
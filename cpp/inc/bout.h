@@ -0,0 +1,67 @@
+#ifndef BOUT_H
+#define BOUT_H
+
+#include <cstdint>
+
+/** How a bout was decided. */
+enum class Result_type : std::uint8_t {
+  decision,
+  major_decision,
+  tech_fall,
+  fall,
+  forfeit,
+  injury_default,
+  disqualification
+};
+
+/**
+ * @brief One completed bout.
+ *
+ * `winner` and `loser` are `Wrestler::id()` values; `date` is a day
+ * number (days since 1970-01-01).
+ */
+struct Bout {
+  int winner {};
+  int loser {};
+  int date {};
+  int tournament {};
+  std::int16_t winner_score {};
+  std::int16_t loser_score {};
+  Result_type result {Result_type::decision};
+};
+
+/// Day number of a proleptic Gregorian date, 1970-01-01 being day 0
+[[nodiscard]] constexpr auto days_from_civil(int year, const int month,
+                                             const int day) noexcept -> int
+{
+  year -= month <= 2 ? 1 : 0;
+  const int era {(year >= 0 ? year : year - 399) / 400};
+  const int year_of_era {year - era * 400};
+  const int shifted_month {month > 2 ? month - 3 : month + 9};
+  const int day_of_year {(153 * shifted_month + 2) / 5 + day - 1};
+  const int day_of_era {year_of_era * 365 + year_of_era / 4
+                        - year_of_era / 100 + day_of_year};
+  return era * 146097 + day_of_era - 719468;
+}
+
+/// Inclusive range of day numbers
+struct Season {
+  int first_day {};
+  int last_day {};
+
+  /// The scholastic season starting November 1 of `start_year`
+  [[nodiscard]] static constexpr auto
+  starting(const int start_year) noexcept -> Season
+  {
+    return {days_from_civil(start_year, 11, 1),
+            days_from_civil(start_year + 1, 3, 31)};
+  }
+
+  [[nodiscard]] constexpr auto contains(const int day) const noexcept
+      -> bool
+  {
+    return first_day <= day && day <= last_day;
+  }
+};
+
+#endif
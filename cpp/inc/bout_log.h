@@ -0,0 +1,188 @@
+#ifndef BOUT_LOG_H
+#define BOUT_LOG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "async_file.h"
+#include "bout.h"
+#include "mapped_file.h"
+
+/// One bout of a simulated tournament
+struct Bout_event {
+  std::uint64_t tournament {};
+  /// Bout number within the tournament
+  std::uint32_t slot {};
+  int winner {};
+  int loser {};
+  std::int16_t winner_score {};
+  std::int16_t loser_score {};
+  /// Seconds
+  std::uint16_t duration {};
+  Result_type result {Result_type::decision};
+};
+
+/**
+ * @brief Layout shared by `Bout_log_writer` and `Bout_log`.
+ *
+ * A log is a header, a run of blocks, a block index and a trailer, all
+ * little-endian; only little-endian hosts can build it. Each block holds
+ * whole tournaments in ascending order. A tournament lists its distinct
+ * wrestler ids once, sorted and delta encoded, and its bouts refer to
+ * them by position; slots, scores and durations are stored as deltas or
+ * small varints. Every block and the index carry a checksum.
+ */
+struct Bout_log_format {
+  static constexpr std::array<char, 8> magic {'W', 'R', 'B', 'L',
+                                              'O', 'G', 'S', '1'};
+
+  struct Header {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t reserved;
+  };
+
+  struct Block_entry {
+    std::uint64_t offset;
+    std::uint64_t first_tournament;
+    std::uint64_t last_tournament;
+    std::uint32_t bytes;
+    std::uint32_t events;
+    std::uint64_t checksum;
+  };
+
+  struct Trailer {
+    std::uint64_t index;
+    std::uint64_t block_count;
+    std::uint64_t event_count;
+    std::uint64_t index_checksum;
+    std::array<char, 8> magic;
+  };
+
+  static constexpr std::uint32_t version {1};
+};
+
+/// Checksum of a block or of the index
+[[nodiscard]] auto log_checksum(const unsigned char* data,
+                                std::size_t size) noexcept
+    -> std::uint64_t;
+
+/**
+ * @brief Streams bout events into a new log file.
+ *
+ * Events must arrive grouped by tournament with ids never decreasing;
+ * anything else throws `std::invalid_argument`. A block is sealed once
+ * it reaches `block_bytes`, so a tournament is never split across
+ * blocks.
+ */
+class Bout_log_writer
+{
+private:
+
+  Async_file_writer m_file;
+  std::size_t m_block_bytes;
+  std::vector<Bout_event> m_tournament {};
+  std::vector<int> m_ids {};
+  std::vector<unsigned char> m_body {};
+  std::vector<unsigned char> m_block {};
+  Bout_log_format::Block_entry m_entry {};
+  std::vector<Bout_log_format::Block_entry> m_index {};
+  std::uint64_t m_offset {0};
+  std::uint64_t m_events {0};
+  std::uint64_t m_last_tournament {0};
+  bool m_started {false};
+  bool m_closed {false};
+  /// A write failed and the caller has already been told
+  bool m_failed {false};
+
+  void encode_tournament();
+
+  void seal_block();
+
+public:
+
+  static constexpr std::size_t default_block_bytes {16 * 1024};
+
+  explicit Bout_log_writer(const std::string& path,
+                           std::size_t block_bytes = default_block_bytes);
+
+  Bout_log_writer(const Bout_log_writer&) = delete;
+  auto operator=(const Bout_log_writer&) -> Bout_log_writer& = delete;
+  Bout_log_writer(Bout_log_writer&&)                         = delete;
+  auto operator=(Bout_log_writer&&) -> Bout_log_writer&      = delete;
+
+  /// Closes the log; an unreported failure to finish it ends the
+  /// program, unless another exception is already unwinding
+  ~Bout_log_writer();
+
+  void append(const Bout_event& event);
+
+  /// Write the remaining blocks, the index and the trailer
+  void close();
+};
+
+/**
+ * @brief Read-only view of a bout log.
+ *
+ * Looking up a tournament binary searches the block index and decodes
+ * only the block that holds it. Blocks are checked against their
+ * checksums as they are decoded; a mismatch or a malformed file throws
+ * `std::runtime_error`.
+ */
+class Bout_log
+{
+private:
+
+  Mapped_file m_file;
+  Bout_log_format::Trailer m_trailer {};
+  std::vector<Bout_log_format::Block_entry> m_index {};
+
+  /// Decode `block` into `out`, everything or only `wanted`
+  void decode(std::size_t block, std::vector<Bout_event>& out, bool all,
+              std::uint64_t wanted) const;
+
+public:
+
+  explicit Bout_log(const std::string& path);
+
+  [[nodiscard]] auto events() const noexcept -> std::uint64_t
+  {
+    return m_trailer.event_count;
+  }
+
+  [[nodiscard]] auto blocks() const noexcept -> std::size_t
+  {
+    return m_index.size();
+  }
+
+  [[nodiscard]] auto bytes() const noexcept -> std::size_t
+  {
+    return m_file.size();
+  }
+
+  /// Replace `out` with the events of `block`, in the order written
+  void decode_block(std::size_t block,
+                    std::vector<Bout_event>& out) const;
+
+  /// Every event of `tournament`; empty if it is not in the log
+  [[nodiscard]] auto tournament(std::uint64_t tournament) const
+      -> std::vector<Bout_event>;
+
+  /// Decode every event in order, calling `func(const Bout_event&)`
+  template <typename Func>
+  void scan(Func&& func) const
+  {
+    std::vector<Bout_event> decoded;
+    for ( std::size_t block {0}; block != m_index.size(); ++block ) {
+      decode_block(block, decoded);
+      for ( const Bout_event& event : decoded ) {
+        func(event);
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef BOUT_STORE_H
+#define BOUT_STORE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bout.h"
+#include "mapped_file.h"
+#include "span.h"
+
+/**
+ * @brief One wrestler's entry for one bout in a segment's postings.
+ *
+ * Postings are stored uncompressed so queries hand them out in place.
+ */
+struct Posting {
+  std::int32_t date;
+  std::uint32_t row;
+  std::int32_t opponent;
+  std::uint8_t won;
+  Result_type result;
+  std::uint16_t reserved;
+};
+
+static_assert(sizeof(Posting) == 16);
+
+/**
+ * @brief A sealed, memory-mapped segment of the bout store.
+ *
+ * Rows are kept in date order and stored column by column in blocks of
+ * `block_rows`; dates and tournament ids are delta encoded and every
+ * column is varint packed. A sorted id directory points into the
+ * postings, which are ordered by (id, date).
+ *
+ * Segment files are little-endian.
+ */
+class Bout_segment
+{
+public:
+
+  static constexpr std::uint32_t block_rows {128};
+  static constexpr std::size_t column_count {6};
+
+  struct Header {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t row_count;
+    std::uint32_t block_count;
+    std::uint32_t id_count;
+    std::int32_t first_date;
+    std::int32_t last_date;
+    std::uint64_t block_index;
+    std::uint64_t directory;
+    std::uint64_t postings;
+    std::uint64_t columns;
+    std::uint64_t file_size;
+  };
+
+  struct Block_entry {
+    std::uint64_t offset;
+    std::array<std::uint32_t, column_count> column;
+    std::uint32_t rows;
+    std::int32_t first_date;
+  };
+
+  struct Directory_entry {
+    std::int32_t id;
+    std::uint32_t count;
+    std::uint64_t first;
+  };
+
+private:
+
+  Mapped_file m_file;
+  Header m_header {};
+
+  [[nodiscard]] auto blocks() const noexcept -> const Block_entry*;
+  [[nodiscard]] auto directory() const noexcept -> const Directory_entry*;
+  [[nodiscard]] auto postings() const noexcept -> const Posting*;
+
+  void decode_block(std::size_t block, Bout* out) const noexcept;
+
+public:
+
+  /// Map and validate an existing segment file
+  explicit Bout_segment(const std::string& path);
+
+  /// Encode `bouts` (any order) into a new segment file at `path`,
+  /// synced to disk before it appears under that name
+  static void write(const std::string& path,
+                    const std::vector<Bout>& bouts);
+
+  [[nodiscard]] auto rows() const noexcept -> std::size_t
+  {
+    return m_header.row_count;
+  }
+
+  [[nodiscard]] auto first_date() const noexcept -> int
+  {
+    return m_header.first_date;
+  }
+
+  [[nodiscard]] auto last_date() const noexcept -> int
+  {
+    return m_header.last_date;
+  }
+
+  /// Decode a single row
+  [[nodiscard]] auto bout(std::size_t row) const -> Bout;
+
+  /// Every posting of wrestler `id`, viewed in place in the mapping
+  [[nodiscard]] auto postings_of(int id) const noexcept
+      -> Span<const Posting>;
+
+  /// Postings of wrestler `id` dated within `season`
+  [[nodiscard]] auto postings_of(int id, Season season) const noexcept
+      -> Span<const Posting>;
+
+  /// Decode every row in date order, calling `func(const Bout&)`
+  template <typename Func>
+  void scan(Func&& func) const
+  {
+    std::array<Bout, block_rows> decoded {};
+    for ( std::size_t block {0}; block != m_header.block_count; ++block ) {
+      decode_block(block, decoded.data());
+      for ( std::size_t row {0}; row != blocks()[block].rows; ++row ) {
+        func(decoded[row]);
+      }
+    }
+  }
+};
+
+/// Postings found in one segment
+struct Posting_run {
+  std::size_t segment;
+  Span<const Posting> postings;
+};
+
+/**
+ * @brief Append-only bout history stored as a directory of segments.
+ *
+ * Appended bouts are buffered in memory until `flush()` seals them into
+ * a new segment. Sealed segments are never modified.
+ */
+class Bout_store
+{
+private:
+
+  std::string m_directory;
+  std::vector<Bout_segment> m_segments {};
+  std::vector<Bout> m_pending {};
+  /// Number in the name of the next segment to be written
+  std::size_t m_next_segment {0};
+
+public:
+
+  /// Open (creating if needed) the store in `directory`
+  explicit Bout_store(std::string directory);
+
+  void append(const Bout& bout)
+  {
+    m_pending.push_back(bout);
+  }
+
+  /// Seal pending bouts into a new segment; no-op if none are pending
+  void flush();
+
+  [[nodiscard]] auto pending() const noexcept -> std::size_t
+  {
+    return m_pending.size();
+  }
+
+  [[nodiscard]] auto segments() const noexcept
+      -> const std::vector<Bout_segment>&
+  {
+    return m_segments;
+  }
+
+  /// All sealed bouts of wrestler `id` in `season`, segment by segment
+  [[nodiscard]] auto bouts_of(int id, Season season) const
+      -> std::vector<Posting_run>;
+
+  /// Decode every sealed bout, oldest segment first
+  template <typename Func>
+  void scan(Func&& func) const
+  {
+    for ( const auto& segment : m_segments ) {
+      segment.scan(func);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef BRACKET_H
+#define BRACKET_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/// Marks an empty line in a bracket's line-to-entrant table
+constexpr inline std::size_t bye_line {~std::size_t {0}};
+
+/// Smallest power of two that holds `entrants`, at least 2
+[[nodiscard]] inline auto bracket_size(const std::size_t entrants) noexcept
+    -> std::size_t
+{
+  std::size_t size {2};
+  while ( size < entrants ) {
+    size *= 2;
+  }
+  return size;
+}
+
+/// Number of rounds in a bracket of `size` lines
+[[nodiscard]] inline auto bracket_rounds(std::size_t size) noexcept
+    -> std::size_t
+{
+  std::size_t rounds {0};
+  while ( size > 1 ) {
+    size /= 2;
+    ++rounds;
+  }
+  return rounds;
+}
+
+/**
+ * @brief Standard seed number (1-based) of each line of a bracket.
+ *
+ * Seeds 1 and 2 can only meet in the final, 1 through 4 in the
+ * semifinals, and so on. Seeds past the entrant count are byes.
+ */
+[[nodiscard]] inline auto seed_order(const std::size_t size)
+    -> std::vector<std::size_t>
+{
+  std::vector<std::size_t> order {1};
+  while ( order.size() < size ) {
+    const std::size_t doubled {order.size() * 2};
+    std::vector<std::size_t> next;
+    next.reserve(doubled);
+    for ( const std::size_t seed : order ) {
+      next.push_back(seed);
+      next.push_back(doubled + 1 - seed);
+    }
+    order = std::move(next);
+  }
+  return order;
+}
+
+#endif
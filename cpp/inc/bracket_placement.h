@@ -0,0 +1,76 @@
+#ifndef BRACKET_PLACEMENT_H
+#define BRACKET_PLACEMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bracket.h"
+
+/// A wrestler entered in a bracket
+struct Entrant {
+  /// Roster slot, carried through untouched
+  std::size_t slot {};
+  /// Negative for unattached
+  int team {-1};
+  /// Negative for unknown
+  int region {-1};
+  /// 1-based seed, 0 for unseeded
+  int seed {0};
+};
+
+struct Placement_rules {
+  /// Teammates may not meet before this round
+  int separation_round {3};
+  /// Weight of the geographic spread penalty
+  double region_weight {1.0};
+  /// Independent randomized searches, at least one; fixed so the same
+  /// seed gives the same draw on any machine
+  std::size_t restarts {8};
+  /// Swap attempts per search
+  std::size_t iterations {4000};
+  std::uint64_t seed {0};
+  /// Zero means one per hardware thread
+  std::size_t threads {0};
+};
+
+struct Placement_quality {
+  /// Teammate pairs that could meet before `separation_round`
+  int teammate_conflicts {};
+  /**
+   * Same-region pairs weighted by how early they can meet: a first-round
+   * meeting costs half the bracket's width, the final costs 1.
+   */
+  double region_penalty {};
+  std::size_t restarts {};
+
+  [[nodiscard]] constexpr auto feasible() const noexcept -> bool
+  {
+    return teammate_conflicts == 0;
+  }
+};
+
+struct Bracket_placement {
+  static constexpr std::size_t bye {bye_line};
+
+  /// Index into the entrant list for every line, or `bye`
+  std::vector<std::size_t> lines {};
+  Placement_quality quality {};
+};
+
+/**
+ * @brief Draw entrants into a bracket.
+ *
+ * Seeds go to their standard lines and byes face the top seeds. Every
+ * search places the unseeded entrants greedily, most constrained first,
+ * skipping lines whose separation block already holds a teammate. It then
+ * improves the draw by random swaps. The searches run in parallel and the
+ * best draw wins; a given `seed` always gives the same draw.
+ *
+ * Teammate conflicts the seeds force are counted but cannot be removed.
+ */
+[[nodiscard]] auto place_bracket(const std::vector<Entrant>& entrants,
+                                 const Placement_rules& rules = {})
+    -> Bracket_placement;
+
+#endif
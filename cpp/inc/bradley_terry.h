@@ -0,0 +1,120 @@
+#ifndef BRADLEY_TERRY_H
+#define BRADLEY_TERRY_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bout.h"
+#include "slot_map.h"
+
+/**
+ * @brief Symmetric head-to-head counts in compressed sparse row form.
+ *
+ * Row `i` lists every slot `i` has met together with the number of bouts
+ * between them; `wins(i)` is the total number of bouts `i` won.
+ */
+class Win_matrix
+{
+private:
+
+  std::vector<std::size_t> m_row_begin {0};
+  std::vector<std::uint32_t> m_column {};
+  std::vector<std::uint32_t> m_games {};
+  std::vector<std::uint32_t> m_wins {};
+
+public:
+
+  Win_matrix() = default;
+
+  Win_matrix(const std::vector<Bout>& bouts, const Slot_map& slots,
+             std::size_t slot_count);
+
+  [[nodiscard]] auto rows() const noexcept -> std::size_t
+  {
+    return m_wins.size();
+  }
+
+  [[nodiscard]] auto row_begin(const std::size_t row) const noexcept
+      -> std::size_t
+  {
+    return m_row_begin[row];
+  }
+
+  [[nodiscard]] auto row_end(const std::size_t row) const noexcept
+      -> std::size_t
+  {
+    return m_row_begin[row + 1];
+  }
+
+  [[nodiscard]] auto column(const std::size_t entry) const noexcept
+      -> std::size_t
+  {
+    return m_column[entry];
+  }
+
+  [[nodiscard]] auto games(const std::size_t entry) const noexcept
+      -> std::uint32_t
+  {
+    return m_games[entry];
+  }
+
+  [[nodiscard]] auto wins(const std::size_t row) const noexcept
+      -> std::uint32_t
+  {
+    return m_wins[row];
+  }
+
+  [[nodiscard]] auto entries() const noexcept -> std::size_t
+  {
+    return m_column.size();
+  }
+};
+
+struct Bradley_terry_params {
+  double tolerance {1e-6};
+  int max_iterations {500};
+  /**
+   * Virtual bouts each wrestler splits against a strength-1 opponent.
+   * Keeps undefeated and winless wrestlers finite and fixes the scale.
+   */
+  double prior_games {2.0};
+  /// Zero means one per hardware thread
+  std::size_t threads {0};
+};
+
+/// Result of a Bradley-Terry fit; usable with `apply_ratings`
+struct Bradley_terry_fit {
+  std::vector<double> strength {};
+  int iterations {};
+  double max_change {};
+  bool converged {};
+
+  /// Strength on the Elo scale, so 1500 is the prior opponent
+  [[nodiscard]] auto rating(const std::size_t slot) const noexcept
+      -> double
+  {
+    return 1500.0 + 400.0 * std::log10(strength[slot]);
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return strength.size();
+  }
+};
+
+/**
+ * @brief Fit Bradley-Terry strengths with Hunter's MM iteration.
+ *
+ * Each iteration is a Jacobi sweep split across threads. Pass the
+ * previous fit's strengths as `warm_start` to converge in a few sweeps;
+ * rows past its end, such as wrestlers added since, start from one.
+ */
+[[nodiscard]] auto
+fit_bradley_terry(const Win_matrix& matrix,
+                  const Bradley_terry_params& params = {},
+                  const std::vector<double>& warm_start = {})
+    -> Bradley_terry_fit;
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "weight_class.h"
+
+struct External_sort_params {
+  /// Memory for records: each run is built in it, and every run being
+  /// merged gets one block of it
+  std::size_t memory_bytes {std::size_t {256} << 20};
+  /// Bytes read from a run at a time while merging
+  std::size_t block_bytes {std::size_t {1} << 20};
+  /// Where runs are kept; empty means the system temporary directory
+  std::string scratch_directory {};
+  /// Threads sorting each run; zero means one per hardware thread
+  std::size_t threads {0};
+};
+
+/// One output of `partition_roster`
+struct Roster_partition {
+  std::string path {};
+  std::size_t wrestlers {};
+};
+
+struct Partition_report {
+  /// One per weight class, then one for wrestlers over every limit
+  std::vector<Roster_partition> partitions {};
+  std::size_t runs {};
+  /// Passes over the data after the runs are written, the last one
+  /// writing the partitions
+  std::size_t merge_passes {};
+};
+
+/**
+ * @brief Split a binary roster of any size into one binary roster per
+ * natural weight class, each sorted by ability, best first, then id.
+ *
+ * The input is read in chunks filling `memory_bytes`; each chunk is
+ * bucketed by class, each bucket sorted, and the chunk written out as a
+ * run of per-class segments. Runs are then merged class by class through
+ * a loser tree, as many at a time as `memory_bytes` holds blocks of
+ * `block_bytes`, with further passes over intermediate runs when there
+ * are more. Every read hints the kernel to fetch the following block, so
+ * the disk works ahead of the sort and merge. Memory use stays near
+ * `memory_bytes` plus the writers' buffers, whatever the input size.
+ *
+ * Classes `[0, size)` go to `<prefix><limit>.roster` and wrestlers over
+ * every limit to `<prefix>over.roster`. Scratch runs are removed on
+ * return. Throws `std::invalid_argument` for unusable parameters and
+ * `std::runtime_error` if a file cannot be read or written.
+ */
+auto partition_roster(const std::string& input,
+                      const Weight_classes& classes,
+                      const std::string& prefix,
+                      const External_sort_params& params = {})
+    -> Partition_report;
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef HEAD_TO_HEAD_H
+#define HEAD_TO_HEAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bout.h"
+
+class Bout_store;
+
+/// A pairing's record from one wrestler's point of view
+struct Head_to_head {
+  int wins {};
+  int losses {};
+  /// Day number of the latest meeting, meaningless if they never met
+  int last_met {};
+
+  [[nodiscard]] constexpr auto met() const noexcept -> bool
+  {
+    return wins + losses != 0;
+  }
+};
+
+/**
+ * @brief Head-to-head records for every pair that has met.
+ *
+ * Pairs are keyed on (lower id, higher id) and kept in open-addressing
+ * tables with linear probing, split into independently sized shards so
+ * a history can be loaded in parallel, one shard per task.
+ */
+class Head_to_head_index
+{
+public:
+
+  struct Entry {
+    std::uint64_t key;
+    std::uint32_t low_wins;
+    std::uint32_t high_wins;
+    std::int32_t last_met;
+  };
+
+private:
+
+  static constexpr unsigned shard_bits {6};
+  static constexpr std::size_t shard_count {std::size_t {1} << shard_bits};
+
+  struct Shard {
+    std::vector<Entry> slots;
+    std::size_t used;
+  };
+
+  std::vector<Shard> m_shards;
+
+  void insert(Shard& shard, std::uint64_t key, std::uint64_t hash,
+              const Bout& bout);
+
+  static void grow(Shard& shard);
+
+public:
+
+  Head_to_head_index();
+
+  /// Build from a bout history, partitioning the work by shard
+  explicit Head_to_head_index(const std::vector<Bout>& bouts,
+                              std::size_t threads = 0);
+
+  /// Build from every sealed bout in `store`
+  [[nodiscard]] static auto from_store(const Bout_store& store,
+                                       std::size_t threads = 0)
+      -> Head_to_head_index;
+
+  /// Fold one more bout in
+  void record(const Bout& bout);
+
+  /// The record of `id` against `opponent`
+  [[nodiscard]] auto lookup(int id, int opponent) const noexcept
+      -> Head_to_head;
+
+  /// Number of distinct pairs that have met
+  [[nodiscard]] auto pairs() const noexcept -> std::size_t;
+};
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef LEAGUE_H
+#define LEAGUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "lineup.h"
+#include "numa.h"
+#include "random.h"
+#include "span.h"
+#include "weight_class.h"
+#include "wrestler.h"
+
+struct League_team {
+  std::string name {};
+  std::vector<Wrestler> roster {};
+};
+
+/// One round of duals, as (home, away) team indices
+using Dual_round = std::vector<std::pair<std::size_t, std::size_t>>;
+
+/**
+ * @brief Single round robin by the circle method.
+ *
+ * With an odd number of teams one team sits out each round. Each pairing
+ * is hosted by the team whose turn it is by round and board, so home and
+ * away duals come out close to even.
+ */
+[[nodiscard]] auto round_robin(std::size_t teams)
+    -> std::vector<Dual_round>;
+
+struct Standing {
+  std::size_t team;
+  int wins;
+  int losses;
+  int ties;
+  int points_for;
+  int points_against;
+  int bouts_won;
+
+  /// Wins plus half the ties, doubled to stay integral
+  [[nodiscard]] constexpr auto record_points() const noexcept -> int
+  {
+    return 2 * wins + ties;
+  }
+};
+
+struct League_params {
+  std::size_t seasons {1000};
+  std::uint64_t seed {0};
+  /// Zero means one per hardware thread
+  std::size_t threads {0};
+  /**
+   * When set, workers are pinned to its CPUs and read a copy of the
+   * schedule, duals and bout odds alike, on their own memory node
+   */
+  const Numa_topology* topology {nullptr};
+};
+
+struct League_summary {
+  std::size_t seasons {};
+  /// Share of seasons each team finished first
+  std::vector<double> title_probability {};
+  /// 1-based
+  std::vector<double> mean_place {};
+  /// Ties count as half a win
+  std::vector<double> mean_wins {};
+  /// Threads that asked to be pinned to a CPU and were refused
+  std::size_t pin_failures {};
+};
+
+/**
+ * @brief A league season of dual meets, ready to simulate many times.
+ *
+ * Every team enters its standard lineup, and the win probability of
+ * every scheduled bout is computed up front. A simulated dual that ends
+ * level on team points goes to the team with more bouts won, then more
+ * falls and forfeits, and is otherwise a tie.
+ *
+ * Standings order teams by record, then by record in duals among the
+ * tied teams, then by point differential, then by bouts won, and
+ * finally by lot.
+ */
+class League
+{
+private:
+
+  struct Scheduled_bout {
+    /// Chance the home wrestler wins; unused for forfeits
+    double home_win;
+    /// +1 home wins by forfeit, -1 away does, 0 bout wrestled, 2 neither
+    int forfeit;
+  };
+
+  struct Scheduled_dual {
+    std::size_t home;
+    std::size_t away;
+  };
+
+  /// Everything a simulated season reads; bout odds are worked out up
+  /// front, so rosters are never touched while simulating
+  struct Schedule {
+    std::vector<Scheduled_dual> duals {};
+    /// `m_classes` bouts per dual
+    std::vector<Scheduled_bout> bouts {};
+  };
+
+  std::size_t m_teams;
+  std::size_t m_classes;
+  Dual_scoring m_scoring;
+  Schedule m_schedule {};
+
+  [[nodiscard]] auto play_season(const Schedule& schedule, Rng& rng,
+                                 Arena& arena) const -> Span<Standing>;
+
+public:
+
+  League(const std::vector<League_team>& teams,
+         const Weight_classes& classes, const Lineup_rules& rules = {});
+
+  [[nodiscard]] auto teams() const noexcept -> std::size_t
+  {
+    return m_teams;
+  }
+
+  [[nodiscard]] auto duals() const noexcept -> std::size_t
+  {
+    return m_schedule.duals.size();
+  }
+
+  /**
+   * Simulate one season; standings come back first place first and live
+   * in `arena` until it is reset.
+   */
+  [[nodiscard]] auto simulate_season(Rng& rng, Arena& arena) const
+      -> Span<Standing>;
+
+  /// Season `n` draws from `Rng {params.seed, n}` whatever the threads
+  [[nodiscard]] auto simulate(const League_params& params = {}) const
+      -> League_summary;
+};
+
+#endif
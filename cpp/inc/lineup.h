@@ -0,0 +1,137 @@
+#ifndef LINEUP_H
+#define LINEUP_H
+
+#include <cstddef>
+#include <vector>
+
+#include "assignment.h"
+#include "bout.h"
+#include "weight_class.h"
+#include "wrestler.h"
+
+/// Team points a dual meet awards the winner of each bout
+struct Dual_scoring {
+  int decision {3};
+  int major_decision {4};
+  int tech_fall {5};
+  int fall {6};
+  /// Also awarded for defaults and disqualifications
+  int forfeit {6};
+
+  [[nodiscard]] constexpr auto points(const Result_type result)
+      const noexcept -> int
+  {
+    switch ( result ) {
+      case Result_type::decision:
+        return decision;
+      case Result_type::major_decision:
+        return major_decision;
+      case Result_type::tech_fall:
+        return tech_fall;
+      case Result_type::fall:
+        return fall;
+      case Result_type::forfeit:
+      case Result_type::injury_default:
+      case Result_type::disqualification:
+        break;
+    }
+    return forfeit;
+  }
+};
+
+/**
+ * @brief Expected team points `ours` gains minus those `theirs` gains.
+ *
+ * The winner of a close bout takes a decision; a winner's points rise
+ * linearly to a fall as their win probability goes from one half to
+ * certainty.
+ */
+[[nodiscard]] auto expected_bout_points(const Wrestler& ours,
+                                        const Wrestler& theirs,
+                                        const Dual_scoring& scoring = {})
+    -> double;
+
+struct Lineup_rules {
+  /// Pounds allowed over every class limit
+  int allowance {0};
+  /// Classes a wrestler may move up from their natural class
+  std::size_t classes_up {1};
+  Dual_scoring scoring {};
+};
+
+struct Lineup {
+  static constexpr std::size_t open {~std::size_t {0}};
+
+  /// Team slot entered at each weight class, or `open` for a forfeit
+  std::vector<std::size_t> wrestler_at {};
+  /// Expected team score minus the opponent's
+  double expected_margin {};
+};
+
+/**
+ * @brief A team's lineup when it does not tailor it to the opponent.
+ *
+ * Fills as many classes as possible, and among those lineups maximizes
+ * total ability. The margin is left at zero.
+ */
+[[nodiscard]] auto standard_lineup(const std::vector<Wrestler>& roster,
+                                   const Weight_classes& classes,
+                                   const Lineup_rules& rules = {})
+    -> Lineup;
+
+/**
+ * @brief Best lineup for one team against any lineup of another.
+ *
+ * Expected points for every pairing of the two rosters are computed
+ * once; each `optimize` call is then a single assignment of weight
+ * classes to wrestlers, where leaving a class open costs a forfeit.
+ */
+class Lineup_optimizer
+{
+private:
+
+  Weight_classes m_classes;
+  Lineup_rules m_rules;
+  std::size_t m_team_size;
+  std::size_t m_opponent_size;
+  /// Team slot by opponent slot
+  std::vector<double> m_points;
+  /// Team slot by weight class
+  std::vector<unsigned char> m_eligible;
+  std::vector<double> m_cost {};
+  Assignment_solver m_solver {};
+
+  void check(const std::vector<std::size_t>& lineup,
+             std::size_t roster_size) const;
+
+public:
+
+  Lineup_optimizer(const std::vector<Wrestler>& team,
+                   const std::vector<Wrestler>& opponents,
+                   Weight_classes classes, Lineup_rules rules = {});
+
+  [[nodiscard]] auto eligible(const std::size_t slot,
+                              const std::size_t weight_class)
+      const noexcept -> bool
+  {
+    return m_eligible[slot * m_classes.size() + weight_class] != 0;
+  }
+
+  [[nodiscard]] auto expected_points(const std::size_t slot,
+                                     const std::size_t opponent)
+      const noexcept -> double
+  {
+    return m_points[slot * m_opponent_size + opponent];
+  }
+
+  /// Expected margin of `lineup` against `opponent_lineup`
+  [[nodiscard]] auto
+  margin(const std::vector<std::size_t>& lineup,
+         const std::vector<std::size_t>& opponent_lineup) const -> double;
+
+  /// `opponent_lineup` holds an opponent slot or `Lineup::open` per class
+  [[nodiscard]] auto
+  optimize(const std::vector<std::size_t>& opponent_lineup) -> Lineup;
+};
+
+#endif
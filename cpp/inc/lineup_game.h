@@ -0,0 +1,58 @@
+#ifndef LINEUP_GAME_H
+#define LINEUP_GAME_H
+
+#include <cstddef>
+#include <vector>
+
+#include "lineup.h"
+#include "matrix_game.h"
+#include "weight_class.h"
+#include "wrestler.h"
+
+/**
+ * @brief Valid lineups for `roster`, at most `limit` of them.
+ *
+ * Each class takes an eligible wrestler not already entered, strongest
+ * first; a class is only left open when no such wrestler remains. When
+ * `limit` cuts the search short, the lineups kept are those that favour
+ * the strongest wrestlers in the lightest classes.
+ */
+[[nodiscard]] auto enumerate_lineups(const std::vector<Wrestler>& roster,
+                                     const Weight_classes& classes,
+                                     const Lineup_rules& rules,
+                                     std::size_t limit)
+    -> std::vector<std::vector<std::size_t>>;
+
+struct Lineup_game_params {
+  /// Candidate lineups enumerated per team
+  std::size_t max_lineups {512};
+  /// Zero means one per hardware thread
+  std::size_t threads {0};
+};
+
+struct Lineup_game {
+  std::vector<std::vector<std::size_t>> our_lineups {};
+  std::vector<std::vector<std::size_t>> their_lineups {};
+  /// Expected margin of every pairing of candidate lineups
+  Payoff_matrix payoff {};
+  /// Candidates left after removing dominated lineups
+  Surviving_strategies surviving {};
+  /// Mixed strategies over the surviving candidates
+  Game_solution solution {};
+};
+
+/**
+ * @brief Both coaches pick a lineup blind; find the equilibrium.
+ *
+ * Candidate lineups are enumerated for each team, every pairing's
+ * expected margin is evaluated in parallel, dominated lineups are pruned,
+ * and the remaining zero-sum game is solved for mixed strategies.
+ */
+[[nodiscard]] auto
+solve_lineup_game(const std::vector<Wrestler>& team,
+                  const std::vector<Wrestler>& opponents,
+                  const Weight_classes& classes,
+                  const Lineup_rules& rules = {},
+                  const Lineup_game_params& params = {}) -> Lineup_game;
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Throws `std::runtime_error` if the file cannot be opened or mapped.
+ */
+class Mapped_file
+{
+private:
+
+  const unsigned char* m_data {nullptr};
+  std::size_t m_size {0};
+
+public:
+
+  Mapped_file() = default;
+
+  explicit Mapped_file(const std::string& path);
+
+  Mapped_file(const Mapped_file&) = delete;
+  auto operator=(const Mapped_file&) -> Mapped_file& = delete;
+
+  Mapped_file(Mapped_file&& other) noexcept;
+  auto operator=(Mapped_file&& other) noexcept -> Mapped_file&;
+
+  ~Mapped_file();
+
+  [[nodiscard]] auto data() const noexcept -> const unsigned char*
+  {
+    return m_data;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_size;
+  }
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef MATRIX_GAME_H
+#define MATRIX_GAME_H
+
+#include <cstddef>
+#include <vector>
+
+/// Payoffs to the row player of a two-player zero-sum game
+class Payoff_matrix
+{
+private:
+
+  std::size_t m_rows {0};
+  std::size_t m_columns {0};
+  std::vector<double> m_payoff {};
+
+public:
+
+  Payoff_matrix() = default;
+
+  Payoff_matrix(const std::size_t rows, const std::size_t columns)
+      : m_rows {rows}
+      , m_columns {columns}
+      , m_payoff(rows * columns, 0.0)
+  {}
+
+  [[nodiscard]] auto rows() const noexcept -> std::size_t
+  {
+    return m_rows;
+  }
+
+  [[nodiscard]] auto columns() const noexcept -> std::size_t
+  {
+    return m_columns;
+  }
+
+  [[nodiscard]] auto operator()(const std::size_t row,
+                                const std::size_t column) const noexcept
+      -> double
+  {
+    return m_payoff[row * m_columns + column];
+  }
+
+  [[nodiscard]] auto operator()(const std::size_t row,
+                                const std::size_t column) noexcept
+      -> double&
+  {
+    return m_payoff[row * m_columns + column];
+  }
+
+  /// The rows and columns given, in that order
+  [[nodiscard]] auto submatrix(const std::vector<std::size_t>& rows,
+                               const std::vector<std::size_t>& columns)
+      const -> Payoff_matrix;
+};
+
+/// Strategies that survive iterated elimination of dominated ones
+struct Surviving_strategies {
+  std::vector<std::size_t> rows {};
+  std::vector<std::size_t> columns {};
+};
+
+/**
+ * @brief Iteratively remove weakly dominated rows and columns.
+ *
+ * Of several identical strategies only the first is kept. Removing weakly
+ * dominated strategies never changes the value of the game. Each pass
+ * checks every strategy in parallel.
+ */
+[[nodiscard]] auto prune_dominated(const Payoff_matrix& payoff,
+                                   std::size_t threads = 0)
+    -> Surviving_strategies;
+
+struct Game_solution {
+  /// Mixed strategy of the maximizing row player
+  std::vector<double> row_strategy {};
+  /// Mixed strategy of the minimizing column player
+  std::vector<double> column_strategy {};
+  double value {};
+};
+
+/**
+ * @brief Optimal mixed strategies by the simplex method.
+ *
+ * Solves the column player's linear program on a dense tableau with
+ * Bland's rule, and reads the row player's strategy off its duals.
+ */
+[[nodiscard]] auto solve_matrix_game(const Payoff_matrix& payoff)
+    -> Game_solution;
+
+#endif
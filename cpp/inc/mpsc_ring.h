@@ -0,0 +1,111 @@
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Bounded lock-free queue for many producers and one consumer.
+ *
+ * Every slot carries a sequence number telling producers and the consumer
+ * whose turn it is (after Vyukov), so a push is one compare-and-swap on
+ * the tail plus a copy. A full ring refuses the push instead of waiting;
+ * what to do then is the caller's decision.
+ */
+template <typename T>
+class Mpsc_ring
+{
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Ring records are copied byte for byte");
+
+private:
+
+  struct Slot {
+    std::atomic<std::size_t> sequence {0};
+    T value {};
+  };
+
+  std::unique_ptr<Slot[]> m_slots;
+  std::size_t m_mask;
+  alignas(64) std::atomic<std::size_t> m_tail {0};
+  alignas(64) std::atomic<std::size_t> m_head {0};
+
+public:
+
+  /// Room for at least `capacity` records
+  explicit Mpsc_ring(const std::size_t capacity)
+      : m_slots {}
+      , m_mask {0}
+  {
+    std::size_t size {1};
+    while ( size < capacity ) {
+      size *= 2;
+    }
+    m_slots = std::make_unique<Slot[]>(size);
+    m_mask  = size - 1;
+    for ( std::size_t index {0}; index != size; ++index ) {
+      m_slots[index].sequence.store(index, std::memory_order_relaxed);
+    }
+  }
+
+  /// Any thread; false if the ring is full
+  [[nodiscard]] auto try_push(const T& value) noexcept -> bool
+  {
+    std::size_t tail {m_tail.load(std::memory_order_relaxed)};
+    while ( true ) {
+      Slot& slot {m_slots[tail & m_mask]};
+      const std::size_t sequence {
+          slot.sequence.load(std::memory_order_acquire)};
+      if ( sequence == tail ) {
+        if ( m_tail.compare_exchange_weak(tail, tail + 1,
+                                          std::memory_order_relaxed) ) {
+          slot.value = value;
+          slot.sequence.store(tail + 1, std::memory_order_release);
+          return true;
+        }
+      } else if ( sequence < tail ) {
+        // the consumer has not freed this slot from the previous lap
+        return false;
+      } else {
+        tail = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Consumer only; false if the ring is empty
+  [[nodiscard]] auto try_pop(T& value) noexcept -> bool
+  {
+    const std::size_t head {m_head.load(std::memory_order_relaxed)};
+    Slot& slot {m_slots[head & m_mask]};
+    if ( slot.sequence.load(std::memory_order_acquire) != head + 1 ) {
+      return false;
+    }
+    value = slot.value;
+    slot.sequence.store(head + m_mask + 1, std::memory_order_release);
+    m_head.store(head + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t
+  {
+    return m_mask + 1;
+  }
+
+  /// Records ever pushed
+  [[nodiscard]] auto pushed() const noexcept -> std::size_t
+  {
+    return m_tail.load(std::memory_order_relaxed);
+  }
+
+  /// Records pushed but not yet popped; only a snapshot under contention
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    const std::size_t head {m_head.load(std::memory_order_relaxed)};
+    const std::size_t tail {m_tail.load(std::memory_order_relaxed)};
+    return tail > head ? tail - head : 0;
+  }
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Parse a sysfs CPU list such as "0-3,8,10-11"
+[[nodiscard]] auto parse_cpu_list(const std::string& list)
+    -> std::vector<int>;
+
+/// Pin the calling thread to `cpu`; false if the system refused
+auto pin_current_thread(int cpu) noexcept -> bool;
+
+struct Numa_node {
+  int id {};
+  std::vector<int> cpus {};
+};
+
+/**
+ * @brief Which CPUs belong to which memory node.
+ *
+ * Default-constructed, it describes a single node holding every hardware
+ * thread, which is also what `discover` falls back to when the system
+ * does not expose its topology.
+ */
+class Numa_topology
+{
+private:
+
+  std::vector<Numa_node> m_nodes {};
+  /// Node index of every CPU number
+  std::vector<std::size_t> m_node_of_cpu {};
+
+public:
+
+  Numa_topology();
+
+  /// Nodes without CPUs are dropped; with none left, as above
+  explicit Numa_topology(std::vector<Numa_node> nodes);
+
+  /// Read `root/node*/cpulist`, falling back to a single node
+  [[nodiscard]] static auto
+  discover(const std::string& root = "/sys/devices/system/node")
+      -> Numa_topology;
+
+  [[nodiscard]] auto nodes() const noexcept
+      -> const std::vector<Numa_node>&
+  {
+    return m_nodes;
+  }
+
+  [[nodiscard]] auto node_count() const noexcept -> std::size_t
+  {
+    return m_nodes.size();
+  }
+
+  /// Node index of `cpu`, or 0 if it is unknown
+  [[nodiscard]] auto node_of_cpu(int cpu) const noexcept -> std::size_t;
+
+  /// Node index the calling thread is running on
+  [[nodiscard]] auto current_node() const noexcept -> std::size_t;
+
+  /// Consecutive workers go to different nodes, then different CPUs
+  [[nodiscard]] auto node_for_worker(std::size_t worker) const noexcept
+      -> std::size_t
+  {
+    return worker % m_nodes.size();
+  }
+
+  [[nodiscard]] auto cpu_for_worker(std::size_t worker) const noexcept
+      -> int;
+};
+
+/**
+ * @brief `parallel_for` with every chunk on its own pinned thread.
+ *
+ * Chunks are split exactly as `parallel_for` splits them; chunk `k` runs
+ * on `topology.cpu_for_worker(k)`. The calling thread only waits, so its
+ * own affinity is left alone. A chunk whose thread cannot be pinned
+ * still runs, unpinned; returns how many did.
+ */
+template <typename Func>
+auto pinned_parallel_for(const Numa_topology& topology,
+                         const std::size_t count, Func&& func,
+                         std::size_t threads) -> std::size_t
+{
+  threads = std::max<std::size_t>(1, std::min(threads, count));
+  const std::size_t chunk_size {(count + threads - 1) / threads};
+
+  std::atomic<std::size_t> unpinned {0};
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for ( std::size_t chunk {0}; chunk != threads; ++chunk ) {
+    const std::size_t begin {std::min(count, chunk * chunk_size)};
+    const std::size_t end {std::min(count, begin + chunk_size)};
+    workers.emplace_back([&func, &topology, &unpinned, chunk, begin, end] {
+      if ( !pin_current_thread(topology.cpu_for_worker(chunk)) ) {
+        unpinned.fetch_add(1, std::memory_order_relaxed);
+      }
+      func(chunk, begin, end);
+    });
+  }
+  for ( auto& worker : workers ) {
+    worker.join();
+  }
+  return unpinned.load();
+}
+
+/**
+ * @brief One copy of read-only data per memory node.
+ *
+ * Each copy is made by a thread pinned to its node, so under the
+ * kernel's first-touch policy its pages are allocated on that node.
+ * Workers then read the copy of the node they run on.
+ */
+template <typename T>
+class Node_replicated
+{
+private:
+
+  std::vector<std::unique_ptr<const T>> m_copies {};
+  std::size_t m_pin_failures {0};
+
+public:
+
+  Node_replicated(const Numa_topology& topology, const T& original)
+      : m_copies(topology.node_count())
+  {
+    if ( topology.node_count() == 1 ) {
+      m_copies.front() = std::make_unique<const T>(original);
+      return;
+    }
+
+    std::atomic<std::size_t> unpinned {0};
+    std::vector<std::thread> builders;
+    for ( std::size_t node {0}; node != topology.node_count(); ++node ) {
+      builders.emplace_back([this, &topology, &original, &unpinned, node] {
+        if ( !pin_current_thread(topology.nodes()[node].cpus.front()) ) {
+          unpinned.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_copies[node] = std::make_unique<const T>(original);
+      });
+    }
+    for ( auto& builder : builders ) {
+      builder.join();
+    }
+    m_pin_failures = unpinned.load();
+  }
+
+  [[nodiscard]] auto copy(const std::size_t node) const noexcept
+      -> const T&
+  {
+    return *m_copies[node];
+  }
+
+  [[nodiscard]] auto nodes() const noexcept -> std::size_t
+  {
+    return m_copies.size();
+  }
+
+  /// Copies made by a thread that could not be pinned to their node,
+  /// and so may not be local to it
+  [[nodiscard]] auto pin_failures() const noexcept -> std::size_t
+  {
+    return m_pin_failures;
+  }
+};
+
+#endif
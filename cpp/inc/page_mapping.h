@@ -0,0 +1,102 @@
+#ifndef PAGE_MAPPING_H
+#define PAGE_MAPPING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+
+constexpr inline std::size_t huge_page_size {2 * 1024 * 1024};
+
+enum class Page_backing : std::uint8_t {
+  /// Ordinary pages
+  normal,
+  /// Ordinary mapping advised to use transparent huge pages
+  transparent,
+  /// Reserved huge pages from `MAP_HUGETLB`
+  huge_tlb
+};
+
+/// How much of a range the kernel actually backs with huge pages
+struct Huge_page_coverage {
+  std::size_t bytes {};
+  std::size_t huge_bytes {};
+
+  [[nodiscard]] auto fraction() const noexcept -> double
+  {
+    return bytes == 0 ? 0.0
+                      : static_cast<double>(huge_bytes)
+                            / static_cast<double>(bytes);
+  }
+
+  auto operator+=(const Huge_page_coverage& other) noexcept
+      -> Huge_page_coverage&
+  {
+    bytes += other.bytes;
+    huge_bytes += other.huge_bytes;
+    return *this;
+  }
+};
+
+/**
+ * @brief Huge-page coverage of `[begin, end)` from `/proc/self/smaps`
+ * text.
+ *
+ * Mappings with a 2 MB kernel page size count in full; others count
+ * their `AnonHugePages`. Only the parts of mappings inside the range are
+ * counted.
+ */
+[[nodiscard]] auto smaps_coverage(std::istream& smaps,
+                                  std::uintptr_t begin, std::uintptr_t end)
+    -> Huge_page_coverage;
+
+/**
+ * @brief Anonymous read-write memory mapping.
+ *
+ * Asked for huge pages, it first tries reserved huge pages and falls
+ * back to a 2 MB aligned ordinary mapping advised to use transparent
+ * huge pages; `backing` says which it got. Throws `std::bad_alloc` if
+ * no mapping can be made at all.
+ */
+class Page_mapping
+{
+private:
+
+  unsigned char* m_data {nullptr};
+  std::size_t m_size {0};
+  Page_backing m_backing {Page_backing::normal};
+
+public:
+
+  Page_mapping() = default;
+
+  Page_mapping(std::size_t bytes, bool huge);
+
+  Page_mapping(const Page_mapping&) = delete;
+  auto operator=(const Page_mapping&) -> Page_mapping& = delete;
+
+  Page_mapping(Page_mapping&& other) noexcept;
+  auto operator=(Page_mapping&& other) noexcept -> Page_mapping&;
+
+  ~Page_mapping();
+
+  [[nodiscard]] auto data() const noexcept -> unsigned char*
+  {
+    return m_data;
+  }
+
+  /// Bytes mapped, rounded up to a whole page
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_size;
+  }
+
+  [[nodiscard]] auto backing() const noexcept -> Page_backing
+  {
+    return m_backing;
+  }
+
+  /// What the kernel reports right now; untouched pages count as small
+  [[nodiscard]] auto coverage() const -> Huge_page_coverage;
+};
+
+#endif
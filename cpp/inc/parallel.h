@@ -0,0 +1,53 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/// Number of worker threads to use by default, never zero
+[[nodiscard]] inline auto hardware_threads() noexcept -> std::size_t
+{
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Split `[0, count)` into contiguous chunks and run
+ * `func(chunk, begin, end)` on each, one chunk per thread.
+ *
+ * The calling thread takes the last chunk. Returns once every chunk is
+ * done.
+ */
+template <typename Func>
+void parallel_for(const std::size_t count, Func&& func,
+                  std::size_t threads = 0)
+{
+  if ( threads == 0 ) {
+    threads = hardware_threads();
+  }
+  threads = std::max<std::size_t>(1, std::min(threads, count));
+
+  const std::size_t chunk_size {(count + threads - 1) / threads};
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+
+  for ( std::size_t chunk {0}; chunk + 1 < threads; ++chunk ) {
+    const std::size_t begin {chunk * chunk_size};
+    const std::size_t end {std::min(count, begin + chunk_size)};
+    workers.emplace_back([&func, chunk, begin, end] {
+      func(chunk, begin, end);
+    });
+  }
+
+  const std::size_t last_begin {
+      std::min(count, (threads - 1) * chunk_size)};
+  func(threads - 1, last_begin, count);
+
+  for ( auto& worker : workers ) {
+    worker.join();
+  }
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef PROBABILITY_TABLE_H
+#define PROBABILITY_TABLE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "rating.h"
+#include "wrestler.h"
+
+/// Chance `wrestler` beats `opponent`, reading abilities as Elo ratings
+[[nodiscard]] inline auto
+win_probability(const Wrestler& wrestler,
+                const Wrestler& opponent) noexcept -> double
+{
+  return expected_score(wrestler.ability(), opponent.ability());
+}
+
+/**
+ * @brief Dense matrix of pairwise win probabilities.
+ *
+ * `(i, j)` is the chance the i-th wrestler beats the j-th; the table
+ * keeps `(i, j) + (j, i) == 1`.
+ */
+class Probability_table
+{
+private:
+
+  std::size_t m_size {0};
+  std::vector<double> m_probability {};
+
+public:
+
+  Probability_table() = default;
+
+  explicit Probability_table(const std::size_t size)
+      : m_size {size}
+      , m_probability(size * size, 0.5)
+  {}
+
+  explicit Probability_table(const std::vector<Wrestler>& wrestlers)
+      : Probability_table {wrestlers.size()}
+  {
+    for ( std::size_t row {0}; row != m_size; ++row ) {
+      for ( std::size_t column {row + 1}; column != m_size; ++column ) {
+        set(row, column,
+            win_probability(wrestlers[row], wrestlers[column]));
+      }
+    }
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_size;
+  }
+
+  [[nodiscard]] auto operator()(const std::size_t wrestler,
+                                const std::size_t opponent) const noexcept
+      -> double
+  {
+    return m_probability[wrestler * m_size + opponent];
+  }
+
+  /// Set both directions of a pairing
+  void set(const std::size_t wrestler, const std::size_t opponent,
+           const double probability) noexcept
+  {
+    m_probability[wrestler * m_size + opponent] = probability;
+    m_probability[opponent * m_size + wrestler] = 1.0 - probability;
+  }
+
+  /// Row-major storage, `size() * size()` entries
+  [[nodiscard]] auto data() const noexcept -> const double*
+  {
+    return m_probability.data();
+  }
+};
+
+#endif
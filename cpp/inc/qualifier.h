@@ -0,0 +1,73 @@
+#ifndef QUALIFIER_H
+#define QUALIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "wrestler.h"
+
+struct Qualifier_district {
+  /// Roster slots entered in this district's bracket
+  std::vector<std::size_t> entrants {};
+  /// Region the district's qualifiers advance to
+  std::size_t region {};
+};
+
+/// District, regional and state tournaments for one weight class
+struct Qualifier_format {
+  std::vector<Qualifier_district> districts {};
+  std::size_t regions {1};
+  /// Places that qualify from each district to its region
+  std::size_t district_advance {4};
+  /// Places that qualify from each region to state
+  std::size_t region_advance {4};
+  /// Places awarded at state
+  std::size_t state_places {6};
+};
+
+struct Qualifier_params {
+  std::size_t trials {10000};
+  /// Trials per task; batches run concurrently with each other too
+  std::size_t batch {500};
+  std::uint64_t seed {0};
+  /// Zero means one per hardware thread
+  std::size_t threads {0};
+};
+
+struct Qualifier_odds {
+  std::size_t trials {};
+  std::size_t state_places {};
+  /// Per roster slot
+  std::vector<double> reach_region {};
+  std::vector<double> reach_state {};
+  /// Roster slot by state place, row-major
+  std::vector<double> place_probability {};
+
+  /// Chance `slot` finishes `place` (1-based) at state
+  [[nodiscard]] auto place(const std::size_t slot,
+                           const std::size_t place) const noexcept
+      -> double
+  {
+    return place_probability[slot * state_places + place - 1];
+  }
+
+  /// Chance `slot` places at state at all
+  [[nodiscard]] auto placed(std::size_t slot) const noexcept -> double;
+};
+
+/**
+ * @brief Monte Carlo odds of reaching and placing at state.
+ *
+ * Every bracket is seeded by ability and played with full placement.
+ * Each district, region and the state tournament is a task in a task
+ * graph: a region starts as soon as its own districts finish, so
+ * independent districts and regions run concurrently. Trial `t` of stage
+ * `s` draws from its own stream, so the odds depend only on the seed.
+ */
+[[nodiscard]] auto simulate_qualifiers(const std::vector<Wrestler>& roster,
+                                       const Qualifier_format& format,
+                                       const Qualifier_params& params = {})
+    -> Qualifier_odds;
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/// One step of splitmix64; used to expand seeds
+[[nodiscard]] constexpr auto splitmix64(std::uint64_t& state) noexcept
+    -> std::uint64_t
+{
+  std::uint64_t value {state += 0x9E3779B97F4A7C15ULL};
+  value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31U);
+}
+
+/**
+ * @brief xoshiro256** generator.
+ *
+ * Small, fast and reproducible across platforms, unlike the standard
+ * distributions. `Rng {seed, stream}` gives independent streams for
+ * parallel workers from one user-visible seed.
+ */
+class Rng
+{
+private:
+
+  std::array<std::uint64_t, 4> m_state {};
+
+  [[nodiscard]] static constexpr auto rotl(const std::uint64_t value,
+                                           const unsigned shift) noexcept
+      -> std::uint64_t
+  {
+    return (value << shift) | (value >> (64U - shift));
+  }
+
+public:
+
+  using result_type = std::uint64_t;
+
+  constexpr explicit Rng(const std::uint64_t seed,
+                         const std::uint64_t stream = 0) noexcept
+  {
+    std::uint64_t state {seed ^ (stream * 0xD1B54A32D192ED03ULL)};
+    for ( auto& word : m_state ) {
+      word = splitmix64(state);
+    }
+  }
+
+  [[nodiscard]] static constexpr auto min() noexcept -> result_type
+  {
+    return 0;
+  }
+
+  [[nodiscard]] static constexpr auto max() noexcept -> result_type
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr auto operator()() noexcept -> result_type
+  {
+    const std::uint64_t result {rotl(m_state[1] * 5, 7) * 9};
+    const std::uint64_t shifted {m_state[1] << 17U};
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= shifted;
+    m_state[3] = rotl(m_state[3], 45);
+
+    return result;
+  }
+
+  /// Uniform integer in `[0, bound)`; `bound` must be nonzero
+  constexpr auto below(const std::uint32_t bound) noexcept -> std::uint32_t
+  {
+    // Lemire's multiply-shift on the high half; the bias is negligible
+    // for the small bounds this is used with
+    return static_cast<std::uint32_t>(((*this)() >> 32U) * bound >> 32U);
+  }
+
+  /// Uniform double in `[0, 1)`
+  constexpr auto uniform() noexcept -> double
+  {
+    return static_cast<double>((*this)() >> 11U) * 0x1.0p-53;
+  }
+};
+
+#endif
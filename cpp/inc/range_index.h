@@ -0,0 +1,97 @@
+#ifndef RANGE_INDEX_H
+#define RANGE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "span.h"
+#include "wrestler.h"
+
+/// Wrestlers weighing `[min_weight, max_weight]` and aged
+/// `[min_age, max_age]`
+struct Range_query {
+  int min_weight {};
+  int max_weight {};
+  int min_age {};
+  int max_age {};
+};
+
+/// Positions `[begin, end)` in index order
+struct Index_slice {
+  std::size_t begin {};
+  std::size_t end {};
+};
+
+/**
+ * @brief Static index answering weight and age range queries.
+ *
+ * Rows are kept sorted by weight, then age, so the weights asked for are
+ * one contiguous range found by binary search, and within each weight
+ * the ages asked for are contiguous too. Every block of `block_rows`
+ * rows carries the least and greatest age in it; a query takes blocks
+ * wholly inside its age range and skips blocks wholly outside it
+ * without reading them, scanning only blocks that straddle an age
+ * bound. Matches come back as maximal slices of index positions, which
+ * `rows` maps back to the original row numbers.
+ */
+class Range_index
+{
+public:
+
+  static constexpr std::size_t block_rows {64};
+
+private:
+
+  struct Age_zone {
+    std::int32_t min {};
+    std::int32_t max {};
+  };
+
+  std::vector<std::int32_t> m_weight {};
+  std::vector<std::int32_t> m_age {};
+  std::vector<std::uint32_t> m_row {};
+  std::vector<Age_zone> m_zones {};
+
+  void build(Span<const std::int32_t> weights,
+             Span<const std::int32_t> ages);
+
+public:
+
+  /// Throws `std::invalid_argument` if the columns differ in length
+  Range_index(Span<const std::int32_t> weights,
+              Span<const std::int32_t> ages);
+
+  explicit Range_index(const std::vector<Wrestler>& roster);
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_row.size();
+  }
+
+  /// Replace the contents of `out` with the slices matching `query`
+  void query(const Range_query& query,
+             std::vector<Index_slice>& out) const;
+
+  [[nodiscard]] auto query(const Range_query& query) const
+      -> std::vector<Index_slice>;
+
+  /// Original row numbers of the wrestlers in `slice`
+  [[nodiscard]] auto rows(const Index_slice& slice) const noexcept
+      -> Span<const std::uint32_t>
+  {
+    return {m_row.data() + slice.begin, slice.end - slice.begin};
+  }
+
+  /// Matches of `query` as a bitmap over the original rows, bit
+  /// `row % 64` of word `row / 64`
+  [[nodiscard]] auto bitmap(const Range_query& query) const
+      -> std::vector<std::uint64_t>;
+};
+
+/// Number of rows in `slices`
+[[nodiscard]] auto
+slice_rows(const std::vector<Index_slice>& slices) noexcept
+    -> std::size_t;
+
+#endif
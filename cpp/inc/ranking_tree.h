@@ -0,0 +1,165 @@
+#ifndef RANKING_TREE_H
+#define RANKING_TREE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "weight_class.h"
+#include "wrestler.h"
+
+/// A wrestler's place in a ranking
+struct Ranked {
+  int ability {};
+  int id {};
+};
+
+/// Higher ability ranks first, then lower id
+[[nodiscard]] constexpr auto ranks_before(const Ranked& lhs,
+                                          const Ranked& rhs) noexcept
+    -> bool
+{
+  return lhs.ability != rhs.ability ? lhs.ability > rhs.ability
+                                    : lhs.id < rhs.id;
+}
+
+/**
+ * @brief Order-statistic B+ tree of `Ranked` entries, best first.
+ *
+ * Internal nodes keep the size of every subtree beside its first entry,
+ * so inserting, erasing, finding an entry's position and selecting the
+ * entry at a position all take O(log n). Leaves are linked in order, so
+ * reading k entries from any position costs O(log n + k). Nodes live in
+ * one pool and are reused after erasure.
+ */
+class Ranking_tree
+{
+public:
+
+  static constexpr std::size_t node_capacity {32};
+
+private:
+
+  static constexpr std::uint32_t none {~std::uint32_t {0}};
+  static constexpr std::size_t min_fill {node_capacity / 2};
+
+  /// A leaf holds entries; an internal node holds, per child, its first
+  /// entry, its index and how many entries are under it. One spare slot
+  /// lets a node overflow before it splits.
+  struct Node {
+    std::uint32_t size {0};
+    bool leaf {true};
+    std::uint32_t next {none};
+    std::array<Ranked, node_capacity + 1> keys {};
+    std::array<std::uint32_t, node_capacity + 1> children {};
+    std::array<std::uint32_t, node_capacity + 1> counts {};
+  };
+
+  std::vector<Node> m_nodes {};
+  std::vector<std::uint32_t> m_free {};
+  std::uint32_t m_root {none};
+  std::size_t m_size {0};
+
+  [[nodiscard]] auto allocate(bool leaf) -> std::uint32_t;
+  void release(std::uint32_t node);
+
+  [[nodiscard]] auto entries(std::uint32_t node) const noexcept
+      -> std::uint32_t;
+  /// Child of internal `node` whose range holds `key`
+  [[nodiscard]] auto child_for(std::uint32_t node,
+                               const Ranked& key) const noexcept
+      -> std::size_t;
+
+  /// Returns the new right sibling if `node` split, else `none`
+  [[nodiscard]] auto insert_into(std::uint32_t node, const Ranked& key,
+                                 bool& inserted) -> std::uint32_t;
+  [[nodiscard]] auto erase_from(std::uint32_t node, const Ranked& key)
+      -> bool;
+  /// Refill child `child` of `node` from, or merge it with, a sibling
+  void rebalance(std::uint32_t node, std::size_t child);
+
+public:
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_size;
+  }
+
+  /// False if `key` was already present
+  auto insert(const Ranked& key) -> bool;
+
+  /// False if `key` was absent
+  auto erase(const Ranked& key) -> bool;
+
+  [[nodiscard]] auto contains(const Ranked& key) const noexcept -> bool;
+
+  /// Entries ranking before `key`, whether or not it is present
+  [[nodiscard]] auto position(const Ranked& key) const noexcept
+      -> std::size_t;
+
+  /// Entry at `position`, which must be less than `size()`
+  [[nodiscard]] auto select(std::size_t position) const noexcept
+      -> Ranked;
+
+  /// Replace the contents of `out` with up to `count` entries from
+  /// `first` on
+  void read(std::size_t first, std::size_t count,
+            std::vector<Ranked>& out) const;
+};
+
+/**
+ * @brief Live per-class rankings of wrestlers, best first.
+ *
+ * Each weight class has its own `Ranking_tree`, and a wrestler's class
+ * and current ability are looked up by id, so a rating change is an
+ * erase and an insert rather than a re-sort. Ranks are 1-based.
+ * Unknown ids and classes throw `std::out_of_range`; adding an id twice
+ * throws `std::invalid_argument`.
+ */
+class Class_rankings
+{
+private:
+
+  struct Entry {
+    std::size_t weight_class {};
+    int ability {};
+  };
+
+  std::vector<Ranking_tree> m_trees;
+  std::unordered_map<int, Entry> m_entries {};
+
+  [[nodiscard]] auto entry(int id) const -> const Entry&;
+  [[nodiscard]] auto tree(std::size_t weight_class) const
+      -> const Ranking_tree&;
+
+public:
+
+  explicit Class_rankings(std::size_t classes);
+
+  explicit Class_rankings(const Weight_classes& classes)
+      : Class_rankings {classes.size()}
+  {}
+
+  void add(const Wrestler& wrestler, std::size_t weight_class);
+
+  void remove(int id);
+
+  /// Move wrestler `id` to `ability`
+  void update(int id, int ability);
+
+  [[nodiscard]] auto size(std::size_t weight_class) const -> std::size_t;
+
+  [[nodiscard]] auto rank(int id) const -> std::size_t;
+
+  /// Wrestler ranked `rank` in `weight_class`
+  [[nodiscard]] auto at(std::size_t weight_class, std::size_t rank) const
+      -> Ranked;
+
+  /// The best `count` wrestlers in `weight_class`
+  [[nodiscard]] auto top(std::size_t weight_class, std::size_t count) const
+      -> std::vector<Ranked>;
+};
+
+#endif
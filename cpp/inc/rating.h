@@ -0,0 +1,138 @@
+#ifndef RATING_H
+#define RATING_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "bout.h"
+#include "slot_map.h"
+#include "wrestler.h"
+
+struct Elo_params {
+  double initial {1500.0};
+  double k_factor {32.0};
+};
+
+/**
+ * @brief Sequential Elo ratings, one `double` per roster slot.
+ *
+ * Each bout is O(1): two array reads, two array writes.
+ */
+class Elo_engine
+{
+private:
+
+  Elo_params m_params;
+  std::vector<double> m_rating;
+
+public:
+
+  explicit Elo_engine(std::size_t slots, Elo_params params = {});
+
+  /// Apply one bout between two slots
+  void update(std::size_t winner, std::size_t loser) noexcept;
+
+  /// Stream a chronological bout log; bouts naming unknown ids are skipped
+  void process(const Bout* first, const Bout* last, const Slot_map& slots);
+
+  void process(const std::vector<Bout>& bouts, const Slot_map& slots)
+  {
+    process(bouts.data(), bouts.data() + bouts.size(), slots);
+  }
+
+  [[nodiscard]] auto rating(const std::size_t slot) const noexcept
+      -> double
+  {
+    return m_rating[slot];
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_rating.size();
+  }
+};
+
+struct Glicko2_params {
+  double initial_rating {1500.0};
+  double initial_deviation {350.0};
+  double initial_volatility {0.06};
+  /// System constant constraining volatility change
+  double tau {0.5};
+};
+
+/**
+ * @brief Glicko-2 ratings, updated bout by bout.
+ *
+ * Every bout is treated as its own rating period, which keeps the update
+ * O(1) and lets a whole history be streamed in a single pass.
+ */
+class Glicko2_engine
+{
+public:
+
+  /// Per-slot state on the internal Glicko-2 scale
+  struct State {
+    double mu;
+    double phi;
+    double sigma;
+  };
+
+private:
+
+  Glicko2_params m_params;
+  std::vector<State> m_state;
+
+public:
+
+  explicit Glicko2_engine(std::size_t slots, Glicko2_params params = {});
+
+  void update(std::size_t winner, std::size_t loser) noexcept;
+
+  void process(const Bout* first, const Bout* last, const Slot_map& slots);
+
+  void process(const std::vector<Bout>& bouts, const Slot_map& slots)
+  {
+    process(bouts.data(), bouts.data() + bouts.size(), slots);
+  }
+
+  [[nodiscard]] auto rating(std::size_t slot) const noexcept -> double;
+
+  [[nodiscard]] auto deviation(std::size_t slot) const noexcept -> double;
+
+  [[nodiscard]] auto volatility(const std::size_t slot) const noexcept
+      -> double
+  {
+    return m_state[slot].sigma;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_state.size();
+  }
+};
+
+/// Expected score of a player rated `rating` against `opponent` (Elo)
+[[nodiscard]] inline auto expected_score(const double rating,
+                                         const double opponent) noexcept
+    -> double
+{
+  return 1.0 / (1.0 + std::pow(10.0, (opponent - rating) / 400.0));
+}
+
+/**
+ * @brief Write engine ratings back as abilities.
+ *
+ * `roster` must be the roster the engine's slots were taken from.
+ */
+template <typename Engine>
+void apply_ratings(std::vector<Wrestler>& roster, const Engine& engine)
+{
+  for ( std::size_t slot {0};
+        slot != roster.size() && slot != engine.size(); ++slot ) {
+    roster[slot].set_ability(
+        static_cast<int>(std::lround(engine.rating(slot))));
+  }
+}
+
+#endif
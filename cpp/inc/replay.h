@@ -0,0 +1,166 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bout_log.h"
+#include "probability_table.h"
+#include "span.h"
+#include "wrestler.h"
+
+/// How a replayed bracket is scored and placed
+struct Replay_rules {
+  std::size_t places {8};
+  /// Regulation length of a bout
+  int match_seconds {360};
+  /// Winning margins that make a major decision and a technical fall
+  int major_margin {8};
+  int tech_fall_margin {15};
+};
+
+/// Fingerprint of every wrestler's id, age, weight and ability, in order
+[[nodiscard]] auto
+roster_hash(const std::vector<Wrestler>& roster) noexcept -> std::uint64_t;
+
+[[nodiscard]] auto rules_hash(const Replay_rules& rules) noexcept
+    -> std::uint64_t;
+
+/// Everything needed to regenerate one simulated tournament
+struct Replay_key {
+  std::uint64_t roster {};
+  std::uint64_t rules {};
+  std::uint64_t seed {};
+  std::uint64_t replay {};
+  /// `Divergence_log::hash` of the injections into this replay; zero
+  /// for none
+  std::uint64_t log {};
+};
+
+/**
+ * @brief A result imposed from outside the simulation, such as a
+ * forfeit or injury default.
+ */
+struct Injected_result {
+  std::uint64_t seed {};
+  std::uint64_t replay {};
+  /// Bout number within the replay
+  std::uint32_t slot {};
+  /// Wrestler id
+  int winner {};
+  Result_type result {Result_type::forfeit};
+};
+
+/**
+ * @brief The only events a replay cannot regenerate from its seed.
+ *
+ * Kept sorted by (seed, replay, slot); a later injection into the same
+ * bout replaces the earlier one.
+ */
+class Divergence_log
+{
+private:
+
+  std::vector<Injected_result> m_events {};
+
+public:
+
+  void inject(const Injected_result& event);
+
+  /// Injections into `replay` of `seed`, in bout order
+  [[nodiscard]] auto of(std::uint64_t seed, std::uint64_t replay) const
+      noexcept -> Span<const Injected_result>;
+
+  /// Fingerprint of the injections into `replay` of `seed`; zero when
+  /// there are none
+  [[nodiscard]] auto hash(std::uint64_t seed, std::uint64_t replay) const
+      noexcept -> std::uint64_t;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_events.size();
+  }
+};
+
+struct Replay {
+  Replay_key key {};
+  /// Every bout in the order played, `tournament` being the replay index
+  std::vector<Bout_event> bouts {};
+  /// Indices into the field, in finishing order
+  std::vector<std::size_t> placings {};
+};
+
+/**
+ * @brief Regenerates any replay of one bracket from its key alone.
+ *
+ * The field is seeded by ability and played like `simulate_bracket`.
+ * Each replay draws its bout winners from one stream and their scores
+ * and durations from another, so asking only for placings skips the
+ * second stream without changing any result. Injected results override
+ * the bouts they name without shifting either stream, so only the
+ * bracket downstream of them changes. A full replay throws
+ * `std::runtime_error` if an injection names a bout it never plays.
+ */
+class Replay_engine
+{
+private:
+
+  std::vector<int> m_ids;
+  Probability_table m_table;
+  std::vector<std::size_t> m_lines;
+  std::vector<std::size_t> m_by_seed;
+  Replay_rules m_rules;
+  std::uint64_t m_roster_hash;
+  std::uint64_t m_rules_hash;
+  const Divergence_log* m_log;
+
+  [[nodiscard]] auto play(std::uint64_t seed, std::uint64_t replay,
+                          std::vector<Bout_event>* bouts) const
+      -> std::vector<std::size_t>;
+
+public:
+
+  static constexpr std::uint64_t not_found {~std::uint64_t {0}};
+
+  /// `log`, if given, must outlive the engine
+  explicit Replay_engine(const std::vector<Wrestler>& field,
+                         const Replay_rules& rules = {},
+                         const Divergence_log* log = nullptr);
+
+  Replay_engine(const Replay_engine&)                        = default;
+  Replay_engine(Replay_engine&&) noexcept                    = default;
+  auto operator=(const Replay_engine&) -> Replay_engine&     = default;
+  auto operator=(Replay_engine&&) noexcept -> Replay_engine& = default;
+  ~Replay_engine()                                           = default;
+
+  [[nodiscard]] auto key(std::uint64_t seed, std::uint64_t replay) const
+      noexcept -> Replay_key;
+
+  /// Throws `std::invalid_argument` if `key` was made from another
+  /// field, other rules or other injected results
+  [[nodiscard]] auto replay(const Replay_key& key) const -> Replay;
+
+  [[nodiscard]] auto replay(std::uint64_t seed, std::uint64_t replay) const
+      -> Replay;
+
+  /// Field index of the wrestler seeded `seed` (1-based)
+  [[nodiscard]] auto seeded(const std::size_t seed) const noexcept
+      -> std::size_t
+  {
+    return m_by_seed[seed - 1];
+  }
+
+  /**
+   * First replay in `[first, first + count)` whose champion is field
+   * index `champion`, or `not_found`. Only the placings are computed,
+   * so scanning is cheap.
+   */
+  [[nodiscard]] auto find_champion(std::uint64_t seed,
+                                   std::size_t champion,
+                                   std::uint64_t first,
+                                   std::uint64_t count) const
+      -> std::uint64_t;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef RESULT_TABLES_H
+#define RESULT_TABLES_H
+
+#include <string>
+#include <vector>
+
+#include "arrow_stream.h"
+#include "league.h"
+#include "qualifier.h"
+#include "wrestler.h"
+
+/**
+ * @brief One row per team: `team`, `wrestlers`, `title_probability`,
+ * `mean_place` and `mean_wins`.
+ *
+ * Throws `std::invalid_argument` if `summary` covers another number of
+ * teams.
+ */
+[[nodiscard]] auto league_table(const std::vector<League_team>& teams,
+                                const League_summary& summary)
+    -> Arrow_table;
+
+/**
+ * @brief One row per roster slot: `team`, `id`, `age`, `weight`,
+ * `ability`, `reach_region`, `reach_state` and `placed`.
+ *
+ * `team_of` names each slot's team. Throws `std::invalid_argument` if
+ * it or `odds` covers another number of wrestlers.
+ */
+[[nodiscard]] auto
+qualifier_table(const std::vector<Wrestler>& roster,
+                const std::vector<std::string>& team_of,
+                const Qualifier_odds& odds) -> Arrow_table;
+
+#endif
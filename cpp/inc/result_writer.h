@@ -0,0 +1,136 @@
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "bout.h"
+#include "mpsc_ring.h"
+
+/// One simulated bout, tagged with the replay that produced it
+struct Result_record {
+  std::uint64_t replay {};
+  Bout bout {};
+};
+
+/**
+ * @brief Fixed little-endian layout of a `Result_record`.
+ *
+ * replay (8), winner, loser, date, tournament (4 each), winner and loser
+ * score (2 each), result (1), then zero padding.
+ */
+constexpr inline std::size_t result_record_bytes {32};
+
+void encode_result(const Result_record& record,
+                   unsigned char* out) noexcept;
+
+[[nodiscard]] auto decode_result(const unsigned char* in) noexcept
+    -> Result_record;
+
+/// Receives every batch in order; throwing stops the writer
+using Byte_sink = std::function<void(const unsigned char*, std::size_t)>;
+
+/// Writes everything it is given to a file descriptor, retrying short
+/// writes; throws `std::runtime_error` on failure
+[[nodiscard]] auto descriptor_sink(int descriptor) -> Byte_sink;
+
+struct Result_writer_params {
+  /// Records the ring holds before producers feel backpressure
+  std::size_t capacity {std::size_t {1} << 16};
+  /// Bytes gathered before a write is issued
+  std::size_t batch_bytes {std::size_t {1} << 20};
+};
+
+struct Result_writer_stats {
+  /// Records accepted into the ring
+  std::uint64_t submitted {};
+  /// `try_submit` calls refused because the ring was full
+  std::uint64_t rejected {};
+  /// `submit` calls that had to wait for room
+  std::uint64_t stalls {};
+  /// Records handed to the sink
+  std::uint64_t written {};
+  /// Calls to the sink
+  std::uint64_t writes {};
+};
+
+/**
+ * @brief Funnels result records from many threads into one sequential
+ * stream.
+ *
+ * Producers push fixed-size records into a lock-free ring; a dedicated
+ * writer thread drains it, encodes the records into a batch buffer and
+ * hands the sink one large write at a time. A partial batch is flushed
+ * once the ring stays empty.
+ *
+ * Nothing is dropped: a full ring makes `try_submit` return false and
+ * `submit` wait, and both count it. If the sink fails, every later
+ * submit throws and `close` rethrows the sink's error, so the records
+ * that never reached it are visible as `submitted - written`.
+ */
+class Result_writer
+{
+private:
+
+  Mpsc_ring<Result_record> m_ring;
+  Byte_sink m_sink;
+  std::vector<unsigned char> m_batch;
+  std::size_t m_batch_used {0};
+
+  std::atomic<std::uint64_t> m_rejected {0};
+  std::atomic<std::uint64_t> m_stalls {0};
+  std::atomic<std::uint64_t> m_written {0};
+  std::atomic<std::uint64_t> m_writes {0};
+
+  std::atomic<bool> m_closing {false};
+  std::atomic<bool> m_failed {false};
+  /// A submit has thrown because of the failure
+  mutable std::atomic<bool> m_reported {false};
+  std::exception_ptr m_failure {};
+  std::thread m_thread {};
+
+  void append(const Result_record& record);
+
+  void drain();
+
+  void flush();
+
+  /// Throws if the writer can no longer accept records
+  void check_open() const;
+
+public:
+
+  Result_writer(Byte_sink sink, const Result_writer_params& params = {});
+
+  Result_writer(const Result_writer&) = delete;
+  auto operator=(const Result_writer&) -> Result_writer& = delete;
+  Result_writer(Result_writer&&)                         = delete;
+  auto operator=(Result_writer&&) -> Result_writer&      = delete;
+
+  /// Closes the writer; a sink failure reported by neither `close` nor
+  /// a throwing submit ends the program rather than losing records
+  /// quietly
+  ~Result_writer();
+
+  /// False, without blocking, if the ring is full
+  [[nodiscard]] auto try_submit(const Result_record& record) -> bool;
+
+  /// Waits for room if the ring is full
+  void submit(const Result_record& record);
+
+  /**
+   * Write out everything submitted so far and stop the writer thread.
+   * Every producer must have finished submitting. Rethrows a sink
+   * failure; later calls do nothing.
+   */
+  void close();
+
+  [[nodiscard]] auto stats() const noexcept -> Result_writer_stats;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef ROSTER_FILE_H
+#define ROSTER_FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+#include "span.h"
+#include "text_format.h"
+#include "wrestler.h"
+
+/// One wrestler as stored in a roster file
+struct Roster_record {
+  std::int32_t id {};
+  std::int32_t team {};
+  std::int32_t age {};
+  std::int32_t weight {};
+  std::int32_t ability {};
+
+  [[nodiscard]] auto wrestler() const -> Wrestler
+  {
+    return {id, age, weight, ability};
+  }
+};
+
+/**
+ * @brief Layout of a binary roster: a header, then fixed-size records,
+ * all little-endian; only little-endian hosts can build it.
+ *
+ * The record count follows from the file size, so a roster can be
+ * written in one pass without knowing its length.
+ */
+struct Roster_file_format {
+  static constexpr std::array<char, 8> magic {'W', 'R', 'R', 'O',
+                                              'S', 'T', 'E', 'R'};
+
+  struct Header {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t record_bytes;
+  };
+
+  static constexpr std::uint32_t version {1};
+};
+
+enum class Roster_encoding : unsigned char {
+  binary,
+  csv
+};
+
+/// First line of a CSV roster
+constexpr std::string_view roster_csv_header {
+    "id,team,age,weight,ability\n"};
+
+/// Append `records` to `out`, as binary records or CSV lines
+void encode_roster(Span<const Roster_record> records,
+                   Roster_encoding encoding, Text_buffer& out);
+
+/**
+ * @brief Read-only view of a binary roster file.
+ *
+ * Throws `std::runtime_error` if the file is not a roster.
+ */
+class Roster_file
+{
+private:
+
+  Mapped_file m_file;
+  std::size_t m_size {0};
+
+public:
+
+  explicit Roster_file(const std::string& path);
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_size;
+  }
+
+  [[nodiscard]] auto operator[](std::size_t index) const noexcept
+      -> Roster_record;
+
+  /// Records `[first, first + count)`, clamped to the end of the file
+  void read(std::size_t first, std::size_t count,
+            std::vector<Roster_record>& out) const;
+};
+
+/**
+ * @brief Shape of a synthetic roster.
+ *
+ * Ages are uniform. Weight is log-normal above `weight_floor`, its
+ * median rising with age, then clamped to `max_weight`. Ability is
+ * normal around `ability_mean`, raised by age and by the strength of
+ * the wrestler's team, which is itself normal with spread `team_spread`.
+ */
+struct Roster_params {
+  std::size_t teams {1000};
+  std::uint64_t seed {0};
+  /// Zero means one per hardware thread
+  std::size_t threads {0};
+  int min_age {14};
+  int max_age {18};
+  int weight_floor {100};
+  int max_weight {285};
+  /// Median pounds above `weight_floor` at `min_age`, and per year older
+  double weight_median {25.0};
+  double weight_per_year {5.0};
+  /// Standard deviation of the log of the weight above the floor
+  double weight_sigma {0.6};
+  double ability_mean {1500.0};
+  double ability_sd {150.0};
+  double ability_per_year {40.0};
+  double team_spread {100.0};
+};
+
+/**
+ * @brief Reproducible synthetic rosters of any size.
+ *
+ * Wrestler `n` has id `n` and is drawn from its own random stream, so
+ * any slice of a roster can be generated alone, and a roster is the
+ * same however many threads build it. Invalid parameters throw
+ * `std::invalid_argument`.
+ */
+class Roster_generator
+{
+private:
+
+  Roster_params m_params;
+  std::vector<double> m_team_strength {};
+
+public:
+
+  explicit Roster_generator(const Roster_params& params);
+
+  /// Wrestlers `[first, first + count)`, replacing the contents of `out`
+  void generate(std::size_t first, std::size_t count,
+                std::vector<Roster_record>& out) const;
+
+  /// Write `wrestlers` wrestlers to `path` in parallel; more than the
+  /// 31-bit ids allow throws before `path` is touched
+  void write(const std::string& path, std::size_t wrestlers,
+             Roster_encoding encoding) const;
+};
+
+#endif
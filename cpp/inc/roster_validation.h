@@ -0,0 +1,122 @@
+#ifndef ROSTER_VALIDATION_H
+#define ROSTER_VALIDATION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "roster_file.h"
+#include "span.h"
+#include "weight_class.h"
+
+/// Ranges every wrestler in a valid roster keeps to, inclusive
+struct Roster_limits {
+  int min_age {5};
+  int max_age {25};
+  int min_weight {50};
+  int max_weight {400};
+  int min_ability {0};
+  int max_ability {4000};
+  /// As for `Weight_classes::eligible`
+  int allowance {0};
+  std::size_t classes_up {1};
+};
+
+/// A roster stored column by column, the way the validator reads it
+struct Roster_columns {
+  std::vector<std::int32_t> id {};
+  std::vector<std::int32_t> age {};
+  std::vector<std::int32_t> weight {};
+  std::vector<std::int32_t> ability {};
+  /// Declared weight class of each wrestler; left empty, classes are
+  /// not checked
+  std::vector<std::uint8_t> weight_class {};
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return id.size();
+  }
+};
+
+/// Split records into columns, without declared classes
+[[nodiscard]] auto to_columns(Span<const Roster_record> records)
+    -> Roster_columns;
+
+enum class Violation : unsigned char {
+  age,
+  weight,
+  ability,
+  weight_class,
+  duplicate_id
+};
+
+constexpr std::size_t violation_kinds {5};
+
+/**
+ * @brief Which rows of a roster break which rule, one bitmap per rule.
+ *
+ * Bit `row % 64` of word `row / 64` is set when the row breaks the rule.
+ * Every row sharing an id is marked as a duplicate.
+ */
+class Roster_violations
+{
+private:
+
+  std::size_t m_rows;
+  std::array<std::vector<std::uint64_t>, violation_kinds> m_bitmaps;
+
+public:
+
+  explicit Roster_violations(std::size_t rows);
+
+  [[nodiscard]] auto rows() const noexcept -> std::size_t
+  {
+    return m_rows;
+  }
+
+  [[nodiscard]] auto bitmap(const Violation kind) noexcept
+      -> std::vector<std::uint64_t>&
+  {
+    return m_bitmaps[static_cast<std::size_t>(kind)];
+  }
+
+  [[nodiscard]] auto bitmap(const Violation kind) const noexcept
+      -> const std::vector<std::uint64_t>&
+  {
+    return m_bitmaps[static_cast<std::size_t>(kind)];
+  }
+
+  [[nodiscard]] auto has(const std::size_t row,
+                         const Violation kind) const noexcept -> bool
+  {
+    return (bitmap(kind)[row / 64] >> (row % 64) & 1U) != 0;
+  }
+
+  /// Rows breaking `kind`
+  [[nodiscard]] auto count(Violation kind) const noexcept -> std::size_t;
+
+  /// Rows breaking any rule, in order
+  [[nodiscard]] auto violating_rows() const -> std::vector<std::size_t>;
+};
+
+/**
+ * @brief Check every row's age, weight, ability and declared class, and
+ * that no two rows share an id.
+ *
+ * Range checks run over the columns 64 rows at a time with SIMD
+ * compares, each block producing one bitmap word, and blocks are split
+ * across `threads` (zero meaning one per hardware thread). Dense ids are
+ * checked for duplicates against a bitmap of their range; sparse ones
+ * are radix partitioned on a hash into cache-sized partitions, each
+ * then probed through a small hash table.
+ *
+ * Throws `std::invalid_argument` if the columns differ in length.
+ */
+[[nodiscard]] auto validate_roster(const Roster_columns& roster,
+                                   const Weight_classes& classes,
+                                   const Roster_limits& limits = {},
+                                   std::size_t threads = 0)
+    -> Roster_violations;
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef SEEDING_H
+#define SEEDING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bout.h"
+#include "wrestler.h"
+
+enum class Seed_criterion : std::uint8_t {
+  /// Topological order of the head-to-head graph; cycles tie
+  head_to_head,
+  /// Results against shared opponents, scored round-robin style
+  common_opponents,
+  /// External rating supplied through `set_ratings`
+  rating,
+  /// `Wrestler::ability()`
+  ability
+};
+
+/**
+ * @brief Orders every weight class by a chain of tie-breaking criteria.
+ *
+ * Each criterion only reorders wrestlers the previous criteria left tied;
+ * anything still tied at the end is ordered by id. Circular head-to-head
+ * results are found as strongly connected components and left tied for
+ * the next criterion.
+ *
+ * Seeds are recomputed lazily, and only for classes touched by a result
+ * since they were last computed.
+ */
+class Seeding_engine
+{
+public:
+
+  static constexpr std::size_t unassigned {~std::size_t {0}};
+
+private:
+
+  struct Opponent_record {
+    int id;
+    int wins;
+    int losses;
+  };
+
+  const std::vector<Wrestler>* m_roster;
+  std::vector<Seed_criterion> m_criteria;
+  std::vector<std::size_t> m_class_of;
+  std::vector<std::vector<std::size_t>> m_members;
+  std::vector<std::vector<std::size_t>> m_seeds;
+  std::vector<bool> m_dirty;
+  std::vector<double> m_rating {};
+  std::vector<std::vector<Opponent_record>> m_opponents;
+  std::vector<int> m_slot_of_id {};
+
+  [[nodiscard]] auto slot_of(int id) const noexcept -> std::size_t;
+
+  void mark_dirty(std::size_t slot) noexcept;
+
+  void reseed(std::size_t weight_class);
+
+  void order_group(Seed_criterion criterion,
+                   std::vector<std::size_t>& group,
+                   std::vector<std::size_t>& boundaries) const;
+
+  [[nodiscard]] auto head_to_head_levels(
+      const std::vector<std::size_t>& group) const -> std::vector<double>;
+
+  [[nodiscard]] auto common_opponent_scores(
+      const std::vector<std::size_t>& group) const -> std::vector<double>;
+
+  /// Positions within `group`, ordered by wrestler id
+  [[nodiscard]] auto group_positions(const std::vector<std::size_t>& group)
+      const -> std::vector<std::size_t>;
+
+  [[nodiscard]] auto position_of(const std::vector<std::size_t>& group,
+                                 const std::vector<std::size_t>& position,
+                                 int id) const noexcept -> std::size_t;
+
+public:
+
+  /**
+   * `class_of[slot]` is the weight class index of each roster slot, or
+   * `unassigned`. The roster must outlive the engine.
+   */
+  Seeding_engine(const std::vector<Wrestler>& roster,
+                 std::vector<std::size_t> class_of,
+                 std::vector<Seed_criterion> criteria);
+
+  Seeding_engine(const Seeding_engine&)                        = default;
+  Seeding_engine(Seeding_engine&&) noexcept                    = default;
+  auto operator=(const Seeding_engine&) -> Seeding_engine&     = default;
+  auto operator=(Seeding_engine&&) noexcept -> Seeding_engine& = default;
+  ~Seeding_engine()                                            = default;
+
+  /// Per-slot ratings for `Seed_criterion::rating`
+  void set_ratings(std::vector<double> ratings);
+
+  /// Record a result; only the two wrestlers' classes need reseeding
+  void add_result(const Bout& bout);
+
+  /// Recompute every class whose inputs changed outside the engine
+  void invalidate() noexcept;
+
+  [[nodiscard]] auto class_count() const noexcept -> std::size_t
+  {
+    return m_members.size();
+  }
+
+  /// Roster slots of `weight_class`, first seed first
+  [[nodiscard]] auto seeds(std::size_t weight_class)
+      -> const std::vector<std::size_t>&;
+
+  /// Bring every class up to date
+  void reseed_all();
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef SEEDING_OPTIMIZER_H
+#define SEEDING_OPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "probability_table.h"
+
+/**
+ * @brief Exact single-elimination probabilities for one draw.
+ *
+ * `reach(r, line)` is the chance the entrant on `line` wins its first
+ * `r` bouts. The fairness objective sums, over every round, the squared
+ * gap between those chances and the chalk outcome in which the strongest
+ * entrants (by expected wins against the field) always advance.
+ *
+ * `swap` only recomputes the blocks that contain the two lines, and
+ * `undo` restores the previous state without recomputing anything.
+ */
+class Bracket_evaluator
+{
+private:
+
+  /// The table padded with an all-zero row and column for byes
+  std::size_t m_stride;
+  std::vector<double> m_probability;
+  std::vector<std::size_t> m_lines;
+  /// Column of each line's entrant in `m_probability`
+  std::vector<std::size_t> m_column;
+  std::size_t m_rounds;
+  std::vector<std::size_t> m_rank;
+  std::size_t m_entrants;
+  std::vector<double> m_reach;
+  double m_objective {0.0};
+
+  std::vector<std::pair<std::size_t, double>> m_undo_cells {};
+  std::size_t m_undo_lhs {0};
+  std::size_t m_undo_rhs {0};
+  double m_undo_objective {0.0};
+
+  [[nodiscard]] auto cell(const std::size_t round,
+                          const std::size_t line) const noexcept
+      -> std::size_t
+  {
+    return round * m_lines.size() + line;
+  }
+
+  [[nodiscard]] auto compute(std::size_t round, std::size_t line) const
+      noexcept -> double;
+
+  [[nodiscard]] auto contribution(std::size_t round, std::size_t line,
+                                  double reach) const noexcept -> double;
+
+  void refresh_block(std::size_t round, std::size_t block);
+
+public:
+
+  /**
+   * `lines` maps every line to an entrant (an index into `table`) or to
+   * `bye_line`; its size must be a power of two.
+   */
+  Bracket_evaluator(const Probability_table& table,
+                    std::vector<std::size_t> lines);
+
+  /// Recompute everything from scratch
+  void evaluate();
+
+  /// Swap the entrants on two lines and update incrementally
+  void swap(std::size_t lhs, std::size_t rhs);
+
+  /// Revert the most recent `swap`; only one level is kept
+  void undo();
+
+  [[nodiscard]] auto objective() const noexcept -> double
+  {
+    return m_objective;
+  }
+
+  [[nodiscard]] auto reach(const std::size_t round,
+                           const std::size_t line) const noexcept -> double
+  {
+    return m_reach[cell(round, line)];
+  }
+
+  [[nodiscard]] auto rounds() const noexcept -> std::size_t
+  {
+    return m_rounds;
+  }
+
+  [[nodiscard]] auto lines() const noexcept
+      -> const std::vector<std::size_t>&
+  {
+    return m_lines;
+  }
+};
+
+struct Tempering_params {
+  /// Replicas at geometrically spaced temperatures
+  std::size_t replicas {8};
+  double min_temperature {1e-4};
+  double max_temperature {0.05};
+  /// Replica exchanges are attempted after every sweep
+  std::size_t sweeps {200};
+  std::size_t steps_per_sweep {64};
+  std::uint64_t seed {0};
+  /// Zero means one per hardware thread
+  std::size_t threads {0};
+};
+
+struct Seeding_result {
+  std::vector<std::size_t> lines {};
+  double objective {};
+  double initial_objective {};
+  std::size_t evaluations {};
+};
+
+/**
+ * @brief Search draws for the fairest one by parallel tempering.
+ *
+ * Moves swap the entrants on two lines that are neither pinned nor byes.
+ * Replicas sweep concurrently, then neighbouring temperatures exchange
+ * states. Each replica draws from its own stream, so the result depends
+ * only on `params.seed`.
+ */
+[[nodiscard]] auto optimize_seeding(const Probability_table& table,
+                                    std::vector<std::size_t> lines,
+                                    const std::vector<bool>& pinned,
+                                    const Tempering_params& params = {})
+    -> Seeding_result;
+
+#endif
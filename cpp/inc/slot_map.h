@@ -0,0 +1,60 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <vector>
+
+#include "wrestler.h"
+
+/**
+ * @brief Maps `Wrestler::id()` to the wrestler's slot in a roster.
+ *
+ * Lookups are a single array index, so ids should be reasonably dense.
+ */
+class Slot_map
+{
+private:
+
+  std::vector<int> m_slot_of {};
+
+public:
+
+  static constexpr int npos = -1;
+
+  Slot_map() = default;
+
+  explicit Slot_map(const std::vector<Wrestler>& roster)
+  {
+    int max_id {-1};
+    for ( const auto& wrestler : roster ) {
+      if ( wrestler.id() > max_id ) {
+        max_id = wrestler.id();
+      }
+    }
+
+    m_slot_of.assign(static_cast<std::size_t>(max_id + 1), npos);
+
+    for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+      if ( roster[slot].id() >= 0 ) {
+        m_slot_of[static_cast<std::size_t>(roster[slot].id())] =
+            static_cast<int>(slot);
+      }
+    }
+  }
+
+  /// Slot of wrestler `id`, or `npos` if it is not on the roster
+  [[nodiscard]] auto slot(const int id) const noexcept -> int
+  {
+    if ( id < 0 || static_cast<std::size_t>(id) >= m_slot_of.size() ) {
+      return npos;
+    }
+    return m_slot_of[static_cast<std::size_t>(id)];
+  }
+
+  [[nodiscard]] auto id_bound() const noexcept -> std::size_t
+  {
+    return m_slot_of.size();
+  }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+
+/**
+ * @brief Non-owning view of a contiguous array.
+ *
+ * Stand-in for `std::span` until the project moves past C++17.
+ */
+template <typename T>
+class Span
+{
+private:
+
+  T* m_data {nullptr};
+  std::size_t m_size {0};
+
+public:
+
+  constexpr Span() noexcept = default;
+
+  constexpr Span(T* data, const std::size_t size) noexcept
+      : m_data {data}
+      , m_size {size}
+  {}
+
+  [[nodiscard]] constexpr auto data() const noexcept -> T*
+  {
+    return m_data;
+  }
+
+  [[nodiscard]] constexpr auto size() const noexcept -> std::size_t
+  {
+    return m_size;
+  }
+
+  [[nodiscard]] constexpr auto empty() const noexcept -> bool
+  {
+    return m_size == 0;
+  }
+
+  [[nodiscard]] constexpr auto begin() const noexcept -> T*
+  {
+    return m_data;
+  }
+
+  [[nodiscard]] constexpr auto end() const noexcept -> T*
+  {
+    return m_data + m_size;
+  }
+
+  [[nodiscard]] constexpr auto operator[](const std::size_t index) const
+      noexcept -> T&
+  {
+    return m_data[index];
+  }
+};
+
+#endif
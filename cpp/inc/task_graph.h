@@ -0,0 +1,64 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief A set of tasks and the order they must run in.
+ *
+ * Each task starts once every task it was added after has finished;
+ * tasks with no path between them may run concurrently. If a task
+ * throws, no further tasks start and `run` rethrows the first exception
+ * once the running ones finish.
+ *
+ * Every worker owns a lock-free deque of ready tasks and steals from the
+ * others when its own runs dry. A finishing task hands its first newly
+ * ready dependent straight to the same worker as a continuation, so a
+ * chain of stages runs on one thread without touching any queue.
+ * Workers that find nothing to do yield for a while, then sleep until
+ * a task is queued or the graph finishes.
+ */
+class Task_graph
+{
+public:
+
+  using Task_id = std::size_t;
+
+private:
+
+  struct Task {
+    std::function<void()> work;
+    std::vector<Task_id> dependents;
+    std::size_t dependencies;
+  };
+
+  std::vector<Task> m_tasks {};
+
+  void execute(std::size_t threads);
+
+public:
+
+  /// Add a task that runs after every task in `after`
+  auto add(std::function<void()> work,
+           const std::vector<Task_id>& after = {}) -> Task_id;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_tasks.size();
+  }
+
+  /// Run every task once and wait; zero threads means one per hardware
+  /// thread
+  void run(std::size_t threads = 0);
+
+  /**
+   * Run every task on the calling thread, in an order that depends only
+   * on how the graph was built. Meant for tests and for reproducing
+   * problems seen under `run`.
+   */
+  void run_deterministic();
+};
+
+#endif
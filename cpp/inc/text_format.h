@@ -0,0 +1,184 @@
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// `value` with `decimals` digits after the point, as `std::fixed` would
+struct Fixed {
+  double value {};
+  int decimals {2};
+};
+
+enum class Align : unsigned char {
+  left,
+  right
+};
+
+/// `value` padded with `fill` to at least `width` characters
+template <typename T>
+struct Padded {
+  T value;
+  std::size_t width;
+  char fill;
+  Align align;
+
+  Padded(T padded_value, const std::size_t padded_width,
+         const char padded_fill   = ' ',
+         const Align padded_align = Align::left)
+      : value {std::move(padded_value)}
+      , width {padded_width}
+      , fill {padded_fill}
+      , align {padded_align}
+  {}
+};
+
+Padded(const char*, std::size_t, char = ' ', Align = Align::left)
+    -> Padded<std::string_view>;
+
+/// Owns its text, so it may outlive the string it was made from
+Padded(std::string, std::size_t, char = ' ', Align = Align::left)
+    -> Padded<std::string>;
+
+/**
+ * @brief Locale-free text output into a reusable buffer.
+ *
+ * Numbers go through `std::to_chars` straight into the buffer, so once
+ * it has reached its working size nothing is allocated. A buffer given a
+ * stream writes to it whenever it fills and when destroyed, which keeps
+ * large reports in a fixed amount of memory; otherwise it grows and
+ * `view()` holds everything written. Terminal colours such as
+ * `supl::FG_RED` are ordinary strings and pass straight through.
+ *
+ * A failed write to the stream throws `std::runtime_error`.
+ */
+class Text_buffer
+{
+private:
+
+  std::vector<char> m_data;
+  std::size_t m_size {0};
+  std::FILE* m_stream {nullptr};
+
+  /// Room for `bytes` more characters, flushing or growing to make it
+  [[nodiscard]] auto room(std::size_t bytes) -> char*;
+
+  /// Longest a formatted `Fixed` can be
+  [[nodiscard]] static constexpr auto fixed_chars(const int decimals)
+      -> std::size_t
+  {
+    return 312 + static_cast<std::size_t>(decimals);
+  }
+
+  template <typename T>
+  static constexpr bool is_number {std::is_integral_v<T>
+                                   && !std::is_same_v<T, bool>
+                                   && !std::is_same_v<T, char>};
+
+  template <typename T>
+  static auto format(char* first, char* const last, const T value)
+      -> char*
+  {
+    return std::to_chars(first, last, value).ptr;
+  }
+
+  static auto format(char* first, char* last, Fixed value) -> char*;
+
+public:
+
+  static constexpr std::size_t default_capacity {std::size_t {1} << 16};
+
+  explicit Text_buffer(std::size_t capacity = default_capacity);
+
+  /// Flush to `stream` whenever `capacity` characters are waiting
+  explicit Text_buffer(std::FILE* stream,
+                       std::size_t capacity = default_capacity);
+
+  Text_buffer(const Text_buffer&)                    = delete;
+  Text_buffer(Text_buffer&&)                         = delete;
+  auto operator=(const Text_buffer&) -> Text_buffer& = delete;
+  auto operator=(Text_buffer&&) -> Text_buffer&      = delete;
+
+  /// Flushes to the stream, if any, ignoring failure
+  ~Text_buffer();
+
+  auto operator<<(std::string_view text) -> Text_buffer&;
+
+  /// Without this, string literals would print as `bool`
+  auto operator<<(const char* const text) -> Text_buffer&
+  {
+    return *this << std::string_view {text};
+  }
+
+  auto operator<<(char character) -> Text_buffer&;
+
+  auto operator<<(bool value) -> Text_buffer&;
+
+  auto operator<<(Fixed value) -> Text_buffer&;
+
+  template <typename T, typename = std::enable_if_t<is_number<T>>>
+  auto operator<<(const T value) -> Text_buffer&
+  {
+    constexpr std::size_t digits {24};
+    char* const first {room(digits)};
+    m_size += static_cast<std::size_t>(format(first, first + digits, value)
+                                       - first);
+    return *this;
+  }
+
+  auto operator<<(const Padded<std::string_view>& padded) -> Text_buffer&;
+
+  auto operator<<(const Padded<std::string>& padded) -> Text_buffer&
+  {
+    return *this << Padded<std::string_view> {padded.value, padded.width,
+                                              padded.fill, padded.align};
+  }
+
+  template <typename T>
+  auto operator<<(const Padded<T>& padded) -> Text_buffer&
+  {
+    std::array<char, fixed_chars(64)> scratch {};
+    const char* const last {
+        format(scratch.data(), scratch.data() + scratch.size(),
+               padded.value)};
+    return *this << Padded<std::string_view> {
+               {scratch.data(), static_cast<std::size_t>(
+                                    last - scratch.data())},
+               padded.width,
+               padded.fill,
+               padded.align};
+  }
+
+  /// Characters not yet flushed
+  [[nodiscard]] auto view() const noexcept -> std::string_view
+  {
+    return {m_data.data(), m_size};
+  }
+
+  [[nodiscard]] auto str() const -> std::string
+  {
+    return std::string {view()};
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_size;
+  }
+
+  void clear() noexcept
+  {
+    m_size = 0;
+  }
+
+  /// Write everything waiting to the stream; no effect without one
+  void flush();
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "bracket.h"
+#include "probability_table.h"
+#include "random.h"
+
+/**
+ * @brief Lines of a bracket seeded by `strength`, strongest first.
+ *
+ * `entrants` are indices into `strength`; lines past the field are
+ * `bye_line` and face the top seeds.
+ */
+[[nodiscard]] auto seeded_lines(const std::vector<std::size_t>& entrants,
+                                const std::vector<int>& strength)
+    -> std::vector<std::size_t>;
+
+/**
+ * @brief Append the finishing order of `lines` to `order`, up to
+ * `places`.
+ *
+ * `decide(top, bottom)` returns the winner of every bout that is not a
+ * bye, in the order the bouts are played: round by round, top of the
+ * bracket first, then each consolation bracket in turn.
+ */
+template <typename Decide>
+void play_bracket(std::vector<std::size_t> lines, const std::size_t places,
+                  std::vector<std::size_t>& order, Decide& decide)
+{
+  // losers of each round, kept in line order with byes as placeholders
+  std::vector<std::vector<std::size_t>> losers;
+  while ( lines.size() > 1 ) {
+    std::vector<std::size_t> winners(lines.size() / 2);
+    std::vector<std::size_t> beaten(lines.size() / 2, bye_line);
+    for ( std::size_t bout {0}; bout != winners.size(); ++bout ) {
+      const std::size_t top {lines[2 * bout]};
+      const std::size_t bottom {lines[2 * bout + 1]};
+      if ( top == bye_line || bottom == bye_line ) {
+        winners[bout] = top == bye_line ? bottom : top;
+        continue;
+      }
+      winners[bout] = decide(top, bottom);
+      beaten[bout]  = winners[bout] == top ? bottom : top;
+    }
+    losers.push_back(std::move(beaten));
+    lines = std::move(winners);
+  }
+
+  // an all-bye block awards nothing, so later places move up
+  if ( lines.front() == bye_line || order.size() == places ) {
+    return;
+  }
+  order.push_back(lines.front());
+
+  // the final's loser is second, the semifinal losers play for third...
+  for ( auto round = losers.rbegin(); round != losers.rend(); ++round ) {
+    if ( order.size() >= places ) {
+      break;
+    }
+    play_bracket(std::move(*round), places, order, decide);
+  }
+}
+
+/**
+ * @brief Play out a single-elimination bracket with full placement.
+ *
+ * `lines` hold indices into `table` or `bye_line`. The champion places
+ * first and the runner-up second; the losers of each earlier round play
+ * their own bracket, in the same line order, for the next block of
+ * places. Only the consolation rounds needed to fill the first `places`
+ * places are played. Returns entrants in finishing order.
+ */
+[[nodiscard]] auto simulate_bracket(const std::vector<std::size_t>& lines,
+                                    const Probability_table& table,
+                                    Rng& rng, std::size_t places)
+    -> std::vector<std::size_t>;
+
+#endif
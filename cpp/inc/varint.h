@@ -0,0 +1,65 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstdint>
+#include <vector>
+
+/// Map signed values onto unsigned so small magnitudes stay small
+[[nodiscard]] constexpr auto
+zigzag_encode(const std::int64_t value) noexcept -> std::uint64_t
+{
+  return (static_cast<std::uint64_t>(value) << 1U)
+       ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+[[nodiscard]] constexpr auto
+zigzag_decode(const std::uint64_t value) noexcept -> std::int64_t
+{
+  return static_cast<std::int64_t>(value >> 1U)
+       ^ -static_cast<std::int64_t>(value & 1U);
+}
+
+/// Append `value` as an unsigned LEB128 varint
+inline void put_varint(std::vector<unsigned char>& out,
+                       std::uint64_t value)
+{
+  while ( value >= 0x80U ) {
+    out.push_back(static_cast<unsigned char>(value | 0x80U));
+    value >>= 7U;
+  }
+  out.push_back(static_cast<unsigned char>(value));
+}
+
+/// Read a varint at `cursor` and advance past it; input is trusted
+[[nodiscard]] inline auto get_varint(const unsigned char*& cursor) noexcept
+    -> std::uint64_t
+{
+  // most values written by this repo fit in one byte
+  if ( *cursor < 0x80U ) {
+    return *cursor++;
+  }
+  std::uint64_t value {0};
+  unsigned shift {0};
+  while ( (*cursor & 0x80U) != 0 ) {
+    value |= static_cast<std::uint64_t>(*cursor & 0x7FU) << shift;
+    shift += 7;
+    ++cursor;
+  }
+  value |= static_cast<std::uint64_t>(*cursor) << shift;
+  ++cursor;
+  return value;
+}
+
+inline void put_signed_varint(std::vector<unsigned char>& out,
+                              const std::int64_t value)
+{
+  put_varint(out, zigzag_encode(value));
+}
+
+[[nodiscard]] inline auto get_signed_varint(
+    const unsigned char*& cursor) noexcept -> std::int64_t
+{
+  return zigzag_decode(get_varint(cursor));
+}
+
+#endif
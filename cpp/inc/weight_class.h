@@ -0,0 +1,85 @@
+#ifndef WEIGHT_CLASS_H
+#define WEIGHT_CLASS_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Ordered weight class limits, lightest first.
+ *
+ * A wrestler's natural class is the lightest one they make weight for,
+ * counting any allowance granted on top of each limit.
+ */
+class Weight_classes
+{
+private:
+
+  std::vector<int> m_limits {};
+
+public:
+
+  static constexpr std::size_t none {~std::size_t {0}};
+
+  Weight_classes() = default;
+
+  /// Limits must be strictly increasing
+  explicit Weight_classes(std::vector<int> limits)
+      : m_limits {std::move(limits)}
+  {
+    for ( std::size_t index {1}; index < m_limits.size(); ++index ) {
+      if ( m_limits[index] <= m_limits[index - 1] ) {
+        throw std::invalid_argument {
+            "Weight class limits must be increasing"};
+      }
+    }
+  }
+
+  /// The fourteen high school classes
+  [[nodiscard]] static auto high_school() -> Weight_classes
+  {
+    return Weight_classes {{106, 113, 120, 126, 132, 138, 144, 150, 157,
+                            165, 175, 190, 215, 285}};
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_limits.size();
+  }
+
+  [[nodiscard]] auto limit(const std::size_t weight_class) const noexcept
+      -> int
+  {
+    return m_limits[weight_class];
+  }
+
+  /// Lightest class `weight` makes, or `none` if it is over every limit
+  [[nodiscard]] auto natural_class(const int weight,
+                                   const int allowance = 0) const noexcept
+      -> std::size_t
+  {
+    for ( std::size_t index {0}; index != m_limits.size(); ++index ) {
+      if ( weight <= m_limits[index] + allowance ) {
+        return index;
+      }
+    }
+    return none;
+  }
+
+  /// May a wrestler of `weight` enter `weight_class`, at most
+  /// `classes_up` above their natural class?
+  [[nodiscard]] auto eligible(const int weight,
+                              const std::size_t weight_class,
+                              const int allowance,
+                              const std::size_t classes_up) const noexcept
+      -> bool
+  {
+    const std::size_t natural {natural_class(weight, allowance)};
+    return natural != none && weight_class >= natural
+        && weight_class - natural <= classes_up
+        && weight_class < m_limits.size();
+  }
+};
+
+#endif
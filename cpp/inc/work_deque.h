@@ -0,0 +1,104 @@
+#ifndef WORK_DEQUE_H
+#define WORK_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Lock-free work-stealing deque of indices (Chase and Lev).
+ *
+ * The owning thread pushes and pops at the bottom; any other thread may
+ * steal from the top. The capacity is fixed, so callers must know an
+ * upper bound on how many items it will ever hold at once.
+ */
+class Work_deque
+{
+private:
+
+  std::unique_ptr<std::atomic<std::size_t>[]> m_buffer;
+  std::int64_t m_mask;
+  alignas(64) std::atomic<std::int64_t> m_top {0};
+  alignas(64) std::atomic<std::int64_t> m_bottom {0};
+
+  [[nodiscard]] auto slot(const std::int64_t index) const noexcept
+      -> std::atomic<std::size_t>&
+  {
+    return m_buffer[static_cast<std::size_t>(index & m_mask)];
+  }
+
+public:
+
+  static constexpr std::size_t empty {~std::size_t {0}};
+
+  /// Room for at least `capacity` items
+  explicit Work_deque(const std::size_t capacity)
+      : m_buffer {}
+      , m_mask {0}
+  {
+    std::size_t size {1};
+    while ( size < capacity ) {
+      size *= 2;
+    }
+    m_buffer = std::make_unique<std::atomic<std::size_t>[]>(size);
+    m_mask   = static_cast<std::int64_t>(size - 1);
+  }
+
+  /// Owner only
+  void push(const std::size_t item) noexcept
+  {
+    const std::int64_t bottom {m_bottom.load(std::memory_order_relaxed)};
+    slot(bottom).store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  /// Owner only; the most recently pushed item, or `empty`
+  [[nodiscard]] auto pop() noexcept -> std::size_t
+  {
+    const std::int64_t bottom {m_bottom.load(std::memory_order_relaxed)
+                               - 1};
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top {m_top.load(std::memory_order_relaxed)};
+
+    if ( top > bottom ) {
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return empty;
+    }
+
+    const std::size_t item {slot(bottom).load(std::memory_order_relaxed)};
+    if ( top == bottom ) {
+      // the last item: race any thief for it
+      const bool won {m_top.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst,
+          std::memory_order_relaxed)};
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return won ? item : empty;
+    }
+    return item;
+  }
+
+  /// Any thread; the oldest item, or `empty` if there is none or another
+  /// thread got there first
+  [[nodiscard]] auto steal() noexcept -> std::size_t
+  {
+    std::int64_t top {m_top.load(std::memory_order_acquire)};
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom {m_bottom.load(std::memory_order_acquire)};
+    if ( top >= bottom ) {
+      return empty;
+    }
+
+    const std::size_t item {slot(top).load(std::memory_order_relaxed)};
+    if ( !m_top.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed) ) {
+      return empty;
+    }
+    return item;
+  }
+};
+
+#endif
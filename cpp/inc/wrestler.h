@@ -39,6 +39,11 @@ public:
   {
     return m_ability;
   }
+
+  constexpr void set_ability(const int ability) noexcept
+  {
+    m_ability = ability;
+  }
 };
 
 #endif
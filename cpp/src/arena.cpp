@@ -0,0 +1,104 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+auto padding(const void* const address, const std::size_t align) noexcept
+    -> std::size_t
+{
+  const auto value = reinterpret_cast<std::uintptr_t>(address);
+  return (align - (value & (align - 1))) & (align - 1);
+}
+
+} // namespace
+
+Arena::Arena(const std::size_t capacity, const bool huge_pages)
+    : m_huge_pages {huge_pages}
+{
+  m_blocks.push_back(make_block(capacity));
+}
+
+auto Arena::make_block(const std::size_t size) const -> Block
+{
+  if ( m_huge_pages ) {
+    Page_mapping mapping {size, true};
+    unsigned char* const data {mapping.data()};
+    const std::size_t mapped {mapping.size()};
+    return {nullptr, std::move(mapping), data, mapped};
+  }
+  auto heap = std::make_unique<unsigned char[]>(size);
+  unsigned char* const data {heap.get()};
+  return {std::move(heap), {}, data, size};
+}
+
+auto Arena::allocate(const std::size_t bytes, const std::size_t align)
+    -> void*
+{
+  Block& block {m_blocks[m_block]};
+  unsigned char* const cursor {block.data + m_offset};
+  const std::size_t pad {padding(cursor, align)};
+  if ( pad + bytes > block.size - m_offset ) {
+    return allocate_slow(bytes, align);
+  }
+
+  m_offset += pad + bytes;
+  m_used += pad + bytes;
+  m_high_water = std::max(m_high_water, m_used);
+  return cursor + pad;
+}
+
+auto Arena::allocate_slow(const std::size_t bytes, const std::size_t align)
+    -> void*
+{
+  // the tail of the current block is wasted
+  m_used += m_blocks[m_block].size - m_offset;
+
+  const std::size_t needed {bytes + align};
+  ++m_block;
+  if ( m_block == m_blocks.size() || m_blocks[m_block].size < needed ) {
+    const std::size_t size {
+        std::max(needed, 2 * m_blocks[m_block - 1].size)};
+    m_blocks.insert(
+        m_blocks.begin() + static_cast<std::ptrdiff_t>(m_block),
+        make_block(size));
+  }
+  m_offset = 0;
+  return allocate(bytes, align);
+}
+
+void Arena::reset()
+{
+  if ( m_blocks.size() > 1 ) {
+    const std::size_t total {capacity()};
+    m_blocks.clear();
+    m_blocks.push_back(make_block(total));
+  }
+  m_block  = 0;
+  m_offset = 0;
+  m_used   = 0;
+}
+
+auto Arena::capacity() const noexcept -> std::size_t
+{
+  std::size_t total {0};
+  for ( const Block& block : m_blocks ) {
+    total += block.size;
+  }
+  return total;
+}
+
+auto Arena::huge_page_coverage() const -> Huge_page_coverage
+{
+  Huge_page_coverage coverage;
+  for ( const Block& block : m_blocks ) {
+    if ( block.heap ) {
+      coverage += {block.size, 0};
+    } else {
+      coverage += block.mapping.coverage();
+    }
+  }
+  return coverage;
+}
@@ -0,0 +1,424 @@
+#include "arrow_stream.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+/**
+ * Minimal FlatBuffers builder. Like the reference builder it writes back
+ * to front, so everything a table refers to is finished before the
+ * table; bytes are kept reversed so prepending is an append. A `Ref` is
+ * an object's distance from the end of the finished buffer.
+ */
+class Flatbuffer
+{
+public:
+
+  using Ref = std::uint32_t;
+
+private:
+
+  std::vector<unsigned char> m_reversed {};
+  std::size_t m_max_align {1};
+  std::vector<std::pair<std::uint16_t, Ref>> m_fields {};
+  Ref m_table_start {0};
+
+  void pad(const std::size_t bytes)
+  {
+    m_reversed.insert(m_reversed.end(), bytes, 0);
+  }
+
+  /// Pad so that `length` more bytes end on an `alignment` boundary
+  void prealign(const std::size_t length, const std::size_t alignment)
+  {
+    m_max_align = std::max(m_max_align, alignment);
+    pad((alignment - (m_reversed.size() + length) % alignment)
+        % alignment);
+  }
+
+  template <typename T>
+  void put(const T value)
+  {
+    std::array<unsigned char, sizeof(T)> bytes {};
+    std::memcpy(bytes.data(), &value, sizeof(T));
+    m_reversed.insert(m_reversed.end(), bytes.rbegin(), bytes.rend());
+  }
+
+public:
+
+  [[nodiscard]] auto size() const noexcept -> Ref
+  {
+    return static_cast<Ref>(m_reversed.size());
+  }
+
+  template <typename T>
+  auto scalar(const T value) -> Ref
+  {
+    prealign(sizeof(T), sizeof(T));
+    put(value);
+    return size();
+  }
+
+  auto reference(const Ref target) -> Ref
+  {
+    prealign(sizeof(Ref), sizeof(Ref));
+    put<Ref>(size() + Ref {sizeof(Ref)} - target);
+    return size();
+  }
+
+  auto string(const std::string_view text) -> Ref
+  {
+    prealign(text.size() + 1, sizeof(Ref));
+    pad(1);
+    m_reversed.insert(m_reversed.end(), text.rbegin(), text.rend());
+    put(static_cast<std::uint32_t>(text.size()));
+    return size();
+  }
+
+  auto references(const std::vector<Ref>& items) -> Ref
+  {
+    prealign(items.size() * sizeof(Ref), sizeof(Ref));
+    for ( auto item = items.rbegin(); item != items.rend(); ++item ) {
+      reference(*item);
+    }
+    put(static_cast<std::uint32_t>(items.size()));
+    return size();
+  }
+
+  /// Vector of structs made of two longs, such as `FieldNode`
+  auto long_pairs(const std::vector<std::array<std::int64_t, 2>>& items)
+      -> Ref
+  {
+    const std::size_t bytes {items.size() * 16};
+    prealign(bytes, sizeof(Ref));
+    prealign(bytes, 8);
+    for ( auto item = items.rbegin(); item != items.rend(); ++item ) {
+      put((*item)[1]);
+      put((*item)[0]);
+    }
+    put(static_cast<std::uint32_t>(items.size()));
+    return size();
+  }
+
+  void start_table()
+  {
+    m_fields.clear();
+    m_table_start = size();
+  }
+
+  template <typename T>
+  void field(const std::uint16_t id, const T value)
+  {
+    m_fields.emplace_back(id, scalar(value));
+  }
+
+  void field_reference(const std::uint16_t id, const Ref target)
+  {
+    m_fields.emplace_back(id, reference(target));
+  }
+
+  auto end_table() -> Ref
+  {
+    prealign(sizeof(std::int32_t), sizeof(std::int32_t));
+    put(std::int32_t {0});
+    const Ref table {size()};
+
+    std::size_t count {0};
+    for ( const auto& [id, position] : m_fields ) {
+      count = std::max<std::size_t>(count, id + 1U);
+    }
+    std::vector<std::uint16_t> offsets(count, 0);
+    for ( const auto& [id, position] : m_fields ) {
+      offsets[id] = static_cast<std::uint16_t>(table - position);
+    }
+    for ( auto offset = offsets.rbegin(); offset != offsets.rend();
+          ++offset ) {
+      put(*offset);
+    }
+    put(static_cast<std::uint16_t>(table - m_table_start));
+    put(static_cast<std::uint16_t>(4 + 2 * count));
+    const Ref vtable {size()};
+
+    // the table starts with the signed distance back to its vtable
+    const auto distance = static_cast<std::int32_t>(vtable - table);
+    std::array<unsigned char, 4> bytes {};
+    std::memcpy(bytes.data(), &distance, bytes.size());
+    for ( std::size_t byte {0}; byte != bytes.size(); ++byte ) {
+      m_reversed[table - 1 - byte] = bytes[byte];
+    }
+    return table;
+  }
+
+  [[nodiscard]] auto finish(const Ref root) -> std::vector<unsigned char>
+  {
+    prealign(sizeof(Ref), m_max_align);
+    reference(root);
+    return {m_reversed.rbegin(), m_reversed.rend()};
+  }
+};
+
+// Arrow's Schema.fbs and Message.fbs
+constexpr std::int16_t metadata_v5 {4};
+constexpr std::uint8_t header_schema {1};
+constexpr std::uint8_t header_dictionary_batch {2};
+constexpr std::uint8_t header_record_batch {3};
+constexpr std::uint8_t type_int {2};
+constexpr std::uint8_t type_floating_point {3};
+constexpr std::uint8_t type_utf8 {5};
+constexpr std::int16_t precision_double {2};
+constexpr std::uint32_t continuation {0xFFFFFFFFU};
+
+/// Message body: buffers padded to 8 bytes, with their locations
+struct Body {
+  std::vector<unsigned char> bytes {};
+  std::vector<std::array<std::int64_t, 2>> buffers {};
+  std::vector<std::array<std::int64_t, 2>> nodes {};
+
+  void add(const void* const data, const std::size_t length)
+  {
+    buffers.push_back({static_cast<std::int64_t>(bytes.size()),
+                       static_cast<std::int64_t>(length)});
+    const auto* const begin = static_cast<const unsigned char*>(data);
+    bytes.insert(bytes.end(), begin, begin + length);
+    bytes.resize((bytes.size() + 7) / 8 * 8, 0);
+  }
+
+  /// A column with no nulls: empty validity bitmap, then its values
+  void add_column(const std::size_t rows, const void* const data,
+                  const std::size_t length)
+  {
+    nodes.push_back({static_cast<std::int64_t>(rows), 0});
+    add(nullptr, 0);
+    add(data, length);
+  }
+};
+
+auto int_type(Flatbuffer& builder, const std::int32_t bits)
+    -> Flatbuffer::Ref
+{
+  builder.start_table();
+  builder.field<std::int32_t>(0, bits);
+  builder.field<std::uint8_t>(1, 1);
+  return builder.end_table();
+}
+
+auto record_batch(Flatbuffer& builder, const std::size_t rows,
+                  const Body& body) -> Flatbuffer::Ref
+{
+  const Flatbuffer::Ref nodes {builder.long_pairs(body.nodes)};
+  const Flatbuffer::Ref buffers {builder.long_pairs(body.buffers)};
+  builder.start_table();
+  builder.field<std::int64_t>(0, static_cast<std::int64_t>(rows));
+  builder.field_reference(1, nodes);
+  builder.field_reference(2, buffers);
+  return builder.end_table();
+}
+
+/// Frame a message: continuation marker, metadata length, metadata
+/// padded to 8 bytes, then the body
+void emit(const Byte_sink& sink, Flatbuffer& builder,
+          const std::uint8_t header_type, const Flatbuffer::Ref header,
+          const std::vector<unsigned char>& body)
+{
+  builder.start_table();
+  builder.field<std::int64_t>(3, static_cast<std::int64_t>(body.size()));
+  builder.field_reference(2, header);
+  builder.field<std::int16_t>(0, metadata_v5);
+  builder.field<std::uint8_t>(1, header_type);
+  const Flatbuffer::Ref message {builder.end_table()};
+  std::vector<unsigned char> metadata {builder.finish(message)};
+  metadata.resize((metadata.size() + 7) / 8 * 8, 0);
+
+  std::array<unsigned char, 8> prefix {};
+  const auto length = static_cast<std::uint32_t>(metadata.size());
+  std::memcpy(prefix.data(), &continuation, 4);
+  std::memcpy(prefix.data() + 4, &length, 4);
+  sink(prefix.data(), prefix.size());
+  sink(metadata.data(), metadata.size());
+  if ( !body.empty() ) {
+    sink(body.data(), body.size());
+  }
+}
+
+} // namespace
+
+Arrow_table::Arrow_table(const std::size_t rows)
+    : m_rows {rows}
+{}
+
+void Arrow_table::add(std::string name, const Column_type type,
+                      const void* const values, const std::size_t count,
+                      const std::size_t width)
+{
+  if ( count != m_rows ) {
+    throw std::invalid_argument {"Column " + name
+                                 + " does not match the table's rows"};
+  }
+  const auto* const bytes = static_cast<const unsigned char*>(values);
+  m_columns.push_back({std::move(name), type,
+                       std::vector<unsigned char>(
+                           bytes, bytes + count * width),
+                       {}});
+}
+
+void Arrow_table::add_int32(std::string name,
+                            const std::vector<std::int32_t>& values)
+{
+  add(std::move(name), Column_type::int32, values.data(), values.size(),
+      sizeof(std::int32_t));
+}
+
+void Arrow_table::add_int64(std::string name,
+                            const std::vector<std::int64_t>& values)
+{
+  add(std::move(name), Column_type::int64, values.data(), values.size(),
+      sizeof(std::int64_t));
+}
+
+void Arrow_table::add_float64(std::string name,
+                              const std::vector<double>& values)
+{
+  add(std::move(name), Column_type::float64, values.data(),
+      values.size(), sizeof(double));
+}
+
+void Arrow_table::add_strings(std::string name,
+                              const std::vector<std::string>& values)
+{
+  std::unordered_map<std::string_view, std::int32_t> index;
+  std::vector<std::string> dictionary;
+  std::vector<std::int32_t> indices;
+  indices.reserve(values.size());
+  for ( const std::string& value : values ) {
+    const auto next = static_cast<std::int32_t>(dictionary.size());
+    const auto [entry, inserted] = index.emplace(value, next);
+    if ( inserted ) {
+      dictionary.push_back(value);
+    }
+    indices.push_back(entry->second);
+  }
+
+  add(std::move(name), Column_type::dictionary, indices.data(),
+      indices.size(), sizeof(std::int32_t));
+  m_columns.back().dictionary = std::move(dictionary);
+}
+
+void Arrow_table::write(const Byte_sink& sink) const
+{
+  // schema
+  {
+    Flatbuffer builder;
+    std::vector<Flatbuffer::Ref> fields;
+    for ( std::size_t index {0}; index != m_columns.size(); ++index ) {
+      const Column& column {m_columns[index]};
+      const Flatbuffer::Ref name {builder.string(column.name)};
+      const Flatbuffer::Ref children {builder.references({})};
+
+      std::uint8_t type_tag {type_int};
+      Flatbuffer::Ref type {0};
+      Flatbuffer::Ref encoding {0};
+      switch ( column.type ) {
+        case Column_type::int32:
+          type = int_type(builder, 32);
+          break;
+        case Column_type::int64:
+          type = int_type(builder, 64);
+          break;
+        case Column_type::float64:
+          type_tag = type_floating_point;
+          builder.start_table();
+          builder.field<std::int16_t>(0, precision_double);
+          type = builder.end_table();
+          break;
+        case Column_type::dictionary:
+          type_tag = type_utf8;
+          builder.start_table();
+          type = builder.end_table();
+          const Flatbuffer::Ref index_type {int_type(builder, 32)};
+          builder.start_table();
+          builder.field<std::int64_t>(0, static_cast<std::int64_t>(index));
+          builder.field_reference(1, index_type);
+          encoding = builder.end_table();
+          break;
+      }
+
+      builder.start_table();
+      builder.field_reference(0, name);
+      builder.field_reference(3, type);
+      if ( encoding != 0 ) {
+        builder.field_reference(4, encoding);
+      }
+      builder.field_reference(5, children);
+      builder.field<std::uint8_t>(1, 0);
+      builder.field<std::uint8_t>(2, type_tag);
+      fields.push_back(builder.end_table());
+    }
+
+    const Flatbuffer::Ref field_vector {builder.references(fields)};
+    builder.start_table();
+    builder.field_reference(1, field_vector);
+    builder.field<std::int16_t>(0, 0);
+    emit(sink, builder, header_schema, builder.end_table(), {});
+  }
+
+  // one dictionary batch per string column
+  for ( std::size_t index {0}; index != m_columns.size(); ++index ) {
+    const Column& column {m_columns[index]};
+    if ( column.type != Column_type::dictionary ) {
+      continue;
+    }
+    std::vector<std::int32_t> offsets {0};
+    std::string text;
+    for ( const std::string& value : column.dictionary ) {
+      text += value;
+      offsets.push_back(static_cast<std::int32_t>(text.size()));
+    }
+    Body body;
+    body.nodes.push_back(
+        {static_cast<std::int64_t>(column.dictionary.size()), 0});
+    body.add(nullptr, 0);
+    body.add(offsets.data(), offsets.size() * sizeof(std::int32_t));
+    body.add(text.data(), text.size());
+
+    Flatbuffer builder;
+    const Flatbuffer::Ref data {
+        record_batch(builder, column.dictionary.size(), body)};
+    builder.start_table();
+    builder.field<std::int64_t>(0, static_cast<std::int64_t>(index));
+    builder.field_reference(1, data);
+    emit(sink, builder, header_dictionary_batch, builder.end_table(),
+         body.bytes);
+  }
+
+  // the rows
+  {
+    Body body;
+    for ( const Column& column : m_columns ) {
+      body.add_column(m_rows, column.values.data(), column.values.size());
+    }
+    Flatbuffer builder;
+    emit(sink, builder, header_record_batch,
+         record_batch(builder, m_rows, body), body.bytes);
+  }
+
+  const std::array<std::uint32_t, 2> end_of_stream {continuation, 0};
+  //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  sink(reinterpret_cast<const unsigned char*>(end_of_stream.data()),
+       sizeof(end_of_stream));
+}
+
+auto Arrow_table::encode() const -> std::vector<unsigned char>
+{
+  std::vector<unsigned char> stream;
+  write([&stream](const unsigned char* const data,
+                  const std::size_t size) {
+    stream.insert(stream.end(), data, data + size);
+  });
+  return stream;
+}
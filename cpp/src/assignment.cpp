@@ -0,0 +1,79 @@
+#include "assignment.h"
+
+#include <limits>
+#include <stdexcept>
+
+auto Assignment_solver::solve(const std::size_t rows,
+                              const std::size_t columns,
+                              const double* const cost)
+    -> const std::vector<std::size_t>&
+{
+  if ( rows > columns ) {
+    throw std::invalid_argument {"More rows than columns to assign"};
+  }
+
+  constexpr double infinity {std::numeric_limits<double>::infinity()};
+
+  // index 0 is a virtual column that anchors each augmenting path; rows
+  // and columns are 1-based below
+  m_row_potential.assign(rows + 1, 0.0);
+  m_column_potential.assign(columns + 1, 0.0);
+  m_row_of_column.assign(columns + 1, 0);
+  m_previous.assign(columns + 1, 0);
+
+  for ( std::size_t row {1}; row <= rows; ++row ) {
+    m_row_of_column[0] = row;
+    std::size_t column {0};
+    m_slack.assign(columns + 1, infinity);
+    m_used.assign(columns + 1, false);
+
+    do {
+      m_used[column] = true;
+      const std::size_t current {m_row_of_column[column]};
+      const double* const costs {cost + (current - 1) * columns};
+      double delta {infinity};
+      std::size_t next {0};
+
+      for ( std::size_t other {1}; other <= columns; ++other ) {
+        if ( m_used[other] ) {
+          continue;
+        }
+        const double reduced {costs[other - 1] - m_row_potential[current]
+                              - m_column_potential[other]};
+        if ( reduced < m_slack[other] ) {
+          m_slack[other]    = reduced;
+          m_previous[other] = column;
+        }
+        if ( m_slack[other] < delta ) {
+          delta = m_slack[other];
+          next  = other;
+        }
+      }
+
+      for ( std::size_t other {0}; other <= columns; ++other ) {
+        if ( m_used[other] ) {
+          m_row_potential[m_row_of_column[other]] += delta;
+          m_column_potential[other] -= delta;
+        } else {
+          m_slack[other] -= delta;
+        }
+      }
+      column = next;
+    } while ( m_row_of_column[column] != 0 );
+
+    // flip the augmenting path back to the virtual column
+    do {
+      const std::size_t previous {m_previous[column]};
+      m_row_of_column[column] = m_row_of_column[previous];
+      column                  = previous;
+    } while ( column != 0 );
+  }
+
+  m_column_of_row.assign(rows, unmatched);
+  for ( std::size_t column {1}; column <= columns; ++column ) {
+    if ( m_row_of_column[column] != 0 ) {
+      m_column_of_row[m_row_of_column[column] - 1] = column - 1;
+    }
+  }
+  return m_column_of_row;
+}
@@ -0,0 +1,390 @@
+#include "async_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+/// Offsets and lengths `O_DIRECT` accepts on every common file system
+constexpr std::size_t direct_block {4096};
+
+auto system_error(const std::string& what, const int error)
+    -> std::runtime_error
+{
+  return std::runtime_error {what + ": " + std::strerror(error)};
+}
+
+} // namespace
+
+/**
+ * Just enough of io_uring for one writer: vectored writes in, their
+ * completions out, with no submission queue polling.
+ */
+class Async_file_writer::Ring
+{
+private:
+
+  int m_descriptor {-1};
+  void* m_submission_map {nullptr};
+  std::size_t m_submission_bytes {0};
+  void* m_completion_map {nullptr};
+  std::size_t m_completion_bytes {0};
+  void* m_entry_map {nullptr};
+  std::size_t m_entry_bytes {0};
+
+  unsigned* m_submission_tail {nullptr};
+  unsigned* m_submission_array {nullptr};
+  unsigned m_submission_mask {0};
+  io_uring_sqe* m_entries {nullptr};
+  unsigned* m_completion_head {nullptr};
+  unsigned* m_completion_tail {nullptr};
+  unsigned m_completion_mask {0};
+  io_uring_cqe* m_completions {nullptr};
+
+  /// Kept alive until the kernel has read them
+  std::array<::iovec, 2> m_vectors {};
+
+  Ring() = default;
+
+  auto enter(const unsigned submit, const unsigned complete,
+             const unsigned flags) const noexcept -> long
+  {
+    return ::syscall(__NR_io_uring_enter, m_descriptor, submit, complete,
+                     flags, nullptr, 0);
+  }
+
+  template <typename T>
+  static auto at(void* const map, const unsigned offset) noexcept -> T*
+  {
+    return reinterpret_cast<T*>(static_cast<unsigned char*>(map)
+                                + offset);
+  }
+
+public:
+
+  /// Null if the kernel has no usable io_uring
+  static auto create(const unsigned entries) -> std::unique_ptr<Ring>
+  {
+    io_uring_params params {};
+    const long descriptor {
+        ::syscall(__NR_io_uring_setup, entries, &params)};
+    if ( descriptor < 0 ) {
+      return nullptr;
+    }
+
+    std::unique_ptr<Ring> ring {new Ring};
+    ring->m_descriptor = static_cast<int>(descriptor);
+
+    const auto map = [&ring](const std::size_t bytes,
+                             const long long offset) -> void* {
+      void* const address {::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE,
+                                  ring->m_descriptor, offset)};
+      return address == MAP_FAILED ? nullptr : address;
+    };
+
+    ring->m_submission_bytes =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->m_completion_bytes =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_map {(params.features & IORING_FEAT_SINGLE_MMAP)
+                           != 0};
+    if ( single_map ) {
+      ring->m_submission_bytes = std::max(ring->m_submission_bytes,
+                                          ring->m_completion_bytes);
+    }
+
+    ring->m_submission_map =
+        map(ring->m_submission_bytes, IORING_OFF_SQ_RING);
+    if ( !single_map ) {
+      ring->m_completion_map =
+          map(ring->m_completion_bytes, IORING_OFF_CQ_RING);
+    }
+    ring->m_entry_bytes = params.sq_entries * sizeof(io_uring_sqe);
+    ring->m_entry_map   = map(ring->m_entry_bytes, IORING_OFF_SQES);
+
+    void* const completion_map {single_map ? ring->m_submission_map
+                                           : ring->m_completion_map};
+    if ( ring->m_submission_map == nullptr || completion_map == nullptr
+         || ring->m_entry_map == nullptr ) {
+      return nullptr;
+    }
+
+    void* const submission {ring->m_submission_map};
+    ring->m_submission_tail = at<unsigned>(submission, params.sq_off.tail);
+    ring->m_submission_array =
+        at<unsigned>(submission, params.sq_off.array);
+    ring->m_submission_mask =
+        *at<unsigned>(submission, params.sq_off.ring_mask);
+    ring->m_entries = static_cast<io_uring_sqe*>(ring->m_entry_map);
+
+    ring->m_completion_head =
+        at<unsigned>(completion_map, params.cq_off.head);
+    ring->m_completion_tail =
+        at<unsigned>(completion_map, params.cq_off.tail);
+    ring->m_completion_mask =
+        *at<unsigned>(completion_map, params.cq_off.ring_mask);
+    ring->m_completions =
+        at<io_uring_cqe>(completion_map, params.cq_off.cqes);
+
+    return ring;
+  }
+
+  Ring(const Ring&) = delete;
+  auto operator=(const Ring&) -> Ring& = delete;
+  Ring(Ring&&)                         = delete;
+  auto operator=(Ring&&) -> Ring&      = delete;
+
+  ~Ring()
+  {
+    if ( m_entry_map != nullptr ) {
+      ::munmap(m_entry_map, m_entry_bytes);
+    }
+    if ( m_completion_map != nullptr ) {
+      ::munmap(m_completion_map, m_completion_bytes);
+    }
+    if ( m_submission_map != nullptr ) {
+      ::munmap(m_submission_map, m_submission_bytes);
+    }
+    ::close(m_descriptor);
+  }
+
+  /// Queue a write of `data`; `tag` (0 or 1) comes back on completion
+  void write(const int file, unsigned char* const data,
+             const std::size_t length, const std::uint64_t offset,
+             const std::size_t tag)
+  {
+    m_vectors[tag] = {data, length};
+
+    const unsigned tail {*m_submission_tail};
+    const unsigned index {tail & m_submission_mask};
+    io_uring_sqe& entry {m_entries[index]};
+    entry           = io_uring_sqe {};
+    entry.opcode    = IORING_OP_WRITEV;
+    entry.fd        = file;
+    entry.addr      = reinterpret_cast<std::uint64_t>(&m_vectors[tag]);
+    entry.len       = 1;
+    entry.off       = offset;
+    entry.user_data = tag;
+    m_submission_array[index] = index;
+    __atomic_store_n(m_submission_tail, tail + 1, __ATOMIC_RELEASE);
+
+    while ( enter(1, 0, 0) < 0 ) {
+      if ( errno != EINTR ) {
+        throw system_error("Cannot queue write", errno);
+      }
+    }
+  }
+
+  /// The next completion, waiting for one if necessary
+  auto complete() -> io_uring_cqe
+  {
+    while ( true ) {
+      const unsigned head {*m_completion_head};
+      if ( head
+           != __atomic_load_n(m_completion_tail, __ATOMIC_ACQUIRE) ) {
+        const io_uring_cqe completion {
+            m_completions[head & m_completion_mask]};
+        __atomic_store_n(m_completion_head, head + 1, __ATOMIC_RELEASE);
+        return completion;
+      }
+      if ( enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR ) {
+        throw system_error("Cannot wait for write", errno);
+      }
+    }
+  }
+};
+
+Async_file_writer::Async_file_writer(const std::string& path,
+                                     const Async_file_params& params)
+    : m_ring {params.force_pwrite ? nullptr : Ring::create(4)}
+{
+  constexpr int flags {O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC};
+  if ( params.direct ) {
+    m_descriptor = ::open(path.c_str(), flags | O_DIRECT, 0644);
+    m_direct     = m_descriptor >= 0;
+  }
+  if ( m_descriptor < 0 ) {
+    m_descriptor = ::open(path.c_str(), flags, 0644);
+  }
+  if ( m_descriptor < 0 ) {
+    throw system_error("Cannot open " + path, errno);
+  }
+
+  const std::size_t bytes {std::max(params.buffer_bytes, direct_block)};
+  m_buffers = {Page_mapping {bytes, false}, Page_mapping {bytes, false}};
+}
+
+Async_file_writer::~Async_file_writer()
+{
+  if ( m_failed ) {
+    abandon();
+    return;
+  }
+  try {
+    close();
+  } catch ( ... ) {
+    // an exception already on its way out carries the first error
+    if ( std::uncaught_exceptions() == 0 ) {
+      std::terminate();
+    }
+  }
+}
+
+void Async_file_writer::submit(const std::size_t buffer,
+                               const std::size_t length)
+{
+  m_length[buffer]   = length;
+  m_position[buffer] = m_offset;
+  m_offset += length;
+
+  if ( m_ring ) {
+    m_ring->write(m_descriptor, m_buffers[buffer].data(), length,
+                  m_position[buffer], buffer);
+    m_in_flight[buffer] = true;
+  } else {
+    write_rest(m_buffers[buffer].data(), length, m_position[buffer]);
+  }
+}
+
+void Async_file_writer::wait(const std::size_t buffer)
+{
+  while ( m_in_flight[buffer] ) {
+    const io_uring_cqe completion {m_ring->complete()};
+    const auto done = static_cast<std::size_t>(completion.user_data);
+    m_in_flight[done] = false;
+    if ( completion.res < 0 ) {
+      m_failed = true;
+      throw system_error("Cannot write results", -completion.res);
+    }
+    const std::size_t wrote {
+        resume_point(static_cast<std::size_t>(completion.res))};
+    if ( wrote < m_length[done] ) {
+      write_rest(m_buffers[done].data() + wrote, m_length[done] - wrote,
+                 m_position[done] + wrote);
+    }
+  }
+}
+
+void Async_file_writer::write_rest(const unsigned char* data,
+                                   std::size_t length,
+                                   std::uint64_t offset)
+{
+  while ( length != 0 ) {
+    const ::ssize_t wrote {::pwrite(m_descriptor, data, length,
+                                    static_cast<::off_t>(offset))};
+    if ( wrote < 0 ) {
+      if ( errno == EINTR ) {
+        continue;
+      }
+      m_failed = true;
+      throw system_error("Cannot write results", errno);
+    }
+    const std::size_t done {
+        wrote == static_cast<::ssize_t>(length)
+            ? length
+            : resume_point(static_cast<std::size_t>(wrote))};
+    data += done;
+    length -= done;
+    offset += done;
+  }
+}
+
+auto Async_file_writer::resume_point(const std::size_t wrote) const
+    noexcept -> std::size_t
+{
+  // O_DIRECT only takes block-aligned offsets, so rewrite the part block
+  return m_direct ? wrote / direct_block * direct_block : wrote;
+}
+
+void Async_file_writer::abandon() noexcept
+{
+  if ( m_descriptor < 0 ) {
+    return;
+  }
+  // the kernel may still be reading the buffers
+  for ( std::size_t buffer {0}; buffer != m_buffers.size(); ++buffer ) {
+    try {
+      wait(buffer);
+    } catch ( ... ) {
+      m_in_flight[buffer] = false;
+    }
+  }
+  ::close(m_descriptor);
+  m_descriptor = -1;
+}
+
+void Async_file_writer::append(const unsigned char* data,
+                               std::size_t size)
+{
+  while ( size != 0 ) {
+    const std::size_t capacity {m_buffers[m_current].size()};
+    const std::size_t chunk {std::min(size, capacity - m_used)};
+    std::memcpy(m_buffers[m_current].data() + m_used, data, chunk);
+    m_used += chunk;
+    m_bytes += chunk;
+    data += chunk;
+    size -= chunk;
+
+    if ( m_used == capacity ) {
+      submit(m_current, capacity);
+      m_current = 1 - m_current;
+      wait(m_current);
+      m_used = 0;
+    }
+  }
+}
+
+void Async_file_writer::close()
+{
+  if ( m_descriptor < 0 ) {
+    return;
+  }
+  try {
+    if ( m_used != 0 ) {
+      std::size_t length {m_used};
+      if ( m_direct ) {
+        length = (m_used + direct_block - 1) / direct_block * direct_block;
+        std::memset(m_buffers[m_current].data() + m_used, 0,
+                    length - m_used);
+      }
+      submit(m_current, length);
+      m_used = 0;
+    }
+    wait(0);
+    wait(1);
+    if ( m_offset != m_bytes
+         && ::ftruncate(m_descriptor, static_cast<::off_t>(m_bytes))
+                != 0 ) {
+      throw system_error("Cannot trim results", errno);
+    }
+  } catch ( ... ) {
+    m_failed = true;
+    abandon();
+    throw;
+  }
+
+  const int result {::close(m_descriptor)};
+  m_descriptor = -1;
+  if ( result != 0 ) {
+    m_failed = true;
+    throw system_error("Cannot close results", errno);
+  }
+}
+
+auto Async_file_writer::sink() -> Byte_sink
+{
+  return [this](const unsigned char* const data, const std::size_t size) {
+    append(data, size);
+  };
+}
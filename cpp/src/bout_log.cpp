@@ -0,0 +1,335 @@
+#include "bout_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include "varint.h"
+
+namespace {
+
+// structs and checksum words are written as they sit in memory
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Bout logs are little-endian");
+static_assert(sizeof(Bout_log_format::Header) == 16);
+static_assert(sizeof(Bout_log_format::Block_entry) == 40);
+static_assert(sizeof(Bout_log_format::Trailer) == 40);
+
+/// Result types fit in the low bits of the packed score
+constexpr unsigned result_bits {3};
+
+template <typename T>
+void append_raw(Async_file_writer& file, const T* data,
+                const std::size_t count)
+{
+  //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  file.append(reinterpret_cast<const unsigned char*>(data),
+              sizeof(T) * count);
+}
+
+} // namespace
+
+auto log_checksum(const unsigned char* data, std::size_t size) noexcept
+    -> std::uint64_t
+{
+  // two independent lanes keep the multiplier busy
+  std::uint64_t lhs {0x9e3779b97f4a7c15ULL ^ size};
+  std::uint64_t rhs {0xc2b2ae3d27d4eb4fULL};
+  const auto mix = [](std::uint64_t hash, const std::uint64_t word) {
+    hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+    return hash ^ (hash >> 32U);
+  };
+
+  while ( size >= 16 ) {
+    std::uint64_t first {0};
+    std::uint64_t second {0};
+    std::memcpy(&first, data, 8);
+    std::memcpy(&second, data + 8, 8);
+    lhs = mix(lhs, first);
+    rhs = mix(rhs, second);
+    data += 16;
+    size -= 16;
+  }
+  if ( size >= 8 ) {
+    std::uint64_t word {0};
+    std::memcpy(&word, data, 8);
+    lhs = mix(lhs, word);
+    data += 8;
+    size -= 8;
+  }
+  std::uint64_t tail {0};
+  std::memcpy(&tail, data, size);
+  return mix(mix(lhs, tail), rhs);
+}
+
+Bout_log_writer::Bout_log_writer(const std::string& path,
+                                 const std::size_t block_bytes)
+    : m_file {path}
+    , m_block_bytes {block_bytes}
+{
+  const Bout_log_format::Header header {Bout_log_format::magic,
+                                        Bout_log_format::version, 0};
+  append_raw(m_file, &header, 1);
+  m_offset = sizeof(header);
+}
+
+Bout_log_writer::~Bout_log_writer()
+{
+  if ( m_failed ) {
+    return;
+  }
+  try {
+    close();
+  } catch ( ... ) {
+    // an exception already on its way out carries the first error
+    if ( std::uncaught_exceptions() == 0 ) {
+      std::terminate();
+    }
+  }
+}
+
+void Bout_log_writer::append(const Bout_event& event)
+{
+  if ( m_closed ) {
+    throw std::logic_error {"Bout log is closed"};
+  }
+  if ( !m_started || event.tournament != m_last_tournament ) {
+    if ( m_started && event.tournament < m_last_tournament ) {
+      throw std::invalid_argument {
+          "Bout log tournaments must be contiguous and ascending"};
+    }
+    try {
+      encode_tournament();
+    } catch ( ... ) {
+      m_failed = true;
+      throw;
+    }
+    m_last_tournament = event.tournament;
+    m_started         = true;
+  }
+  m_tournament.push_back(event);
+}
+
+void Bout_log_writer::encode_tournament()
+{
+  if ( m_tournament.empty() ) {
+    return;
+  }
+  const std::uint64_t tournament {m_tournament.front().tournament};
+
+  m_ids.clear();
+  for ( const Bout_event& event : m_tournament ) {
+    m_ids.push_back(event.winner);
+    m_ids.push_back(event.loser);
+  }
+  std::sort(m_ids.begin(), m_ids.end());
+  m_ids.erase(std::unique(m_ids.begin(), m_ids.end()), m_ids.end());
+  const auto position = [this](const int id) {
+    return static_cast<std::uint64_t>(
+        std::lower_bound(m_ids.begin(), m_ids.end(), id) - m_ids.begin());
+  };
+
+  m_body.clear();
+  put_varint(m_body, m_ids.size());
+  put_signed_varint(m_body, m_ids.front());
+  for ( std::size_t index {1}; index != m_ids.size(); ++index ) {
+    put_varint(m_body, static_cast<std::uint64_t>(
+                           static_cast<std::int64_t>(m_ids[index])
+                           - m_ids[index - 1]));
+  }
+
+  std::int64_t slot {-1};
+  for ( const Bout_event& event : m_tournament ) {
+    put_signed_varint(m_body, event.slot - slot - 1);
+    slot = event.slot;
+    put_varint(m_body, position(event.winner));
+    put_varint(m_body, position(event.loser));
+    put_varint(m_body, zigzag_encode(event.winner_score) << result_bits
+                           | static_cast<std::uint64_t>(event.result));
+    put_signed_varint(m_body, event.winner_score - event.loser_score);
+    put_varint(m_body, event.duration);
+  }
+
+  if ( m_block.empty() ) {
+    m_entry = {m_offset, tournament, tournament, 0, 0, 0};
+  }
+  put_varint(m_block, tournament - m_entry.last_tournament);
+  put_varint(m_block, m_tournament.size());
+  put_varint(m_block, m_body.size());
+  m_block.insert(m_block.end(), m_body.begin(), m_body.end());
+
+  m_entry.last_tournament = tournament;
+  m_entry.events += static_cast<std::uint32_t>(m_tournament.size());
+  m_events += m_tournament.size();
+  m_tournament.clear();
+
+  if ( m_block.size() >= m_block_bytes ) {
+    seal_block();
+  }
+}
+
+void Bout_log_writer::seal_block()
+{
+  if ( m_block.empty() ) {
+    return;
+  }
+  m_entry.bytes    = static_cast<std::uint32_t>(m_block.size());
+  m_entry.checksum = log_checksum(m_block.data(), m_block.size());
+  m_file.append(m_block.data(), m_block.size());
+  m_offset += m_block.size();
+  m_index.push_back(m_entry);
+  m_block.clear();
+}
+
+void Bout_log_writer::close()
+{
+  if ( m_closed ) {
+    return;
+  }
+  m_closed = true;
+  try {
+    encode_tournament();
+    seal_block();
+
+    append_raw(m_file, m_index.data(), m_index.size());
+    //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* const index = reinterpret_cast<const unsigned char*>(
+        m_index.data());
+    const Bout_log_format::Trailer trailer {
+        m_offset, m_index.size(), m_events,
+        log_checksum(index, m_index.size() * sizeof(m_index.front())),
+        Bout_log_format::magic};
+    append_raw(m_file, &trailer, 1);
+    m_file.close();
+  } catch ( ... ) {
+    m_failed = true;
+    throw;
+  }
+}
+
+Bout_log::Bout_log(const std::string& path)
+    : m_file {path}
+{
+  using Format = Bout_log_format;
+  Format::Header header {};
+  if ( m_file.size() < sizeof(header) + sizeof(m_trailer) ) {
+    throw std::runtime_error {"Truncated bout log " + path};
+  }
+  std::memcpy(&header, m_file.data(), sizeof(header));
+  std::memcpy(&m_trailer,
+              m_file.data() + m_file.size() - sizeof(m_trailer),
+              sizeof(m_trailer));
+
+  // bound every count before multiplying or adding, so a corrupt
+  // trailer or index cannot wrap around and pass the checks below
+  const std::uint64_t room {m_file.size() - sizeof(header)
+                            - sizeof(m_trailer)};
+  if ( header.magic != Format::magic || header.version != Format::version
+       || m_trailer.magic != Format::magic
+       || m_trailer.block_count > room / sizeof(Format::Block_entry) ) {
+    throw std::runtime_error {"Malformed bout log " + path};
+  }
+  const std::uint64_t index_bytes {m_trailer.block_count
+                                   * sizeof(Format::Block_entry)};
+  if ( m_trailer.index != sizeof(header) + room - index_bytes
+       || log_checksum(m_file.data() + m_trailer.index, index_bytes)
+              != m_trailer.index_checksum ) {
+    throw std::runtime_error {"Malformed bout log " + path};
+  }
+
+  m_index.resize(m_trailer.block_count);
+  if ( !m_index.empty() ) {
+    std::memcpy(m_index.data(), m_file.data() + m_trailer.index,
+                index_bytes);
+  }
+  for ( const Format::Block_entry& entry : m_index ) {
+    if ( entry.offset < sizeof(header) || entry.offset > m_trailer.index
+         || entry.bytes > m_trailer.index - entry.offset ) {
+      throw std::runtime_error {"Malformed bout log " + path};
+    }
+  }
+}
+
+void Bout_log::decode(const std::size_t block,
+                      std::vector<Bout_event>& out, const bool all,
+                      const std::uint64_t wanted) const
+{
+  const Bout_log_format::Block_entry& entry {m_index[block]};
+  const unsigned char* cursor {m_file.data() + entry.offset};
+  const unsigned char* const end {cursor + entry.bytes};
+  if ( log_checksum(cursor, entry.bytes) != entry.checksum ) {
+    throw std::runtime_error {"Corrupt bout log block "
+                              + std::to_string(block)};
+  }
+
+  // events are written straight into place; `out` is trimmed at the end
+  out.resize(all ? entry.events : 0);
+  std::size_t written {0};
+  std::vector<int> ids;
+  std::uint64_t tournament {entry.first_tournament};
+
+  while ( cursor != end ) {
+    tournament += get_varint(cursor);
+    const std::uint64_t count {get_varint(cursor)};
+    const std::uint64_t bytes {get_varint(cursor)};
+    if ( !all && tournament != wanted ) {
+      cursor += bytes;
+      continue;
+    }
+    if ( written + count > out.size() ) {
+      out.resize(written + count);
+    }
+
+    ids.resize(get_varint(cursor));
+    ids.front() = static_cast<int>(get_signed_varint(cursor));
+    for ( std::size_t index {1}; index != ids.size(); ++index ) {
+      ids[index] = ids[index - 1] + static_cast<int>(get_varint(cursor));
+    }
+
+    std::int64_t slot {-1};
+    for ( std::uint64_t event {0}; event != count; ++event ) {
+      Bout_event& decoded {out[written++]};
+      decoded.tournament = tournament;
+      slot += 1 + get_signed_varint(cursor);
+      decoded.slot   = static_cast<std::uint32_t>(slot);
+      decoded.winner = ids[get_varint(cursor)];
+      decoded.loser  = ids[get_varint(cursor)];
+      const std::uint64_t packed {get_varint(cursor)};
+      decoded.result = static_cast<Result_type>(
+          packed & ((1U << result_bits) - 1));
+      decoded.winner_score =
+          static_cast<std::int16_t>(zigzag_decode(packed >> result_bits));
+      decoded.loser_score = static_cast<std::int16_t>(
+          decoded.winner_score - get_signed_varint(cursor));
+      decoded.duration = static_cast<std::uint16_t>(get_varint(cursor));
+    }
+    if ( !all ) {
+      break;
+    }
+  }
+  out.resize(written);
+}
+
+void Bout_log::decode_block(const std::size_t block,
+                            std::vector<Bout_event>& out) const
+{
+  decode(block, out, true, 0);
+}
+
+auto Bout_log::tournament(const std::uint64_t tournament) const
+    -> std::vector<Bout_event>
+{
+  std::vector<Bout_event> events;
+  const auto block = std::partition_point(
+      m_index.begin(), m_index.end(),
+      [tournament](const Bout_log_format::Block_entry& entry) {
+        return entry.last_tournament < tournament;
+      });
+  if ( block != m_index.end() && block->first_tournament <= tournament ) {
+    decode(static_cast<std::size_t>(block - m_index.begin()), events,
+           false, tournament);
+  }
+  return events;
+}
@@ -0,0 +1,441 @@
+#include "bout_store.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "varint.h"
+
+namespace {
+
+constexpr std::array<char, 8> segment_magic {'W', 'R', 'B', 'O',
+                                             'U', 'T', 'S', '1'};
+constexpr std::uint32_t segment_version {1};
+constexpr const char* segment_prefix {"segment_"};
+constexpr const char* segment_suffix {".wbs"};
+
+auto write_error(const std::string& path, const int error)
+    -> std::runtime_error
+{
+  return std::runtime_error {"Cannot write bout segment " + path + ": "
+                             + std::strerror(error)};
+}
+
+/// Write `size` bytes to a new file at `path` and wait until they are
+/// on disk
+void write_synced(const std::string& path, const unsigned char* data,
+                  std::size_t size)
+{
+  const int descriptor {::open(
+      path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+  if ( descriptor < 0 ) {
+    throw write_error(path, errno);
+  }
+  while ( size != 0 ) {
+    const ::ssize_t wrote {::write(descriptor, data, size)};
+    if ( wrote < 0 && errno == EINTR ) {
+      continue;
+    }
+    if ( wrote <= 0 ) {
+      const int error {wrote == 0 ? EIO : errno};
+      ::close(descriptor);
+      throw write_error(path, error);
+    }
+    data += wrote;
+    size -= static_cast<std::size_t>(wrote);
+  }
+  if ( ::fsync(descriptor) != 0 ) {
+    const int error {errno};
+    ::close(descriptor);
+    throw write_error(path, error);
+  }
+  if ( ::close(descriptor) != 0 ) {
+    throw write_error(path, errno);
+  }
+}
+
+/// Make a rename within `directory` durable
+void sync_directory(const std::filesystem::path& directory)
+{
+  const std::string name {directory.empty() ? std::string {"."}
+                                            : directory.string()};
+  const int descriptor {::open(name.c_str(), O_RDONLY | O_CLOEXEC)};
+  if ( descriptor < 0 ) {
+    throw write_error(name, errno);
+  }
+  const int synced {::fsync(descriptor)};
+  const int error {errno};
+  ::close(descriptor);
+  if ( synced != 0 ) {
+    throw write_error(name, error);
+  }
+}
+
+template <typename T>
+void append_raw(std::vector<unsigned char>& out, const T* data,
+                const std::size_t count)
+{
+  const std::size_t offset {out.size()};
+  out.resize(offset + sizeof(T) * count);
+  if ( count != 0 ) {
+    std::memcpy(out.data() + offset, data, sizeof(T) * count);
+  }
+}
+
+} // namespace
+
+Bout_segment::Bout_segment(const std::string& path)
+    : m_file {path}
+{
+  if ( m_file.size() < sizeof(Header) ) {
+    throw std::runtime_error {"Truncated bout segment " + path};
+  }
+  std::memcpy(&m_header, m_file.data(), sizeof(Header));
+
+  if ( m_header.magic != segment_magic
+       || m_header.version != segment_version
+       || m_header.file_size != m_file.size()
+       || m_header.block_index
+                  + m_header.block_count * sizeof(Block_entry)
+              > m_header.directory
+       || m_header.directory + m_header.id_count * sizeof(Directory_entry)
+              > m_header.postings
+       || m_header.postings + 2ULL * m_header.row_count * sizeof(Posting)
+              > m_header.columns
+       || m_header.columns > m_header.file_size ) {
+    throw std::runtime_error {"Malformed bout segment " + path};
+  }
+}
+
+auto Bout_segment::blocks() const noexcept -> const Block_entry*
+{
+  //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<const Block_entry*>(m_file.data()
+                                              + m_header.block_index);
+}
+
+auto Bout_segment::directory() const noexcept -> const Directory_entry*
+{
+  //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<const Directory_entry*>(m_file.data()
+                                                  + m_header.directory);
+}
+
+auto Bout_segment::postings() const noexcept -> const Posting*
+{
+  //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<const Posting*>(m_file.data()
+                                          + m_header.postings);
+}
+
+void Bout_segment::write(const std::string& path,
+                         const std::vector<Bout>& pending)
+{
+  std::vector<Bout> bouts {pending};
+  std::stable_sort(bouts.begin(), bouts.end(),
+                   [](const Bout& lhs, const Bout& rhs) {
+                     return lhs.date < rhs.date;
+                   });
+
+  Header header {};
+  header.magic       = segment_magic;
+  header.version     = segment_version;
+  header.row_count   = static_cast<std::uint32_t>(bouts.size());
+  header.block_count = static_cast<std::uint32_t>(
+      (bouts.size() + block_rows - 1) / block_rows);
+  if ( !bouts.empty() ) {
+    header.first_date = bouts.front().date;
+    header.last_date  = bouts.back().date;
+  }
+
+  // columns, block by block
+  std::vector<unsigned char> columns;
+  std::vector<Block_entry> index(header.block_count);
+
+  for ( std::size_t block {0}; block != index.size(); ++block ) {
+    const std::size_t begin {block * block_rows};
+    const std::size_t end {std::min(bouts.size(), begin + block_rows)};
+    Block_entry& entry {index[block]};
+    entry.offset     = columns.size();
+    entry.rows       = static_cast<std::uint32_t>(end - begin);
+    entry.first_date = bouts[begin].date;
+
+    const auto mark_column = [&](const std::size_t column) {
+      entry.column[column] =
+          static_cast<std::uint32_t>(columns.size() - entry.offset);
+    };
+
+    mark_column(0);
+    std::int64_t previous {entry.first_date};
+    for ( std::size_t row {begin}; row != end; ++row ) {
+      put_signed_varint(columns, bouts[row].date - previous);
+      previous = bouts[row].date;
+    }
+
+    mark_column(1);
+    for ( std::size_t row {begin}; row != end; ++row ) {
+      put_signed_varint(columns, bouts[row].winner);
+    }
+
+    mark_column(2);
+    for ( std::size_t row {begin}; row != end; ++row ) {
+      put_signed_varint(columns, bouts[row].loser);
+    }
+
+    mark_column(3);
+    previous = 0;
+    for ( std::size_t row {begin}; row != end; ++row ) {
+      put_signed_varint(columns, bouts[row].tournament - previous);
+      previous = bouts[row].tournament;
+    }
+
+    mark_column(4);
+    for ( std::size_t row {begin}; row != end; ++row ) {
+      put_signed_varint(columns, bouts[row].winner_score);
+      put_signed_varint(columns, bouts[row].loser_score);
+    }
+
+    mark_column(5);
+    for ( std::size_t row {begin}; row != end; ++row ) {
+      columns.push_back(static_cast<unsigned char>(bouts[row].result));
+    }
+  }
+
+  // postings, two per bout, grouped by wrestler then date
+  std::vector<std::pair<std::int32_t, Posting>> keyed;
+  keyed.reserve(bouts.size() * 2);
+  for ( std::size_t row {0}; row != bouts.size(); ++row ) {
+    const Bout& bout {bouts[row]};
+    const auto row32 = static_cast<std::uint32_t>(row);
+    keyed.push_back(
+        {bout.winner, Posting {bout.date, row32, bout.loser, 1,
+                               bout.result, 0}});
+    keyed.push_back(
+        {bout.loser, Posting {bout.date, row32, bout.winner, 0,
+                              bout.result, 0}});
+  }
+  std::sort(keyed.begin(), keyed.end(),
+            [](const auto& lhs, const auto& rhs) {
+              if ( lhs.first != rhs.first ) {
+                return lhs.first < rhs.first;
+              }
+              if ( lhs.second.date != rhs.second.date ) {
+                return lhs.second.date < rhs.second.date;
+              }
+              return lhs.second.row < rhs.second.row;
+            });
+
+  std::vector<Directory_entry> directory;
+  std::vector<Posting> postings;
+  postings.reserve(keyed.size());
+  for ( const auto& [id, posting] : keyed ) {
+    if ( directory.empty() || directory.back().id != id ) {
+      directory.push_back({id, 0, postings.size()});
+    }
+    ++directory.back().count;
+    postings.push_back(posting);
+  }
+  header.id_count = static_cast<std::uint32_t>(directory.size());
+
+  header.block_index = sizeof(Header);
+  header.directory =
+      header.block_index + index.size() * sizeof(Block_entry);
+  header.postings =
+      header.directory + directory.size() * sizeof(Directory_entry);
+  header.columns   = header.postings + postings.size() * sizeof(Posting);
+  header.file_size = header.columns + columns.size();
+
+  std::vector<unsigned char> file;
+  file.reserve(header.file_size);
+  append_raw(file, &header, 1);
+  append_raw(file, index.data(), index.size());
+  append_raw(file, directory.data(), directory.size());
+  append_raw(file, postings.data(), postings.size());
+  append_raw(file, columns.data(), columns.size());
+
+  // write aside, sync and rename so a segment is never seen
+  // half-written, even after a crash
+  const std::string staging {path + ".tmp"};
+  try {
+    write_synced(staging, file.data(), file.size());
+  } catch ( ... ) {
+    std::error_code ignored;
+    std::filesystem::remove(staging, ignored);
+    throw;
+  }
+  std::filesystem::rename(staging, path);
+  sync_directory(std::filesystem::path {path}.parent_path());
+}
+
+void Bout_segment::decode_block(const std::size_t block,
+                                Bout* const out) const noexcept
+{
+  const Block_entry& entry {blocks()[block]};
+  const unsigned char* const base {m_file.data() + m_header.columns
+                                   + entry.offset};
+
+  const unsigned char* cursor {base + entry.column[0]};
+  std::int64_t previous {entry.first_date};
+  for ( std::size_t row {0}; row != entry.rows; ++row ) {
+    previous += get_signed_varint(cursor);
+    out[row].date = static_cast<int>(previous);
+  }
+
+  cursor = base + entry.column[1];
+  for ( std::size_t row {0}; row != entry.rows; ++row ) {
+    out[row].winner = static_cast<int>(get_signed_varint(cursor));
+  }
+
+  cursor = base + entry.column[2];
+  for ( std::size_t row {0}; row != entry.rows; ++row ) {
+    out[row].loser = static_cast<int>(get_signed_varint(cursor));
+  }
+
+  cursor   = base + entry.column[3];
+  previous = 0;
+  for ( std::size_t row {0}; row != entry.rows; ++row ) {
+    previous += get_signed_varint(cursor);
+    out[row].tournament = static_cast<int>(previous);
+  }
+
+  cursor = base + entry.column[4];
+  for ( std::size_t row {0}; row != entry.rows; ++row ) {
+    out[row].winner_score =
+        static_cast<std::int16_t>(get_signed_varint(cursor));
+    out[row].loser_score =
+        static_cast<std::int16_t>(get_signed_varint(cursor));
+  }
+
+  cursor = base + entry.column[5];
+  for ( std::size_t row {0}; row != entry.rows; ++row ) {
+    out[row].result = static_cast<Result_type>(cursor[row]);
+  }
+}
+
+auto Bout_segment::bout(const std::size_t row) const -> Bout
+{
+  if ( row >= m_header.row_count ) {
+    throw std::out_of_range {"Bout segment row out of range"};
+  }
+  std::array<Bout, block_rows> decoded {};
+  decode_block(row / block_rows, decoded.data());
+  return decoded[row % block_rows];
+}
+
+auto Bout_segment::postings_of(const int id) const noexcept
+    -> Span<const Posting>
+{
+  const Directory_entry* const first {directory()};
+  const Directory_entry* const last {first + m_header.id_count};
+  const Directory_entry* const found {std::lower_bound(
+      first, last, id, [](const Directory_entry& entry, const int key) {
+        return entry.id < key;
+      })};
+
+  if ( found == last || found->id != id ) {
+    return {};
+  }
+  return {postings() + found->first, found->count};
+}
+
+auto Bout_segment::postings_of(const int id, const Season season) const
+    noexcept -> Span<const Posting>
+{
+  const Span<const Posting> all {postings_of(id)};
+  const Posting* const first {std::lower_bound(
+      all.begin(), all.end(), season.first_day,
+      [](const Posting& posting, const int day) {
+        return posting.date < day;
+      })};
+  const Posting* const last {std::upper_bound(
+      first, all.end(), season.last_day,
+      [](const int day, const Posting& posting) {
+        return day < posting.date;
+      })};
+  return {first, static_cast<std::size_t>(last - first)};
+}
+
+Bout_store::Bout_store(std::string directory)
+    : m_directory {std::move(directory)}
+{
+  std::filesystem::create_directories(m_directory);
+
+  std::vector<std::string> paths;
+  for ( const auto& file :
+        std::filesystem::directory_iterator {m_directory} ) {
+    const std::string name {file.path().filename().string()};
+    if ( name.rfind(segment_prefix, 0) == 0
+         && file.path().extension() == segment_suffix ) {
+      paths.push_back(file.path().string());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+
+  m_segments.reserve(paths.size());
+  for ( const auto& path : paths ) {
+    m_segments.emplace_back(path);
+    const std::string name {
+        std::filesystem::path {path}.filename().string()};
+    m_next_segment = std::max<std::size_t>(
+        m_next_segment,
+        std::strtoull(name.c_str() + std::strlen(segment_prefix), nullptr,
+                      10)
+            + 1);
+  }
+}
+
+void Bout_store::flush()
+{
+  if ( m_pending.empty() ) {
+    return;
+  }
+
+  std::array<char, 32> name {};
+  std::snprintf(name.data(), name.size(), "%s%08zu%s", segment_prefix,
+                m_next_segment, segment_suffix);
+  const std::string path {
+      (std::filesystem::path {m_directory} / name.data()).string()};
+
+  // pending bouts are only dropped once their segment is safely written
+  // and mapped; a name once written is never handed out again
+  m_segments.reserve(m_segments.size() + 1);
+  Bout_segment::write(path, m_pending);
+  ++m_next_segment;
+  try {
+    m_segments.emplace_back(path);
+  } catch ( ... ) {
+    // the bouts stay pending, so the file would only duplicate them
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+    throw;
+  }
+  m_pending.clear();
+}
+
+auto Bout_store::bouts_of(const int id, const Season season) const
+    -> std::vector<Posting_run>
+{
+  std::vector<Posting_run> runs;
+  for ( std::size_t segment {0}; segment != m_segments.size();
+        ++segment ) {
+    const Bout_segment& sealed {m_segments[segment]};
+    if ( sealed.rows() == 0 || sealed.last_date() < season.first_day
+         || sealed.first_date() > season.last_day ) {
+      continue;
+    }
+    const Span<const Posting> postings {sealed.postings_of(id, season)};
+    if ( !postings.empty() ) {
+      runs.push_back({segment, postings});
+    }
+  }
+  return runs;
+}
@@ -0,0 +1,382 @@
+#include "bracket_placement.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "bracket.h"
+#include "parallel.h"
+#include "random.h"
+
+namespace {
+
+/// Outweighs any achievable region penalty
+constexpr double conflict_weight {1e9};
+
+/// Entrants mapped onto dense team and region indices
+struct Draw_input {
+  const std::vector<Entrant>* entrants;
+  std::vector<int> team;
+  std::vector<int> region;
+  std::size_t teams;
+  std::size_t regions;
+};
+
+auto dense_index(const std::vector<Entrant>& entrants,
+                 int Entrant::*field, std::size_t& distinct)
+    -> std::vector<int>
+{
+  std::map<int, int> index;
+  std::vector<int> dense(entrants.size(), -1);
+  for ( std::size_t entrant {0}; entrant != entrants.size(); ++entrant ) {
+    const int value {entrants[entrant].*field};
+    if ( value >= 0 ) {
+      const auto next = static_cast<int>(index.size());
+      dense[entrant]  = index.emplace(value, next).first->second;
+    }
+  }
+  distinct = index.size();
+  return dense;
+}
+
+/**
+ * A (partial) draw together with the block occupancy counts that make
+ * every placement and removal O(rounds).
+ */
+class Draw
+{
+private:
+
+  const Draw_input& m_input;
+  const Placement_rules& m_rules;
+  std::size_t m_rounds;
+  std::size_t m_separation_level;
+  std::vector<std::size_t> m_lines;
+  std::vector<int> m_team_count;
+  /// Region counts for levels 1 through `m_rounds`, level by level
+  std::vector<int> m_region_count;
+  std::vector<std::size_t> m_region_offset;
+  std::vector<double> m_level_weight;
+  int m_conflicts {0};
+  double m_penalty {0.0};
+
+public:
+
+  Draw(const Draw_input& input, const Placement_rules& rules,
+       const std::size_t size)
+      : m_input {input}
+      , m_rules {rules}
+      , m_rounds {bracket_rounds(size)}
+      , m_separation_level {static_cast<std::size_t>(std::clamp(
+            rules.separation_round - 1, 0, static_cast<int>(m_rounds)))}
+      , m_lines(size, Bracket_placement::bye)
+      , m_team_count((size >> m_separation_level) * input.teams, 0)
+      , m_region_count {}
+      , m_region_offset(m_rounds + 1, 0)
+      , m_level_weight(m_rounds + 1, 0.0)
+  {
+    for ( std::size_t level {1}; level <= m_rounds; ++level ) {
+      m_region_offset[level] = m_region_count.size();
+      m_region_count.resize(m_region_count.size()
+                            + (size >> level) * input.regions);
+      // a pair first able to meet in round r costs 2^(rounds - r) in
+      // total over the levels that contain it
+      m_level_weight[level] =
+          level == m_rounds
+              ? 1.0
+              : static_cast<double>(std::size_t {1}
+                                    << (m_rounds - level - 1));
+    }
+  }
+
+  [[nodiscard]] auto lines() const noexcept
+      -> const std::vector<std::size_t>&
+  {
+    return m_lines;
+  }
+
+  [[nodiscard]] auto conflicts() const noexcept -> int
+  {
+    return m_conflicts;
+  }
+
+  [[nodiscard]] auto penalty() const noexcept -> double
+  {
+    return m_penalty;
+  }
+
+  [[nodiscard]] auto cost() const noexcept -> double
+  {
+    return conflict_weight * m_conflicts
+         + m_rules.region_weight * m_penalty;
+  }
+
+  [[nodiscard]] auto separates_teams() const noexcept -> bool
+  {
+    return m_separation_level != 0;
+  }
+
+  /// Would `entrant` on `line` share a separation block with a teammate?
+  [[nodiscard]] auto clashes(const std::size_t line,
+                             const std::size_t entrant) const noexcept
+      -> bool
+  {
+    const int team {m_input.team[entrant]};
+    return separates_teams() && team >= 0
+        && m_team_count[(line >> m_separation_level) * m_input.teams
+                        + static_cast<std::size_t>(team)]
+               != 0;
+  }
+
+  /// Cost `entrant` would add on `line`
+  [[nodiscard]] auto added_cost(const std::size_t line,
+                                const std::size_t entrant) const noexcept
+      -> double
+  {
+    double cost {clashes(line, entrant) ? conflict_weight : 0.0};
+    const int region {m_input.region[entrant]};
+    if ( region >= 0 ) {
+      for ( std::size_t level {1}; level <= m_rounds; ++level ) {
+        cost += m_rules.region_weight * m_level_weight[level]
+              * m_region_count[region_cell(level, line, region)];
+      }
+    }
+    return cost;
+  }
+
+  void place(const std::size_t line, const std::size_t entrant) noexcept
+  {
+    m_lines[line] = entrant;
+    adjust(line, entrant, 1);
+  }
+
+  void remove(const std::size_t line) noexcept
+  {
+    adjust(line, m_lines[line], -1);
+    m_lines[line] = Bracket_placement::bye;
+  }
+
+  void swap(const std::size_t lhs, const std::size_t rhs) noexcept
+  {
+    const std::size_t lhs_entrant {m_lines[lhs]};
+    const std::size_t rhs_entrant {m_lines[rhs]};
+    remove(lhs);
+    remove(rhs);
+    place(lhs, rhs_entrant);
+    place(rhs, lhs_entrant);
+  }
+
+private:
+
+  [[nodiscard]] auto region_cell(const std::size_t level,
+                                 const std::size_t line,
+                                 const int region) const noexcept
+      -> std::size_t
+  {
+    return m_region_offset[level] + (line >> level) * m_input.regions
+         + static_cast<std::size_t>(region);
+  }
+
+  void adjust(const std::size_t line, const std::size_t entrant,
+              const int step) noexcept
+  {
+    const int team {m_input.team[entrant]};
+    if ( separates_teams() && team >= 0 ) {
+      int& count {m_team_count[(line >> m_separation_level)
+                                   * m_input.teams
+                               + static_cast<std::size_t>(team)]};
+      if ( step < 0 ) {
+        count += step;
+      }
+      m_conflicts += step * count;
+      if ( step > 0 ) {
+        count += step;
+      }
+    }
+
+    const int region {m_input.region[entrant]};
+    if ( region >= 0 ) {
+      for ( std::size_t level {1}; level <= m_rounds; ++level ) {
+        int& count {m_region_count[region_cell(level, line, region)]};
+        if ( step < 0 ) {
+          count += step;
+        }
+        m_penalty += step * m_level_weight[level] * count;
+        if ( step > 0 ) {
+          count += step;
+        }
+      }
+    }
+  }
+};
+
+/// Choose uniformly among candidates tied for the best score
+class Tie_breaker
+{
+private:
+
+  Rng& m_rng;
+  std::uint32_t m_ties {0};
+
+public:
+
+  explicit Tie_breaker(Rng& rng)
+      : m_rng {rng}
+  {}
+
+  /// Call for each candidate that ties the best; true if it should win
+  auto take() noexcept -> bool
+  {
+    ++m_ties;
+    return m_rng.below(m_ties) == 0;
+  }
+
+  void reset() noexcept
+  {
+    m_ties = 0;
+  }
+};
+
+auto search(const Draw_input& input, const Placement_rules& rules,
+            const std::size_t size, const std::uint64_t stream) -> Draw
+{
+  const std::vector<Entrant>& entrants {*input.entrants};
+  const std::vector<std::size_t> seed_of_line {seed_order(size)};
+  const std::size_t count {entrants.size()};
+
+  Rng rng {rules.seed, stream};
+  Draw draw {input, rules, size};
+
+  // seeds are fixed; later duplicates and out-of-range seeds are unseeded
+  std::vector<std::size_t> line_of_seed(size + 1, Bracket_placement::bye);
+  for ( std::size_t line {0}; line != size; ++line ) {
+    line_of_seed[seed_of_line[line]] = line;
+  }
+
+  std::vector<bool> taken(size, false);
+  std::vector<std::size_t> unseeded;
+  for ( std::size_t entrant {0}; entrant != count; ++entrant ) {
+    const int seed {entrants[entrant].seed};
+    const std::size_t line {
+        seed >= 1 && static_cast<std::size_t>(seed) <= count
+            ? line_of_seed[static_cast<std::size_t>(seed)]
+            : Bracket_placement::bye};
+    if ( line != Bracket_placement::bye && !taken[line] ) {
+      taken[line] = true;
+      draw.place(line, entrant);
+    } else {
+      unseeded.push_back(entrant);
+    }
+  }
+
+  // open lines exclude byes, which sit where seeds past `count` would go
+  std::vector<std::size_t> open;
+  for ( std::size_t line {0}; line != size; ++line ) {
+    if ( !taken[line] && seed_of_line[line] <= count ) {
+      open.push_back(line);
+    }
+  }
+  const std::vector<std::size_t> swappable {open};
+
+  // greedy construction with forward checking: most constrained entrant
+  // first, onto its cheapest line
+  Tie_breaker ties {rng};
+  while ( !unseeded.empty() ) {
+    std::size_t chosen {0};
+    std::size_t fewest {~std::size_t {0}};
+    ties.reset();
+    for ( std::size_t index {0}; index != unseeded.size(); ++index ) {
+      std::size_t options {0};
+      for ( const std::size_t line : open ) {
+        options += draw.clashes(line, unseeded[index]) ? 0U : 1U;
+      }
+      if ( options < fewest ) {
+        fewest = options;
+        chosen = index;
+        ties.reset();
+        ties.take();
+      } else if ( options == fewest && ties.take() ) {
+        chosen = index;
+      }
+    }
+    const std::size_t entrant {unseeded[chosen]};
+    unseeded[chosen] = unseeded.back();
+    unseeded.pop_back();
+
+    std::size_t best {0};
+    double best_cost {0.0};
+    ties.reset();
+    for ( std::size_t index {0}; index != open.size(); ++index ) {
+      const double cost {draw.added_cost(open[index], entrant)};
+      if ( index == 0 || cost < best_cost ) {
+        best      = index;
+        best_cost = cost;
+        ties.reset();
+        ties.take();
+      } else if ( !(cost > best_cost) && ties.take() ) {
+        best = index;
+      }
+    }
+    draw.place(open[best], entrant);
+    open[best] = open.back();
+    open.pop_back();
+  }
+
+  // local search over swaps of unseeded entrants, keeping sideways moves
+  if ( swappable.size() >= 2 ) {
+    const auto choices = static_cast<std::uint32_t>(swappable.size());
+    for ( std::size_t iteration {0};
+          iteration != rules.iterations && draw.cost() > 0.0;
+          ++iteration ) {
+      const std::size_t lhs {swappable[rng.below(choices)]};
+      const std::size_t rhs {swappable[rng.below(choices)]};
+      if ( lhs == rhs ) {
+        continue;
+      }
+      const double before {draw.cost()};
+      draw.swap(lhs, rhs);
+      if ( draw.cost() > before ) {
+        draw.swap(lhs, rhs);
+      }
+    }
+  }
+
+  return draw;
+}
+
+} // namespace
+
+auto place_bracket(const std::vector<Entrant>& entrants,
+                   const Placement_rules& rules) -> Bracket_placement
+{
+  Draw_input input {&entrants, {}, {}, 0, 0};
+  input.team   = dense_index(entrants, &Entrant::team, input.teams);
+  input.region = dense_index(entrants, &Entrant::region, input.regions);
+
+  const std::size_t size {bracket_size(entrants.size())};
+  const std::size_t threads {rules.threads == 0 ? hardware_threads()
+                                                : rules.threads};
+  const std::size_t restarts {std::max<std::size_t>(1, rules.restarts)};
+
+  std::vector<std::vector<std::size_t>> lines(restarts);
+  std::vector<Placement_quality> quality(restarts);
+  std::vector<double> cost(restarts);
+
+  parallel_for(
+      restarts,
+      [&](std::size_t, const std::size_t begin, const std::size_t end) {
+        for ( std::size_t restart {begin}; restart != end; ++restart ) {
+          const Draw draw {search(input, rules, size, restart)};
+          lines[restart]   = draw.lines();
+          quality[restart] = {draw.conflicts(), draw.penalty(), restarts};
+          cost[restart]    = draw.cost();
+        }
+      },
+      threads);
+
+  // earliest restart wins ties so results do not depend on scheduling
+  const std::size_t best {static_cast<std::size_t>(
+      std::min_element(cost.begin(), cost.end()) - cost.begin())};
+
+  return {std::move(lines[best]), quality[best]};
+}
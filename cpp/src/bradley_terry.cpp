@@ -0,0 +1,136 @@
+#include "bradley_terry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "parallel.h"
+
+Win_matrix::Win_matrix(const std::vector<Bout>& bouts,
+                       const Slot_map& slots, const std::size_t slot_count)
+    : m_row_begin(slot_count + 1, 0)
+    , m_wins(slot_count, 0)
+{
+  // counting pass, then scatter both directions of every bout
+  std::vector<std::pair<std::size_t, std::size_t>> resolved;
+  resolved.reserve(bouts.size());
+
+  for ( const auto& bout : bouts ) {
+    const int winner {slots.slot(bout.winner)};
+    const int loser {slots.slot(bout.loser)};
+    if ( winner == Slot_map::npos || loser == Slot_map::npos
+         || winner == loser ) {
+      continue;
+    }
+    const auto w = static_cast<std::size_t>(winner);
+    const auto l = static_cast<std::size_t>(loser);
+    if ( w >= slot_count || l >= slot_count ) {
+      continue;
+    }
+    resolved.emplace_back(w, l);
+    ++m_wins[w];
+    ++m_row_begin[w + 1];
+    ++m_row_begin[l + 1];
+  }
+
+  for ( std::size_t row {0}; row != slot_count; ++row ) {
+    m_row_begin[row + 1] += m_row_begin[row];
+  }
+
+  std::vector<std::uint32_t> opponents(m_row_begin.back());
+  std::vector<std::size_t> cursor(m_row_begin.begin(),
+                                  m_row_begin.end() - 1);
+  for ( const auto& [winner, loser] : resolved ) {
+    opponents[cursor[winner]++] = static_cast<std::uint32_t>(loser);
+    opponents[cursor[loser]++]  = static_cast<std::uint32_t>(winner);
+  }
+
+  // sort each row and collapse repeated opponents into game counts
+  m_column.reserve(opponents.size());
+  m_games.reserve(opponents.size());
+  std::size_t write_begin {0};
+
+  for ( std::size_t row {0}; row != slot_count; ++row ) {
+    const auto first = opponents.begin()
+                     + static_cast<std::ptrdiff_t>(m_row_begin[row]);
+    const auto last = opponents.begin()
+                    + static_cast<std::ptrdiff_t>(m_row_begin[row + 1]);
+    std::sort(first, last);
+
+    for ( auto it = first; it != last; ++it ) {
+      if ( m_column.size() != write_begin && m_column.back() == *it ) {
+        ++m_games.back();
+      } else {
+        m_column.push_back(*it);
+        m_games.push_back(1);
+      }
+    }
+
+    m_row_begin[row] = write_begin;
+    write_begin      = m_column.size();
+  }
+  m_row_begin[slot_count] = write_begin;
+
+  m_column.shrink_to_fit();
+  m_games.shrink_to_fit();
+}
+
+auto fit_bradley_terry(const Win_matrix& matrix,
+                       const Bradley_terry_params& params,
+                       const std::vector<double>& warm_start)
+    -> Bradley_terry_fit
+{
+  const std::size_t rows {matrix.rows()};
+
+  // wrestlers added since the warm start begin at the prior
+  Bradley_terry_fit fit;
+  fit.strength.assign(rows, 1.0);
+  std::copy_n(warm_start.begin(), std::min(rows, warm_start.size()),
+              fit.strength.begin());
+  std::vector<double> next(rows);
+
+  const std::size_t threads {params.threads == 0 ? hardware_threads()
+                                                 : params.threads};
+  std::vector<double> chunk_change(threads);
+  const double half_prior {params.prior_games / 2.0};
+
+  while ( fit.iterations != params.max_iterations ) {
+    const std::vector<double>& current {fit.strength};
+
+    parallel_for(
+        rows,
+        [&](const std::size_t chunk, const std::size_t begin,
+            const std::size_t end) {
+          double change {0.0};
+          for ( std::size_t row {begin}; row != end; ++row ) {
+            const double own {current[row]};
+            double denominator {params.prior_games / (own + 1.0)};
+            for ( std::size_t entry {matrix.row_begin(row)};
+                  entry != matrix.row_end(row); ++entry ) {
+              denominator += matrix.games(entry)
+                           / (own + current[matrix.column(entry)]);
+            }
+            const double updated {(matrix.wins(row) + half_prior)
+                                  / denominator};
+            change = std::max(change, std::abs(updated - own) / own);
+            next[row] = updated;
+          }
+          chunk_change[chunk] = change;
+        },
+        threads);
+
+    fit.strength.swap(next);
+    ++fit.iterations;
+
+    fit.max_change =
+        *std::max_element(chunk_change.begin(), chunk_change.end());
+    std::fill(chunk_change.begin(), chunk_change.end(), 0.0);
+
+    if ( fit.max_change < params.tolerance ) {
+      fit.converged = true;
+      break;
+    }
+  }
+
+  return fit;
+}
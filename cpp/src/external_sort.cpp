@@ -0,0 +1,529 @@
+#include "external_sort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "async_file.h"
+#include "parallel.h"
+#include "roster_file.h"
+
+namespace {
+
+constexpr std::size_t record_bytes {sizeof(Roster_record)};
+constexpr std::size_t header_bytes {sizeof(Roster_file_format::Header)};
+/// Runs merged at once, whatever the memory, to stay within the
+/// descriptor limit
+constexpr std::size_t max_fan_in {512};
+
+auto system_error(const std::string& what, const int error)
+    -> std::runtime_error
+{
+  return std::runtime_error {what + ": " + std::strerror(error)};
+}
+
+/// Best first: higher ability, then lower id
+auto ranks_first(const Roster_record& lhs,
+                 const Roster_record& rhs) noexcept -> bool
+{
+  return lhs.ability != rhs.ability ? lhs.ability > rhs.ability
+                                    : lhs.id < rhs.id;
+}
+
+/// A file open for positioned reads
+class Input_file
+{
+private:
+
+  std::string m_path;
+  int m_descriptor {-1};
+  std::uint64_t m_size {0};
+
+public:
+
+  explicit Input_file(const std::string& path)
+      : m_path {path}
+      , m_descriptor {::open(path.c_str(), O_RDONLY | O_CLOEXEC)}
+  {
+    struct ::stat status {};
+    if ( m_descriptor < 0 || ::fstat(m_descriptor, &status) != 0 ) {
+      const int error {errno};
+      if ( m_descriptor >= 0 ) {
+        ::close(m_descriptor);
+      }
+      throw system_error("Cannot read " + path, error);
+    }
+    m_size = static_cast<std::uint64_t>(status.st_size);
+  }
+
+  Input_file(const Input_file&) = delete;
+  auto operator=(const Input_file&) -> Input_file& = delete;
+  Input_file(Input_file&&)                         = delete;
+  auto operator=(Input_file&&) -> Input_file&      = delete;
+
+  ~Input_file()
+  {
+    ::close(m_descriptor);
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::uint64_t
+  {
+    return m_size;
+  }
+
+  /// Exactly `size` bytes at `offset`
+  void read(void* const data, const std::size_t size,
+            const std::uint64_t offset) const
+  {
+    auto* const bytes = static_cast<unsigned char*>(data);
+    std::size_t done {0};
+    while ( done != size ) {
+      const ::ssize_t got {
+          ::pread(m_descriptor, bytes + done, size - done,
+                  static_cast<::off_t>(offset + done))};
+      if ( got < 0 && errno == EINTR ) {
+        continue;
+      }
+      if ( got <= 0 ) {
+        throw system_error("Cannot read " + m_path,
+                           got == 0 ? EIO : errno);
+      }
+      done += static_cast<std::size_t>(got);
+    }
+  }
+
+  /// Ask the kernel to start reading `[offset, offset + size)` now
+  void read_ahead(const std::uint64_t offset,
+                  const std::uint64_t size) const noexcept
+  {
+    if ( size != 0 ) {
+      ::posix_fadvise(m_descriptor, static_cast<::off_t>(offset),
+                      static_cast<::off_t>(size), POSIX_FADV_WILLNEED);
+    }
+  }
+};
+
+/// Records of one run segment, a block at a time
+class Segment_reader
+{
+private:
+
+  const Input_file* m_file;
+  std::uint64_t m_offset;
+  std::uint64_t m_end;
+  std::size_t m_block_records;
+  std::vector<Roster_record> m_block {};
+  std::size_t m_position {0};
+
+  void refill()
+  {
+    const std::uint64_t left {(m_end - m_offset) / record_bytes};
+    m_block.resize(static_cast<std::size_t>(
+        std::min<std::uint64_t>(m_block_records, left)));
+    m_position = 0;
+    if ( m_block.empty() ) {
+      return;
+    }
+    const std::size_t bytes {m_block.size() * record_bytes};
+    m_file->read(m_block.data(), bytes, m_offset);
+    m_offset += bytes;
+    m_file->read_ahead(m_offset, std::min<std::uint64_t>(
+                                     m_end - m_offset,
+                                     m_block_records * record_bytes));
+  }
+
+public:
+
+  Segment_reader(const Input_file& file, const std::uint64_t begin,
+                 const std::uint64_t end, const std::size_t block_records)
+      : m_file {&file}
+      , m_offset {begin}
+      , m_end {end}
+      , m_block_records {block_records}
+  {
+    refill();
+  }
+
+  Segment_reader(const Segment_reader&)                    = default;
+  auto operator=(const Segment_reader&) -> Segment_reader& = default;
+  Segment_reader(Segment_reader&&) noexcept                = default;
+  auto operator=(Segment_reader&&) noexcept -> Segment_reader& = default;
+  ~Segment_reader()                                        = default;
+
+  [[nodiscard]] auto done() const noexcept -> bool
+  {
+    return m_position == m_block.size();
+  }
+
+  [[nodiscard]] auto head() const noexcept -> const Roster_record&
+  {
+    return m_block[m_position];
+  }
+
+  void advance()
+  {
+    if ( ++m_position == m_block.size() ) {
+      refill();
+    }
+  }
+};
+
+/**
+ * Tournament over the heads of k readers. Each internal node keeps the
+ * loser of the match played there and node 0 the overall winner, so
+ * replacing the winner's head replays only its path to the root:
+ * log2(k) comparisons per record.
+ */
+class Loser_tree
+{
+private:
+
+  std::vector<Segment_reader>& m_readers;
+  std::vector<std::size_t> m_nodes;
+
+  /// Exhausted readers lose to everything; ties go to the earlier run
+  [[nodiscard]] auto beats(const std::size_t lhs,
+                           const std::size_t rhs) const noexcept -> bool
+  {
+    if ( m_readers[lhs].done() || m_readers[rhs].done() ) {
+      return !m_readers[lhs].done();
+    }
+    const Roster_record& left {m_readers[lhs].head()};
+    const Roster_record& right {m_readers[rhs].head()};
+    return ranks_first(left, right)
+        || (!ranks_first(right, left) && lhs < rhs);
+  }
+
+public:
+
+  explicit Loser_tree(std::vector<Segment_reader>& readers)
+      : m_readers {readers}
+      , m_nodes(readers.size())
+  {
+    const std::size_t leaves {readers.size()};
+    std::vector<std::size_t> winners(2 * leaves);
+    for ( std::size_t leaf {0}; leaf != leaves; ++leaf ) {
+      winners[leaves + leaf] = leaf;
+    }
+    for ( std::size_t node {leaves - 1}; node != 0; --node ) {
+      const std::size_t left {winners[2 * node]};
+      const std::size_t right {winners[2 * node + 1]};
+      const bool left_wins {beats(left, right)};
+      winners[node] = left_wins ? left : right;
+      m_nodes[node] = left_wins ? right : left;
+    }
+    m_nodes[0] = winners[1];
+  }
+
+  [[nodiscard]] auto winner() const noexcept -> std::size_t
+  {
+    return m_nodes[0];
+  }
+
+  /// Replay the winner's path after its reader advanced
+  void replay()
+  {
+    std::size_t winner {m_nodes[0]};
+    for ( std::size_t node {(winner + m_nodes.size()) / 2}; node != 0;
+          node /= 2 ) {
+      if ( beats(m_nodes[node], winner) ) {
+        std::swap(m_nodes[node], winner);
+      }
+    }
+    m_nodes[0] = winner;
+  }
+};
+
+/// A sorted run: per-partition segments, bounded by byte offsets
+struct Run {
+  std::string path {};
+  std::vector<std::uint64_t> bounds {};
+};
+
+/// Names scratch runs and removes whichever are left on destruction
+class Scratch_runs
+{
+private:
+
+  std::filesystem::path m_directory;
+  std::vector<std::string> m_paths {};
+
+public:
+
+  explicit Scratch_runs(const std::string& directory)
+      : m_directory {directory.empty()
+                         ? std::filesystem::temp_directory_path()
+                         : std::filesystem::path {directory}}
+  {}
+
+  Scratch_runs(const Scratch_runs&) = delete;
+  auto operator=(const Scratch_runs&) -> Scratch_runs& = delete;
+  Scratch_runs(Scratch_runs&&)                         = delete;
+  auto operator=(Scratch_runs&&) -> Scratch_runs&      = delete;
+
+  ~Scratch_runs()
+  {
+    for ( const std::string& path : m_paths ) {
+      std::error_code ignored;
+      std::filesystem::remove(path, ignored);
+    }
+  }
+
+  [[nodiscard]] auto create() -> std::string
+  {
+    static std::atomic<std::uint64_t> next {0};
+    m_paths.push_back(
+        (m_directory
+         / ("roster-run-" + std::to_string(::getpid()) + "-"
+            + std::to_string(next++)))
+            .string());
+    return m_paths.back();
+  }
+
+  void remove(const std::string& path)
+  {
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+    m_paths.erase(std::find(m_paths.begin(), m_paths.end(), path));
+  }
+};
+
+void append(Async_file_writer& file, const void* const data,
+            const std::size_t size)
+{
+  file.append(static_cast<const unsigned char*>(data), size);
+}
+
+/// Merge segment `partition` of `runs` onto `out`; returns the records
+/// written
+auto merge_segment(const std::vector<const Run*>& runs,
+                   const std::deque<Input_file>& files,
+                   const std::size_t partition,
+                   const std::size_t block_records,
+                   std::vector<Roster_record>& staged,
+                   Async_file_writer& out) -> std::uint64_t
+{
+  if ( runs.empty() ) {
+    return 0;
+  }
+  std::vector<Segment_reader> readers;
+  readers.reserve(runs.size());
+  for ( std::size_t run {0}; run != runs.size(); ++run ) {
+    readers.emplace_back(files[run], runs[run]->bounds[partition],
+                         runs[run]->bounds[partition + 1], block_records);
+  }
+  Loser_tree tree {readers};
+
+  std::uint64_t written {0};
+  staged.clear();
+  for ( ;; ) {
+    Segment_reader& best {readers[tree.winner()]};
+    if ( best.done() ) {
+      break;
+    }
+    staged.push_back(best.head());
+    if ( staged.size() == staged.capacity() ) {
+      append(out, staged.data(), staged.size() * record_bytes);
+      written += staged.size();
+      staged.clear();
+    }
+    best.advance();
+    tree.replay();
+  }
+  append(out, staged.data(), staged.size() * record_bytes);
+  return written + staged.size();
+}
+
+/// Check the header of roster `file` and count its records
+auto roster_records(const Input_file& file, const std::string& path)
+    -> std::uint64_t
+{
+  Roster_file_format::Header header {};
+  if ( file.size() < header_bytes ) {
+    throw std::runtime_error {"Truncated roster " + path};
+  }
+  file.read(&header, header_bytes, 0);
+  if ( header.magic != Roster_file_format::magic
+       || header.version != Roster_file_format::version
+       || header.record_bytes != record_bytes
+       || (file.size() - header_bytes) % record_bytes != 0 ) {
+    throw std::runtime_error {"Malformed roster " + path};
+  }
+  return (file.size() - header_bytes) / record_bytes;
+}
+
+} // namespace
+
+auto partition_roster(const std::string& input,
+                      const Weight_classes& classes,
+                      const std::string& prefix,
+                      const External_sort_params& params)
+    -> Partition_report
+{
+  if ( params.block_bytes < record_bytes
+       || params.memory_bytes < 2 * params.block_bytes ) {
+    throw std::invalid_argument {
+        "External sort needs room for two blocks of records"};
+  }
+  if ( classes.size() >= 255 ) {
+    throw std::invalid_argument {"Too many weight classes to partition"};
+  }
+  const std::size_t partitions {classes.size() + 1};
+  const std::size_t block_records {params.block_bytes / record_bytes};
+  const std::size_t fan_in {std::min(
+      max_fan_in, params.memory_bytes / params.block_bytes)};
+  // records, their sorted copy and their partitions
+  const std::size_t run_records {params.memory_bytes
+                                 / (2 * record_bytes + 1)};
+
+  const Input_file source {input};
+  const std::uint64_t records {roster_records(source, input)};
+  Scratch_runs scratch {params.scratch_directory};
+  Partition_report report;
+
+  // runs: bucket each chunk by class with a counting sort, then sort
+  // every bucket on its own
+  std::deque<Run> runs;
+  {
+    std::vector<Roster_record> chunk;
+    std::vector<Roster_record> sorted;
+    std::vector<std::uint8_t> partition_of;
+    for ( std::uint64_t first {0}; first < records;
+          first += run_records ) {
+      const auto rows = static_cast<std::size_t>(
+          std::min<std::uint64_t>(run_records, records - first));
+      const std::uint64_t offset {header_bytes + first * record_bytes};
+      chunk.resize(rows);
+      source.read(chunk.data(), rows * record_bytes, offset);
+      source.read_ahead(offset + rows * record_bytes,
+                        std::min<std::uint64_t>(
+                            records - first - rows, run_records)
+                            * record_bytes);
+
+      std::vector<std::size_t> starts(partitions + 1, 0);
+      partition_of.resize(rows);
+      for ( std::size_t row {0}; row != rows; ++row ) {
+        const std::size_t natural {
+            classes.natural_class(chunk[row].weight)};
+        partition_of[row] = static_cast<std::uint8_t>(
+            natural == Weight_classes::none ? classes.size() : natural);
+        ++starts[partition_of[row] + 1U];
+      }
+      for ( std::size_t partition {0}; partition != partitions;
+            ++partition ) {
+        starts[partition + 1] += starts[partition];
+      }
+      std::vector<std::size_t> next {starts};
+      sorted.resize(rows);
+      for ( std::size_t row {0}; row != rows; ++row ) {
+        sorted[next[partition_of[row]]++] = chunk[row];
+      }
+      parallel_for(
+          partitions,
+          [&](const std::size_t, const std::size_t begin,
+              const std::size_t end) {
+            for ( std::size_t partition {begin}; partition != end;
+                  ++partition ) {
+              std::sort(sorted.begin()
+                            + static_cast<std::ptrdiff_t>(
+                                starts[partition]),
+                        sorted.begin()
+                            + static_cast<std::ptrdiff_t>(
+                                starts[partition + 1]),
+                        ranks_first);
+            }
+          },
+          params.threads);
+
+      Run& run {runs.emplace_back()};
+      run.path = scratch.create();
+      for ( const std::size_t start : starts ) {
+        run.bounds.push_back(std::uint64_t {start} * record_bytes);
+      }
+      Async_file_writer file {run.path};
+      append(file, sorted.data(), rows * record_bytes);
+      file.close();
+    }
+  }
+  report.runs = runs.size();
+
+  std::vector<Roster_record> staged;
+  staged.reserve(block_records);
+
+  // intermediate passes merge groups of runs into longer runs until
+  // one group is left
+  while ( runs.size() > fan_in ) {
+    std::deque<Run> merged;
+    while ( !runs.empty() ) {
+      const std::size_t group {std::min(fan_in, runs.size())};
+      if ( group == 1 ) {
+        merged.push_back(std::move(runs.front()));
+        runs.pop_front();
+        continue;
+      }
+      std::deque<Input_file> files;
+      std::vector<const Run*> sources;
+      for ( std::size_t run {0}; run != group; ++run ) {
+        files.emplace_back(runs[run].path);
+        sources.push_back(&runs[run]);
+      }
+      Run& run {merged.emplace_back()};
+      run.path = scratch.create();
+      run.bounds.push_back(0);
+      Async_file_writer file {run.path};
+      for ( std::size_t partition {0}; partition != partitions;
+            ++partition ) {
+        run.bounds.push_back(
+            run.bounds.back()
+            + merge_segment(sources, files, partition, block_records,
+                            staged, file)
+                  * record_bytes);
+      }
+      file.close();
+      files.clear();
+      for ( std::size_t done {0}; done != group; ++done ) {
+        scratch.remove(runs.front().path);
+        runs.pop_front();
+      }
+    }
+    runs = std::move(merged);
+    ++report.merge_passes;
+  }
+
+  // the last pass writes each partition as a roster of its own
+  std::deque<Input_file> files;
+  std::vector<const Run*> sources;
+  for ( const Run& run : runs ) {
+    files.emplace_back(run.path);
+    sources.push_back(&run);
+  }
+  const Roster_file_format::Header header {Roster_file_format::magic,
+                                           Roster_file_format::version,
+                                           record_bytes};
+  for ( std::size_t partition {0}; partition != partitions;
+        ++partition ) {
+    Roster_partition& output {report.partitions.emplace_back()};
+    output.path = prefix
+                + (partition == classes.size()
+                       ? std::string {"over"}
+                       : std::to_string(classes.limit(partition)))
+                + ".roster";
+    Async_file_writer file {output.path};
+    append(file, &header, header_bytes);
+    output.wrestlers = static_cast<std::size_t>(merge_segment(
+        sources, files, partition, block_records, staged, file));
+    file.close();
+  }
+  ++report.merge_passes;
+  return report;
+}
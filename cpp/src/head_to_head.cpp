@@ -0,0 +1,224 @@
+#include "head_to_head.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "bout_store.h"
+#include "parallel.h"
+
+namespace {
+
+constexpr std::uint64_t empty_key {~std::uint64_t {0}};
+constexpr std::size_t initial_shard_slots {16};
+
+auto pair_key(const int lhs, const int rhs) noexcept -> std::uint64_t
+{
+  const int low {std::min(lhs, rhs)};
+  const int high {std::max(lhs, rhs)};
+  return (std::uint64_t {static_cast<std::uint32_t>(low)} << 32U)
+       | static_cast<std::uint32_t>(high);
+}
+
+/// splitmix64 finalizer
+auto mix(std::uint64_t key) noexcept -> std::uint64_t
+{
+  key = (key ^ (key >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  key = (key ^ (key >> 27U)) * 0x94D049BB133111EBULL;
+  return key ^ (key >> 31U);
+}
+
+} // namespace
+
+Head_to_head_index::Head_to_head_index()
+    : m_shards(shard_count,
+               Shard {std::vector<Entry>(initial_shard_slots,
+                                         Entry {empty_key, 0, 0, 0}),
+                      0})
+{}
+
+Head_to_head_index::Head_to_head_index(const std::vector<Bout>& bouts,
+                                       const std::size_t threads)
+    : Head_to_head_index()
+{
+  const std::size_t workers {threads == 0 ? hardware_threads() : threads};
+
+  // partition bout indices by destination shard
+  std::vector<std::vector<std::size_t>> counts(
+      workers, std::vector<std::size_t>(shard_count, 0));
+  parallel_for(
+      bouts.size(),
+      [&](const std::size_t chunk, const std::size_t begin,
+          const std::size_t end) {
+        for ( std::size_t index {begin}; index != end; ++index ) {
+          const std::uint64_t hash {
+              mix(pair_key(bouts[index].winner, bouts[index].loser))};
+          ++counts[chunk][hash >> (64U - shard_bits)];
+        }
+      },
+      workers);
+
+  std::vector<std::size_t> shard_begin(shard_count + 1, 0);
+  std::size_t running {0};
+  for ( std::size_t shard {0}; shard != shard_count; ++shard ) {
+    shard_begin[shard] = running;
+    for ( auto& chunk_counts : counts ) {
+      const std::size_t count {chunk_counts[shard]};
+      chunk_counts[shard] = running;
+      running += count;
+    }
+  }
+  shard_begin[shard_count] = running;
+
+  std::vector<std::uint32_t> partitioned(bouts.size());
+  parallel_for(
+      bouts.size(),
+      [&](const std::size_t chunk, const std::size_t begin,
+          const std::size_t end) {
+        for ( std::size_t index {begin}; index != end; ++index ) {
+          const std::uint64_t hash {
+              mix(pair_key(bouts[index].winner, bouts[index].loser))};
+          partitioned[counts[chunk][hash >> (64U - shard_bits)]++] =
+              static_cast<std::uint32_t>(index);
+        }
+      },
+      workers);
+
+  // each shard is owned by exactly one task
+  parallel_for(
+      shard_count,
+      [&](std::size_t, const std::size_t begin, const std::size_t end) {
+        for ( std::size_t shard {begin}; shard != end; ++shard ) {
+          for ( std::size_t cursor {shard_begin[shard]};
+                cursor != shard_begin[shard + 1]; ++cursor ) {
+            const Bout& bout {bouts[partitioned[cursor]]};
+            if ( bout.winner == bout.loser ) {
+              continue;
+            }
+            const std::uint64_t key {pair_key(bout.winner, bout.loser)};
+            insert(m_shards[shard], key, mix(key), bout);
+          }
+        }
+      },
+      workers);
+}
+
+auto Head_to_head_index::from_store(const Bout_store& store,
+                                    const std::size_t threads)
+    -> Head_to_head_index
+{
+  const auto& segments = store.segments();
+
+  std::vector<std::size_t> offset(segments.size() + 1, 0);
+  for ( std::size_t segment {0}; segment != segments.size(); ++segment ) {
+    offset[segment + 1] = offset[segment] + segments[segment].rows();
+  }
+
+  std::vector<Bout> bouts(offset.back());
+  parallel_for(
+      segments.size(),
+      [&](std::size_t, const std::size_t begin, const std::size_t end) {
+        for ( std::size_t segment {begin}; segment != end; ++segment ) {
+          std::size_t cursor {offset[segment]};
+          segments[segment].scan(
+              [&](const Bout& bout) { bouts[cursor++] = bout; });
+        }
+      },
+      threads);
+
+  return Head_to_head_index {bouts, threads};
+}
+
+void Head_to_head_index::grow(Shard& shard)
+{
+  std::vector<Entry> old(shard.slots.size() * 2,
+                         Entry {empty_key, 0, 0, 0});
+  old.swap(shard.slots);
+  const std::size_t mask {shard.slots.size() - 1};
+
+  for ( const Entry& entry : old ) {
+    if ( entry.key == empty_key ) {
+      continue;
+    }
+    std::size_t slot {mix(entry.key) & mask};
+    while ( shard.slots[slot].key != empty_key ) {
+      slot = (slot + 1) & mask;
+    }
+    shard.slots[slot] = entry;
+  }
+}
+
+void Head_to_head_index::insert(Shard& shard, const std::uint64_t key,
+                                const std::uint64_t hash,
+                                const Bout& bout)
+{
+  // keep the load factor at or below 3/4
+  if ( (shard.used + 1) * 4 > shard.slots.size() * 3 ) {
+    grow(shard);
+  }
+
+  const std::size_t mask {shard.slots.size() - 1};
+  std::size_t slot {hash & mask};
+  while ( shard.slots[slot].key != empty_key
+          && shard.slots[slot].key != key ) {
+    slot = (slot + 1) & mask;
+  }
+
+  Entry& entry {shard.slots[slot]};
+  if ( entry.key == empty_key ) {
+    entry = Entry {key, 0, 0, bout.date};
+    ++shard.used;
+  }
+
+  if ( bout.winner < bout.loser ) {
+    ++entry.low_wins;
+  } else {
+    ++entry.high_wins;
+  }
+  entry.last_met = std::max(entry.last_met, bout.date);
+}
+
+void Head_to_head_index::record(const Bout& bout)
+{
+  if ( bout.winner == bout.loser ) {
+    return;
+  }
+  const std::uint64_t key {pair_key(bout.winner, bout.loser)};
+  const std::uint64_t hash {mix(key)};
+  insert(m_shards[hash >> (64U - shard_bits)], key, hash, bout);
+}
+
+auto Head_to_head_index::lookup(const int id, const int opponent) const
+    noexcept -> Head_to_head
+{
+  if ( id == opponent ) {
+    return {};
+  }
+
+  const std::uint64_t key {pair_key(id, opponent)};
+  const std::uint64_t hash {mix(key)};
+  const Shard& shard {m_shards[hash >> (64U - shard_bits)]};
+  const std::size_t mask {shard.slots.size() - 1};
+
+  for ( std::size_t slot {hash & mask};; slot = (slot + 1) & mask ) {
+    const Entry& entry {shard.slots[slot]};
+    if ( entry.key == empty_key ) {
+      return {};
+    }
+    if ( entry.key == key ) {
+      const auto low_wins  = static_cast<int>(entry.low_wins);
+      const auto high_wins = static_cast<int>(entry.high_wins);
+      return id < opponent
+               ? Head_to_head {low_wins, high_wins, entry.last_met}
+               : Head_to_head {high_wins, low_wins, entry.last_met};
+    }
+  }
+}
+
+auto Head_to_head_index::pairs() const noexcept -> std::size_t
+{
+  std::size_t total {0};
+  for ( const Shard& shard : m_shards ) {
+    total += shard.used;
+  }
+  return total;
+}
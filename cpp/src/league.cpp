@@ -0,0 +1,285 @@
+#include "league.h"
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+
+#include "parallel.h"
+#include "probability_table.h"
+
+namespace {
+
+/// Result type of a wrestled bout, given the winner's win probability
+auto draw_result(const double winner_odds, Rng& rng) noexcept
+    -> Result_type
+{
+  // bonus-point results grow more likely the more lopsided the bout
+  const double dominance {std::max(0.0, 2.0 * winner_odds - 1.0)};
+  const double draw {rng.uniform()};
+  if ( draw < 0.2 + 0.4 * dominance ) {
+    return Result_type::fall;
+  }
+  if ( draw < 0.3 + 0.5 * dominance ) {
+    return Result_type::tech_fall;
+  }
+  if ( draw < 0.45 + 0.5 * dominance ) {
+    return Result_type::major_decision;
+  }
+  return Result_type::decision;
+}
+
+struct Dual_tally {
+  int points;
+  int bouts;
+  int falls;
+};
+
+} // namespace
+
+auto round_robin(const std::size_t teams) -> std::vector<Dual_round>
+{
+  // an odd league gets a phantom team; meeting it is a bye
+  const std::size_t count {teams + teams % 2};
+  std::vector<std::size_t> circle(count);
+  for ( std::size_t index {0}; index != count; ++index ) {
+    circle[index] = index;
+  }
+
+  std::vector<Dual_round> rounds;
+  for ( std::size_t round {0}; round + 1 < count; ++round ) {
+    Dual_round duals;
+    for ( std::size_t board {0}; board != count / 2; ++board ) {
+      const std::size_t first {circle[board]};
+      const std::size_t second {circle[count - 1 - board]};
+      if ( first == teams || second == teams ) {
+        continue;
+      }
+      if ( (round + board) % 2 == 0 ) {
+        duals.emplace_back(first, second);
+      } else {
+        duals.emplace_back(second, first);
+      }
+    }
+    rounds.push_back(std::move(duals));
+
+    // the first team stays put while everyone else turns one place
+    std::rotate(circle.begin() + 1, circle.end() - 1, circle.end());
+  }
+  return rounds;
+}
+
+League::League(const std::vector<League_team>& teams,
+               const Weight_classes& classes, const Lineup_rules& rules)
+    : m_teams {teams.size()}
+    , m_classes {classes.size()}
+    , m_scoring {rules.scoring}
+{
+  std::vector<Lineup> lineups;
+  lineups.reserve(teams.size());
+  for ( const League_team& team : teams ) {
+    lineups.push_back(standard_lineup(team.roster, classes, rules));
+  }
+
+  for ( const Dual_round& round : round_robin(teams.size()) ) {
+    for ( const auto& [home, away] : round ) {
+      m_schedule.duals.push_back({home, away});
+      for ( std::size_t weight_class {0}; weight_class != m_classes;
+            ++weight_class ) {
+        const std::size_t ours {lineups[home].wrestler_at[weight_class]};
+        const std::size_t theirs {
+            lineups[away].wrestler_at[weight_class]};
+        Scheduled_bout bout {0.5, 0};
+        if ( ours != Lineup::open && theirs != Lineup::open ) {
+          bout.home_win = win_probability(teams[home].roster[ours],
+                                          teams[away].roster[theirs]);
+        } else if ( ours != Lineup::open ) {
+          bout.forfeit = 1;
+        } else if ( theirs != Lineup::open ) {
+          bout.forfeit = -1;
+        } else {
+          bout.forfeit = 2;
+        }
+        m_schedule.bouts.push_back(bout);
+      }
+    }
+  }
+}
+
+auto League::simulate_season(Rng& rng, Arena& arena) const
+    -> Span<Standing>
+{
+  return play_season(m_schedule, rng, arena);
+}
+
+auto League::play_season(const Schedule& schedule, Rng& rng,
+                         Arena& arena) const -> Span<Standing>
+{
+  const std::vector<Scheduled_dual>& duals {schedule.duals};
+  const Scheduled_bout* bout {schedule.bouts.data()};
+  const Span<Standing> table {arena.make_array<Standing>(m_teams)};
+  const Span<signed char> outcome {
+      arena.make_array<signed char>(duals.size())};
+  for ( std::size_t team {0}; team != m_teams; ++team ) {
+    table[team].team = team;
+  }
+
+  for ( std::size_t dual {0}; dual != duals.size(); ++dual ) {
+    Dual_tally home {0, 0, 0};
+    Dual_tally away {0, 0, 0};
+
+    for ( std::size_t weight_class {0}; weight_class != m_classes;
+          ++weight_class, ++bout ) {
+      if ( bout->forfeit == 2 ) {
+        continue;
+      }
+      if ( bout->forfeit != 0 ) {
+        Dual_tally& winner {bout->forfeit > 0 ? home : away};
+        winner.points += m_scoring.forfeit;
+        ++winner.bouts;
+        ++winner.falls;
+        continue;
+      }
+
+      const bool home_won {rng.uniform() < bout->home_win};
+      const Result_type result {draw_result(
+          home_won ? bout->home_win : 1.0 - bout->home_win, rng)};
+      Dual_tally& winner {home_won ? home : away};
+      winner.points += m_scoring.points(result);
+      ++winner.bouts;
+      winner.falls += result == Result_type::fall ? 1 : 0;
+    }
+
+    const auto home_key = std::tie(home.points, home.bouts, home.falls);
+    const auto away_key = std::tie(away.points, away.bouts, away.falls);
+    Standing& host {table[duals[dual].home]};
+    Standing& visitor {table[duals[dual].away]};
+    if ( home_key > away_key ) {
+      outcome[dual] = 1;
+      ++host.wins;
+      ++visitor.losses;
+    } else if ( away_key > home_key ) {
+      outcome[dual] = -1;
+      ++visitor.wins;
+      ++host.losses;
+    } else {
+      ++host.ties;
+      ++visitor.ties;
+    }
+    host.points_for += home.points;
+    host.points_against += away.points;
+    host.bouts_won += home.bouts;
+    visitor.points_for += away.points;
+    visitor.points_against += home.points;
+    visitor.bouts_won += away.bouts;
+  }
+
+  // teams level on record form a group; tally duals inside each group
+  const Span<int> record {arena.make_array<int>(m_teams)};
+  const Span<int> head_to_head {arena.make_array<int>(m_teams)};
+  const Span<std::uint64_t> lot {arena.make_array<std::uint64_t>(m_teams)};
+  for ( std::size_t team {0}; team != m_teams; ++team ) {
+    record[team] = table[team].record_points();
+    lot[team]    = rng();
+  }
+  for ( std::size_t dual {0}; dual != duals.size(); ++dual ) {
+    const std::size_t host {duals[dual].home};
+    const std::size_t visitor {duals[dual].away};
+    if ( record[host] == record[visitor] ) {
+      head_to_head[host] += 1 + outcome[dual];
+      head_to_head[visitor] += 1 - outcome[dual];
+    }
+  }
+
+  std::sort(table.begin(), table.end(),
+            [&](const Standing& lhs, const Standing& rhs) {
+              const auto key = [&](const Standing& standing) {
+                return std::make_tuple(
+                    standing.record_points(), head_to_head[standing.team],
+                    standing.points_for - standing.points_against,
+                    standing.bouts_won, lot[standing.team]);
+              };
+              return key(lhs) > key(rhs);
+            });
+  return table;
+}
+
+auto League::simulate(const League_params& params) const -> League_summary
+{
+  const std::size_t threads {params.threads == 0 ? hardware_threads()
+                                                 : params.threads};
+  const std::size_t chunks {
+      std::max<std::size_t>(1, std::min(threads, params.seasons))};
+
+  // integer tallies per chunk keep the summary independent of threads
+  std::vector<std::vector<std::size_t>> titles(
+      chunks, std::vector<std::size_t>(m_teams, 0));
+  std::vector<std::vector<std::size_t>> places {titles};
+  std::vector<std::vector<std::size_t>> record {titles};
+
+  // with a topology every node gets its own copy of the schedule
+  std::unique_ptr<Node_replicated<Schedule>> replicas;
+  if ( params.topology != nullptr ) {
+    replicas = std::make_unique<Node_replicated<Schedule>>(
+        *params.topology, m_schedule);
+  }
+
+  const auto run = [&](const std::size_t chunk, const std::size_t begin,
+                       const std::size_t end) {
+    const Schedule* schedule {&m_schedule};
+    if ( replicas ) {
+      const std::size_t node {params.topology->node_for_worker(chunk)};
+      schedule = &replicas->copy(node);
+    }
+    // built by the worker, so a pinned worker's arena is node-local
+    Arena arena;
+    for ( std::size_t season {begin}; season != end; ++season ) {
+      arena.reset();
+      Rng rng {params.seed, season};
+      const Span<Standing> table {play_season(*schedule, rng, arena)};
+      for ( std::size_t place {0}; place != table.size(); ++place ) {
+        const Standing& standing {table[place]};
+        places[chunk][standing.team] += place + 1;
+        record[chunk][standing.team] +=
+            static_cast<std::size_t>(standing.record_points());
+      }
+      if ( !table.empty() ) {
+        ++titles[chunk][table[0].team];
+      }
+    }
+  };
+
+  std::size_t pin_failures {0};
+  if ( params.topology != nullptr ) {
+    pin_failures = replicas->pin_failures()
+                 + pinned_parallel_for(*params.topology, params.seasons,
+                                       run, chunks);
+  } else {
+    parallel_for(params.seasons, run, chunks);
+  }
+
+  League_summary summary {params.seasons,
+                          std::vector<double>(m_teams, 0.0),
+                          std::vector<double>(m_teams, 0.0),
+                          std::vector<double>(m_teams, 0.0), pin_failures};
+  if ( params.seasons == 0 ) {
+    return summary;
+  }
+
+  const auto seasons = static_cast<double>(params.seasons);
+  for ( std::size_t team {0}; team != m_teams; ++team ) {
+    std::size_t title_count {0};
+    std::size_t place_sum {0};
+    std::size_t record_sum {0};
+    for ( std::size_t chunk {0}; chunk != chunks; ++chunk ) {
+      title_count += titles[chunk][team];
+      place_sum += places[chunk][team];
+      record_sum += record[chunk][team];
+    }
+    summary.title_probability[team] =
+        static_cast<double>(title_count) / seasons;
+    summary.mean_place[team] = static_cast<double>(place_sum) / seasons;
+    summary.mean_wins[team] =
+        static_cast<double>(record_sum) / (2.0 * seasons);
+  }
+  return summary;
+}
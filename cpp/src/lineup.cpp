@@ -0,0 +1,175 @@
+#include "lineup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "probability_table.h"
+
+namespace {
+
+/// Keeps ineligible pairings out of any optimal assignment
+constexpr double forbidden {1e9};
+
+auto winner_points(const double probability, const Dual_scoring& scoring)
+    -> double
+{
+  const double dominance {std::max(0.0, 2.0 * probability - 1.0)};
+  return scoring.decision + (scoring.fall - scoring.decision) * dominance;
+}
+
+} // namespace
+
+auto expected_bout_points(const Wrestler& ours, const Wrestler& theirs,
+                          const Dual_scoring& scoring) -> double
+{
+  const double win {win_probability(ours, theirs)};
+  const double loss {1.0 - win};
+  return win * winner_points(win, scoring)
+       - loss * winner_points(loss, scoring);
+}
+
+auto standard_lineup(const std::vector<Wrestler>& roster,
+                     const Weight_classes& classes,
+                     const Lineup_rules& rules) -> Lineup
+{
+  // filling a class is worth more than any spread of abilities
+  double filled {1.0};
+  for ( const Wrestler& wrestler : roster ) {
+    filled += std::abs(static_cast<double>(wrestler.ability()));
+  }
+
+  const std::size_t rows {classes.size()};
+  const std::size_t columns {roster.size() + rows};
+  std::vector<double> cost(rows * columns, 0.0);
+  for ( std::size_t weight_class {0}; weight_class != rows;
+        ++weight_class ) {
+    for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+      cost[weight_class * columns + slot] =
+          classes.eligible(roster[slot].weight(), weight_class,
+                           rules.allowance, rules.classes_up)
+              ? -filled - roster[slot].ability()
+              : forbidden;
+    }
+  }
+
+  Assignment_solver solver;
+  const std::vector<std::size_t>& column_of {
+      solver.solve(rows, columns, cost.data())};
+
+  Lineup lineup {std::vector<std::size_t>(rows, Lineup::open), 0.0};
+  for ( std::size_t weight_class {0}; weight_class != rows;
+        ++weight_class ) {
+    if ( column_of[weight_class] < roster.size() ) {
+      lineup.wrestler_at[weight_class] = column_of[weight_class];
+    }
+  }
+  return lineup;
+}
+
+Lineup_optimizer::Lineup_optimizer(const std::vector<Wrestler>& team,
+                                   const std::vector<Wrestler>& opponents,
+                                   Weight_classes classes,
+                                   const Lineup_rules rules)
+    : m_classes {std::move(classes)}
+    , m_rules {rules}
+    , m_team_size {team.size()}
+    , m_opponent_size {opponents.size()}
+    , m_points(team.size() * opponents.size(), 0.0)
+    , m_eligible(team.size() * m_classes.size(), 0)
+{
+  for ( std::size_t slot {0}; slot != m_team_size; ++slot ) {
+    for ( std::size_t opponent {0}; opponent != m_opponent_size;
+          ++opponent ) {
+      m_points[slot * m_opponent_size + opponent] = expected_bout_points(
+          team[slot], opponents[opponent], m_rules.scoring);
+    }
+    for ( std::size_t weight_class {0}; weight_class != m_classes.size();
+          ++weight_class ) {
+      m_eligible[slot * m_classes.size() + weight_class] =
+          m_classes.eligible(team[slot].weight(), weight_class,
+                             m_rules.allowance, m_rules.classes_up)
+              ? 1
+              : 0;
+    }
+  }
+}
+
+void Lineup_optimizer::check(const std::vector<std::size_t>& lineup,
+                             const std::size_t roster_size) const
+{
+  if ( lineup.size() != m_classes.size() ) {
+    throw std::invalid_argument {"Lineup does not match weight classes"};
+  }
+  for ( const std::size_t slot : lineup ) {
+    if ( slot != Lineup::open && slot >= roster_size ) {
+      throw std::out_of_range {"Lineup slot out of range"};
+    }
+  }
+}
+
+auto Lineup_optimizer::margin(
+    const std::vector<std::size_t>& lineup,
+    const std::vector<std::size_t>& opponent_lineup) const -> double
+{
+  check(lineup, m_team_size);
+  check(opponent_lineup, m_opponent_size);
+
+  const double forfeit {static_cast<double>(m_rules.scoring.forfeit)};
+  double total {0.0};
+  for ( std::size_t weight_class {0}; weight_class != lineup.size();
+        ++weight_class ) {
+    const std::size_t ours {lineup[weight_class]};
+    const std::size_t theirs {opponent_lineup[weight_class]};
+    if ( ours != Lineup::open && theirs != Lineup::open ) {
+      total += expected_points(ours, theirs);
+    } else if ( ours != Lineup::open ) {
+      total += forfeit;
+    } else if ( theirs != Lineup::open ) {
+      total -= forfeit;
+    }
+  }
+  return total;
+}
+
+auto Lineup_optimizer::optimize(
+    const std::vector<std::size_t>& opponent_lineup) -> Lineup
+{
+  check(opponent_lineup, m_opponent_size);
+
+  // rows are weight classes; columns are the team, then one "open"
+  // column per class so that every class can forfeit at once
+  const std::size_t rows {m_classes.size()};
+  const std::size_t columns {m_team_size + rows};
+  const double forfeit {static_cast<double>(m_rules.scoring.forfeit)};
+
+  m_cost.resize(rows * columns);
+  for ( std::size_t weight_class {0}; weight_class != rows;
+        ++weight_class ) {
+    const std::size_t theirs {opponent_lineup[weight_class]};
+    double* const costs {&m_cost[weight_class * columns]};
+
+    for ( std::size_t slot {0}; slot != m_team_size; ++slot ) {
+      const double gain {theirs == Lineup::open
+                             ? forfeit
+                             : expected_points(slot, theirs)};
+      costs[slot] = eligible(slot, weight_class) ? -gain : forbidden;
+    }
+    std::fill(costs + m_team_size, costs + columns,
+              theirs == Lineup::open ? 0.0 : forfeit);
+  }
+
+  const std::vector<std::size_t>& column_of {
+      m_solver.solve(rows, columns, m_cost.data())};
+
+  Lineup lineup {std::vector<std::size_t>(rows, Lineup::open), 0.0};
+  for ( std::size_t weight_class {0}; weight_class != rows;
+        ++weight_class ) {
+    if ( column_of[weight_class] < m_team_size ) {
+      lineup.wrestler_at[weight_class] = column_of[weight_class];
+    }
+  }
+  lineup.expected_margin = margin(lineup.wrestler_at, opponent_lineup);
+  return lineup;
+}
@@ -0,0 +1,103 @@
+#include "lineup_game.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "parallel.h"
+
+auto enumerate_lineups(const std::vector<Wrestler>& roster,
+                       const Weight_classes& classes,
+                       const Lineup_rules& rules, const std::size_t limit)
+    -> std::vector<std::vector<std::size_t>>
+{
+  // eligible slots per class, strongest first
+  std::vector<std::vector<std::size_t>> options(classes.size());
+  for ( std::size_t weight_class {0}; weight_class != classes.size();
+        ++weight_class ) {
+    for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+      if ( classes.eligible(roster[slot].weight(), weight_class,
+                            rules.allowance, rules.classes_up) ) {
+        options[weight_class].push_back(slot);
+      }
+    }
+    std::stable_sort(options[weight_class].begin(),
+                     options[weight_class].end(),
+                     [&](const std::size_t lhs, const std::size_t rhs) {
+                       return roster[lhs].ability()
+                            > roster[rhs].ability();
+                     });
+  }
+
+  std::vector<std::vector<std::size_t>> lineups;
+  std::vector<std::size_t> lineup(classes.size(), Lineup::open);
+  std::vector<bool> entered(roster.size(), false);
+
+  const std::function<void(std::size_t)> extend =
+      [&](const std::size_t weight_class) {
+        if ( lineups.size() == limit ) {
+          return;
+        }
+        if ( weight_class == classes.size() ) {
+          lineups.push_back(lineup);
+          return;
+        }
+
+        bool filled {false};
+        for ( const std::size_t slot : options[weight_class] ) {
+          if ( entered[slot] ) {
+            continue;
+          }
+          filled               = true;
+          entered[slot]        = true;
+          lineup[weight_class] = slot;
+          extend(weight_class + 1);
+          entered[slot] = false;
+        }
+        if ( !filled ) {
+          lineup[weight_class] = Lineup::open;
+          extend(weight_class + 1);
+        }
+      };
+  extend(0);
+
+  return lineups;
+}
+
+auto solve_lineup_game(const std::vector<Wrestler>& team,
+                       const std::vector<Wrestler>& opponents,
+                       const Weight_classes& classes,
+                       const Lineup_rules& rules,
+                       const Lineup_game_params& params) -> Lineup_game
+{
+  Lineup_game game;
+  game.our_lineups =
+      enumerate_lineups(team, classes, rules, params.max_lineups);
+  game.their_lineups =
+      enumerate_lineups(opponents, classes, rules, params.max_lineups);
+
+  const Lineup_optimizer optimizer {team, opponents, classes, rules};
+
+  game.payoff = Payoff_matrix {game.our_lineups.size(),
+                               game.their_lineups.size()};
+  parallel_for(
+      game.our_lineups.size(),
+      [&](std::size_t, const std::size_t begin, const std::size_t end) {
+        for ( std::size_t row {begin}; row != end; ++row ) {
+          for ( std::size_t column {0};
+                column != game.their_lineups.size(); ++column ) {
+            game.payoff(row, column) = optimizer.margin(
+                game.our_lineups[row], game.their_lineups[column]);
+          }
+        }
+      },
+      params.threads);
+
+  if ( game.payoff.rows() == 0 || game.payoff.columns() == 0 ) {
+    return game;
+  }
+
+  game.surviving = prune_dominated(game.payoff, params.threads);
+  game.solution  = solve_matrix_game(
+      game.payoff.submatrix(game.surviving.rows, game.surviving.columns));
+  return game;
+}
@@ -1,9 +1,377 @@
-#include <iostream>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 
-auto main([[maybe_unused]] const int argc,
-          [[maybe_unused]] const char* const* const argv) -> int
+#include "arena.h"
+#include "async_file.h"
+#include "external_sort.h"
+#include "league.h"
+#include "parallel.h"
+#include "qualifier.h"
+#include "random.h"
+#include "result_tables.h"
+#include "result_writer.h"
+#include "roster_file.h"
+#include "roster_validation.h"
+#include "text_format.h"
+
+namespace {
+
+/// `text` as a whole number, `fallback` if it is null, or nothing if it
+/// is not one
+auto whole_number(const char* const text, const std::uint64_t fallback)
+    -> std::optional<std::uint64_t>
 {
-  std::cout << R"(I have absolutely no idea how this is supposed to work.
+  if ( text == nullptr ) {
+    return fallback;
+  }
+  const std::string_view digits {text};
+  std::uint64_t value {0};
+  const auto [end, error] = std::from_chars(
+      digits.data(), digits.data() + digits.size(), value);
+  if ( error != std::errc {} || end != digits.data() + digits.size() ) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// As `whole_number`, but zero is not accepted either
+auto positive_number(const char* const text, const std::uint64_t fallback)
+    -> std::optional<std::uint64_t>
+{
+  const std::optional<std::uint64_t> value {whole_number(text, fallback)};
+  if ( value == std::uint64_t {0} ) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// Map a huge-page arena, touch every byte and report the coverage;
+/// fails unless all of it is backed by huge pages
+auto check_huge_pages(Text_buffer& out, const char* const megabytes)
+    -> int
+{
+  const std::optional<std::uint64_t> size {positive_number(megabytes, 64)};
+  if ( !size || *size > std::numeric_limits<std::size_t>::max() >> 20U ) {
+    throw std::invalid_argument {
+        "Usage: huge-pages [MiB], a positive size"};
+  }
+  const std::size_t bytes {static_cast<std::size_t>(*size) << 20U};
+
+  Arena arena {bytes, true};
+  const auto memory = arena.make_array<unsigned char>(bytes);
+  std::memset(memory.data(), 1, memory.size());
+
+  const Huge_page_coverage coverage {arena.huge_page_coverage()};
+  out << "Huge pages back " << coverage.huge_bytes / 1024 / 1024 << " of "
+      << coverage.bytes / 1024 / 1024 << " MiB ("
+      << Fixed {100.0 * coverage.fraction(), 1} << "%)\n";
+
+  return coverage.huge_bytes == coverage.bytes ? EXIT_SUCCESS
+                                               : EXIT_FAILURE;
+}
+
+/// Stream `count` random bouts from every thread into `path` and report
+/// how they were written
+auto write_bouts(Text_buffer& out, const char* const path,
+                 const char* const count) -> int
+{
+  const std::optional<std::uint64_t> bouts {
+      positive_number(count, 10'000'000)};
+  if ( !bouts ) {
+    throw std::invalid_argument {
+        "Usage: write-bouts <path> [bouts], a positive count"};
+  }
+  const Season season {Season::starting(2025)};
+  const auto days =
+      static_cast<std::uint32_t>(season.last_day - season.first_day + 1);
+
+  Async_file_writer file {path};
+  Result_writer writer {file.sink()};
+  parallel_for(*bouts, [&](const std::size_t chunk,
+                           const std::size_t begin,
+                           const std::size_t end) {
+    Rng rng {0, chunk};
+    for ( std::size_t replay {begin}; replay != end; ++replay ) {
+      Bout bout;
+      bout.winner       = static_cast<int>(rng.below(10'000));
+      bout.loser        = (bout.winner + 1
+                    + static_cast<int>(rng.below(9'999))) % 10'000;
+      bout.date = season.first_day + static_cast<int>(rng.below(days));
+      bout.tournament   = static_cast<int>(rng.below(64));
+      bout.winner_score = static_cast<std::int16_t>(rng.below(20));
+      bout.loser_score  = static_cast<std::int16_t>(
+          rng.below(static_cast<std::uint32_t>(bout.winner_score) + 1));
+      writer.submit({replay, bout});
+    }
+  });
+  writer.close();
+  file.close();
+
+  const Result_writer_stats stats {writer.stats()};
+  out << "Wrote " << stats.written << " bouts ("
+      << file.bytes() / 1024 / 1024 << " MiB) in " << stats.writes
+      << " batches through "
+      << (file.backend() == Write_backend::io_uring ? "io_uring"
+                                                    : "pwrite")
+      << (file.direct() ? " with O_DIRECT" : "") << "; producers waited "
+      << stats.stalls << " times\n";
+  return EXIT_SUCCESS;
+}
+
+/// Write `table` to `path` as an Arrow stream
+void export_table(Text_buffer& out, const Arrow_table& table,
+                  const std::string& path)
+{
+  Async_file_writer file {path};
+  table.write(file.sink());
+  file.close();
+  out << "Wrote " << table.rows() << " rows to " << path << '\n';
+}
+
+/**
+ * Simulate a seeded league of `teams` teams over `seasons` seasons, then
+ * every class's district, regional and state qualifiers, and export the
+ * team and wrestler aggregates as `<prefix>teams.arrow` and
+ * `<prefix>wrestlers.arrow`
+ */
+auto export_league(Text_buffer& out, const std::string& prefix,
+                   const char* const teams, const char* const seasons)
+    -> int
+{
+  const auto classes = Weight_classes::high_school();
+  const std::optional<std::uint64_t> parsed_teams {
+      positive_number(teams, 16)};
+  const std::optional<std::uint64_t> parsed_seasons {
+      positive_number(seasons, 1000)};
+  if ( !parsed_teams || *parsed_teams < 2 || !parsed_seasons ) {
+    throw std::invalid_argument {
+        "Usage: export-league <prefix> [teams] [seasons], at least two "
+        "teams and a positive number of seasons"};
+  }
+  const std::size_t team_count {*parsed_teams};
+
+  Rng rng {2025};
+  std::vector<League_team> league_teams(team_count);
+  int id {0};
+  for ( std::size_t team {0}; team != team_count; ++team ) {
+    league_teams[team].name = "Team " + std::to_string(team + 1);
+    const int strength {1300 + static_cast<int>(rng.below(400))};
+    for ( std::size_t weight_class {0}; weight_class != classes.size();
+          ++weight_class ) {
+      league_teams[team].roster.emplace_back(
+          id++, 15 + static_cast<int>(rng.below(4)),
+          classes.limit(weight_class) - static_cast<int>(rng.below(4)),
+          strength + static_cast<int>(rng.below(300)));
+    }
+  }
+
+  League_params league_params;
+  league_params.seasons = *parsed_seasons;
+  const League league {league_teams, classes};
+  export_table(out,
+               league_table(league_teams, league.simulate(league_params)),
+               prefix + "teams.arrow");
+
+  // each class qualifies on its own: districts of about eight teams, two
+  // districts to a region
+  const std::size_t districts {(team_count + 7) / 8};
+  std::vector<Wrestler> wrestlers;
+  std::vector<std::string> team_of;
+  Qualifier_odds odds;
+  const auto append = [](std::vector<double>& into,
+                         const std::vector<double>& from) {
+    into.insert(into.end(), from.begin(), from.end());
+  };
+  for ( std::size_t weight_class {0}; weight_class != classes.size();
+        ++weight_class ) {
+    std::vector<Wrestler> roster;
+    Qualifier_format format;
+    format.regions = (districts + 1) / 2;
+    format.districts.resize(districts);
+    for ( std::size_t team {0}; team != team_count; ++team ) {
+      format.districts[team % districts].entrants.push_back(team);
+      format.districts[team % districts].region = team % districts / 2;
+      roster.push_back(league_teams[team].roster[weight_class]);
+      team_of.push_back(league_teams[team].name);
+    }
+
+    const Qualifier_odds class_odds {simulate_qualifiers(roster, format)};
+    wrestlers.insert(wrestlers.end(), roster.begin(), roster.end());
+    odds.trials       = class_odds.trials;
+    odds.state_places = class_odds.state_places;
+    append(odds.reach_region, class_odds.reach_region);
+    append(odds.reach_state, class_odds.reach_state);
+    append(odds.place_probability, class_odds.place_probability);
+  }
+  export_table(out, qualifier_table(wrestlers, team_of, odds),
+               prefix + "wrestlers.arrow");
+  return EXIT_SUCCESS;
+}
+
+/// Generate `count` synthetic wrestlers into `path`, as CSV if its name
+/// ends in `.csv` and as a binary roster otherwise
+auto generate(Text_buffer& out, const std::string& path,
+              const char* const count, const char* const seed) -> int
+{
+  const std::optional<std::uint64_t> parsed_count {
+      positive_number(count, 1'000'000)};
+  const std::optional<std::uint64_t> parsed_seed {whole_number(seed, 0)};
+  if ( !parsed_count || !parsed_seed ) {
+    throw std::invalid_argument {
+        "Usage: generate <path> [wrestlers] [seed], a positive number of "
+        "wrestlers and a whole-number seed"};
+  }
+  const std::size_t wrestlers {*parsed_count};
+  Roster_params params;
+  params.seed = *parsed_seed;
+  const bool csv {path.size() >= 4
+                  && path.compare(path.size() - 4, 4, ".csv") == 0};
+
+  const auto start = std::chrono::steady_clock::now();
+  Roster_generator {params}.write(path, wrestlers,
+                                  csv ? Roster_encoding::csv
+                                      : Roster_encoding::binary);
+  const std::chrono::duration<double> seconds {
+      std::chrono::steady_clock::now() - start};
+
+  out << "Generated " << wrestlers << " wrestlers into " << path << " in "
+      << Fixed {seconds.count(), 2} << " s\n";
+  return EXIT_SUCCESS;
+}
+
+/// Validate the binary roster at `path` and report what breaks the
+/// default limits
+auto validate(Text_buffer& out, const std::string& path) -> int
+{
+  using Clock = std::chrono::steady_clock;
+  const auto classes = Weight_classes::high_school();
+
+  const auto start = Clock::now();
+  const Roster_file file {path};
+  std::vector<Roster_record> records;
+  file.read(0, file.size(), records);
+  // rosters declare no classes, so those are not checked
+  const Roster_columns roster {
+      to_columns({records.data(), records.size()})};
+  const auto loaded = Clock::now();
+  const Roster_violations violations {validate_roster(roster, classes)};
+  const auto validated = Clock::now();
+
+  const auto milliseconds = [](const Clock::duration elapsed) {
+    return Fixed {std::chrono::duration<double, std::milli> {elapsed}
+                      .count(),
+                  1};
+  };
+  out << "Loaded " << roster.size() << " wrestlers in "
+      << milliseconds(loaded - start) << " ms, validated in "
+      << milliseconds(validated - loaded) << " ms\n";
+  constexpr std::array<std::string_view, violation_kinds> names {
+      "age", "weight", "ability", "weight class", "duplicate id"};
+  for ( std::size_t kind {0}; kind != violation_kinds; ++kind ) {
+    if ( static_cast<Violation>(kind) == Violation::weight_class ) {
+      continue;
+    }
+    out << Padded {names[kind], 14} << Padded {
+        violations.count(static_cast<Violation>(kind)), 10, ' ',
+        Align::right} << '\n';
+  }
+  return violations.violating_rows().empty() ? EXIT_SUCCESS
+                                             : EXIT_FAILURE;
+}
+
+/// Split the binary roster at `path` into per-class rosters sorted by
+/// ability, `<prefix><limit>.roster`, sorting in `megabytes` of memory
+auto partition(Text_buffer& out, const std::string& path,
+               const std::string& prefix, const char* const megabytes)
+    -> int
+{
+  External_sort_params params;
+  const std::optional<std::uint64_t> memory {
+      positive_number(megabytes, params.memory_bytes >> 20U)};
+  if ( !memory
+       || *memory > std::numeric_limits<std::size_t>::max() >> 20U ) {
+    throw std::invalid_argument {
+        "Usage: partition <roster> <prefix> [MiB], a positive size"};
+  }
+  params.memory_bytes = static_cast<std::size_t>(*memory) << 20U;
+
+  const auto start = std::chrono::steady_clock::now();
+  const Partition_report report {partition_roster(
+      path, Weight_classes::high_school(), prefix, params)};
+  const std::chrono::duration<double> seconds {
+      std::chrono::steady_clock::now() - start};
+
+  out << "Sorted " << report.runs << " runs in " << report.merge_passes
+      << " merge passes in " << Fixed {seconds.count(), 2} << " s\n";
+  for ( const Roster_partition& partition : report.partitions ) {
+    out << Padded {partition.path, 40} << Padded {
+        partition.wrestlers, 10, ' ', Align::right} << '\n';
+  }
+  return EXIT_SUCCESS;
+}
+
+/// Run a mode, reporting anything it throws on `err` as a failure
+template <typename Mode>
+auto reporting_errors(Text_buffer& out, Text_buffer& err,
+                      const Mode& mode) -> int
+{
+  try {
+    return mode();
+  } catch ( const std::exception& error ) {
+    out.flush();
+    err << error.what() << '\n';
+    err.flush();
+    return EXIT_FAILURE;
+  }
+}
+
+} // namespace
+
+auto main(const int argc, const char* const* const argv) -> int
+{
+  // one buffer per stream for the whole run
+  Text_buffer out {stdout};
+  Text_buffer err {stderr, 1024};
+  const std::string_view mode {argc >= 2 ? argv[1] : ""};
+  const auto arg = [&](const int index) -> const char* {
+    return argc > index ? argv[index] : nullptr;
+  };
+  const auto run = [&](const auto& mode_func) {
+    return reporting_errors(out, err, mode_func);
+  };
+  if ( mode == "huge-pages" ) {
+    return run([&] { return check_huge_pages(out, arg(2)); });
+  }
+  if ( argc >= 3 && mode == "write-bouts" ) {
+    return run([&] { return write_bouts(out, argv[2], arg(3)); });
+  }
+  if ( argc >= 3 && mode == "generate" ) {
+    return run([&] { return generate(out, argv[2], arg(3), arg(4)); });
+  }
+  if ( argc >= 3 && mode == "validate" ) {
+    return run([&] { return validate(out, argv[2]); });
+  }
+  if ( argc >= 3 && mode == "export-league" ) {
+    return run(
+        [&] { return export_league(out, argv[2], arg(3), arg(4)); });
+  }
+  if ( argc >= 4 && mode == "partition" ) {
+    return run([&] { return partition(out, argv[2], argv[3], arg(4)); });
+  }
+
+  out << R"(I have absolutely no idea how this is supposed to work.
 I do not understand how a tournament or a match or a bout is supposed to work.
 I'm sure I could make it work, if I understood how it was supposed to work.
 I have spent so much time trying to understand how it should work, but I can't make heads or tails of the requirements.
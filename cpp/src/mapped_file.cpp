@@ -0,0 +1,59 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Mapped_file::Mapped_file(const std::string& path)
+{
+  const int descriptor {::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if ( descriptor < 0 ) {
+    throw std::runtime_error {"Cannot open " + path};
+  }
+
+  struct stat info {};
+  if ( ::fstat(descriptor, &info) != 0 ) {
+    ::close(descriptor);
+    throw std::runtime_error {"Cannot stat " + path};
+  }
+
+  m_size = static_cast<std::size_t>(info.st_size);
+  if ( m_size != 0 ) {
+    void* const address {
+        ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, descriptor, 0)};
+    if ( address == MAP_FAILED ) {
+      ::close(descriptor);
+      throw std::runtime_error {"Cannot map " + path};
+    }
+    m_data = static_cast<const unsigned char*>(address);
+  }
+
+  ::close(descriptor);
+}
+
+Mapped_file::Mapped_file(Mapped_file&& other) noexcept
+    : m_data {std::exchange(other.m_data, nullptr)}
+    , m_size {std::exchange(other.m_size, 0)}
+{}
+
+auto Mapped_file::operator=(Mapped_file&& other) noexcept -> Mapped_file&
+{
+  if ( this != &other ) {
+    Mapped_file discard {std::move(*this)};
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+  }
+  return *this;
+}
+
+Mapped_file::~Mapped_file()
+{
+  if ( m_data != nullptr ) {
+    //NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    ::munmap(const_cast<unsigned char*>(m_data), m_size);
+  }
+}
@@ -0,0 +1,208 @@
+#include "matrix_game.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "parallel.h"
+
+namespace {
+
+constexpr double epsilon {1e-12};
+
+/// Does `better` weakly dominate `worse`, where `at(strategy, other)`
+/// is the payoff to the strategy's owner?
+template <typename Payoff>
+auto dominates(const std::size_t better, const std::size_t worse,
+               const std::vector<std::size_t>& others, Payoff at) -> bool
+{
+  bool strict {false};
+  for ( const std::size_t other : others ) {
+    const double gap {at(better, other) - at(worse, other)};
+    if ( gap < -epsilon ) {
+      return false;
+    }
+    strict = strict || gap > epsilon;
+  }
+  // identical strategies: the earlier one survives
+  return strict || better < worse;
+}
+
+/// Drop every strategy some other live strategy dominates
+template <typename Payoff>
+auto prune(std::vector<std::size_t>& live,
+           const std::vector<std::size_t>& others, Payoff at,
+           const std::size_t threads) -> bool
+{
+  std::vector<unsigned char> dominated(live.size(), 0);
+  parallel_for(
+      live.size(),
+      [&](std::size_t, const std::size_t begin, const std::size_t end) {
+        for ( std::size_t index {begin}; index != end; ++index ) {
+          for ( const std::size_t rival : live ) {
+            if ( rival != live[index]
+                 && dominates(rival, live[index], others, at) ) {
+              dominated[index] = 1;
+              break;
+            }
+          }
+        }
+      },
+      threads);
+
+  // domination is transitive, so dropping them all at once keeps a
+  // dominating strategy for each
+  std::size_t kept {0};
+  for ( std::size_t index {0}; index != live.size(); ++index ) {
+    if ( dominated[index] == 0 ) {
+      live[kept++] = live[index];
+    }
+  }
+  const bool changed {kept != live.size()};
+  live.resize(kept);
+  return changed;
+}
+
+} // namespace
+
+auto Payoff_matrix::submatrix(const std::vector<std::size_t>& rows,
+                              const std::vector<std::size_t>& columns)
+    const -> Payoff_matrix
+{
+  Payoff_matrix result {rows.size(), columns.size()};
+  for ( std::size_t row {0}; row != rows.size(); ++row ) {
+    for ( std::size_t column {0}; column != columns.size(); ++column ) {
+      result(row, column) = (*this)(rows[row], columns[column]);
+    }
+  }
+  return result;
+}
+
+auto prune_dominated(const Payoff_matrix& payoff,
+                     const std::size_t threads) -> Surviving_strategies
+{
+  Surviving_strategies live;
+  live.rows.resize(payoff.rows());
+  live.columns.resize(payoff.columns());
+  for ( std::size_t row {0}; row != payoff.rows(); ++row ) {
+    live.rows[row] = row;
+  }
+  for ( std::size_t column {0}; column != payoff.columns(); ++column ) {
+    live.columns[column] = column;
+  }
+
+  const auto row_payoff = [&](const std::size_t row,
+                              const std::size_t column) {
+    return payoff(row, column);
+  };
+  const auto column_payoff = [&](const std::size_t column,
+                                 const std::size_t row) {
+    return -payoff(row, column);
+  };
+
+  bool changed {true};
+  while ( changed ) {
+    changed = prune(live.rows, live.columns, row_payoff, threads);
+    changed = prune(live.columns, live.rows, column_payoff, threads)
+           || changed;
+  }
+  return live;
+}
+
+auto solve_matrix_game(const Payoff_matrix& payoff) -> Game_solution
+{
+  const std::size_t rows {payoff.rows()};
+  const std::size_t columns {payoff.columns()};
+  if ( rows == 0 || columns == 0 ) {
+    throw std::invalid_argument {"Empty matrix game"};
+  }
+
+  // shift every payoff to at least 1 so the value is positive; then the
+  // column player solves  max sum(y)  s.t.  A y <= 1, y >= 0
+  double lowest {payoff(0, 0)};
+  for ( std::size_t row {0}; row != rows; ++row ) {
+    for ( std::size_t column {0}; column != columns; ++column ) {
+      lowest = std::min(lowest, payoff(row, column));
+    }
+  }
+  const double shift {1.0 - lowest};
+
+  // tableau rows are the constraints and then the objective; columns are
+  // y, the slacks, and the right-hand side
+  const std::size_t width {columns + rows + 1};
+  std::vector<double> tableau((rows + 1) * width, 0.0);
+  std::vector<std::size_t> basis(rows);
+  const auto at = [&](const std::size_t row, const std::size_t column)
+      -> double& { return tableau[row * width + column]; };
+
+  for ( std::size_t row {0}; row != rows; ++row ) {
+    for ( std::size_t column {0}; column != columns; ++column ) {
+      at(row, column) = payoff(row, column) + shift;
+    }
+    at(row, columns + row) = 1.0;
+    at(row, width - 1)     = 1.0;
+    basis[row]             = columns + row;
+  }
+  for ( std::size_t column {0}; column != columns; ++column ) {
+    at(rows, column) = -1.0;
+  }
+
+  while ( true ) {
+    // Bland's rule: lowest-index improving column, then lowest-index
+    // basic variable among tied ratios; it cannot cycle
+    std::size_t entering {width};
+    for ( std::size_t column {0}; column + 1 != width; ++column ) {
+      if ( at(rows, column) < -epsilon ) {
+        entering = column;
+        break;
+      }
+    }
+    if ( entering == width ) {
+      break;
+    }
+
+    std::size_t leaving {rows};
+    double best_ratio {0.0};
+    for ( std::size_t row {0}; row != rows; ++row ) {
+      if ( at(row, entering) > epsilon ) {
+        const double ratio {at(row, width - 1) / at(row, entering)};
+        if ( leaving == rows || ratio < best_ratio - epsilon
+             || (ratio < best_ratio + epsilon
+                 && basis[row] < basis[leaving]) ) {
+          leaving    = row;
+          best_ratio = ratio;
+        }
+      }
+    }
+    // the constraints bound every y, so some row always limits it
+    if ( leaving == rows ) {
+      throw std::logic_error {"Unbounded matrix game"};
+    }
+
+    const double pivot {at(leaving, entering)};
+    for ( std::size_t column {0}; column != width; ++column ) {
+      at(leaving, column) /= pivot;
+    }
+    for ( std::size_t row {0}; row <= rows; ++row ) {
+      const double factor {at(row, entering)};
+      if ( row == leaving || (factor < epsilon && factor > -epsilon) ) {
+        continue;
+      }
+      for ( std::size_t column {0}; column != width; ++column ) {
+        at(row, column) -= factor * at(leaving, column);
+      }
+    }
+    basis[leaving] = entering;
+  }
+
+  const double total {at(rows, width - 1)};
+  Game_solution solution {std::vector<double>(rows, 0.0),
+                          std::vector<double>(columns, 0.0),
+                          1.0 / total - shift};
+  for ( std::size_t row {0}; row != rows; ++row ) {
+    if ( basis[row] < columns ) {
+      solution.column_strategy[basis[row]] = at(row, width - 1) / total;
+    }
+    solution.row_strategy[row] = at(rows, columns + row) / total;
+  }
+  return solution;
+}
@@ -0,0 +1,144 @@
+#include "numa.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "parallel.h"
+
+auto parse_cpu_list(const std::string& list) -> std::vector<int>
+{
+  std::vector<int> cpus;
+  std::size_t position {0};
+
+  const auto number = [&]() -> int {
+    const std::size_t start {position};
+    while ( position < list.size()
+            && std::isdigit(static_cast<unsigned char>(list[position]))
+                   != 0 ) {
+      ++position;
+    }
+    if ( position == start ) {
+      throw std::invalid_argument {"Malformed CPU list: " + list};
+    }
+    return std::stoi(list.substr(start, position - start));
+  };
+
+  while ( position < list.size() && list[position] != '\n' ) {
+    const int first {number()};
+    int last {first};
+    if ( position < list.size() && list[position] == '-' ) {
+      ++position;
+      last = number();
+    }
+    for ( int cpu {first}; cpu <= last; ++cpu ) {
+      cpus.push_back(cpu);
+    }
+    if ( position < list.size() && list[position] == ',' ) {
+      ++position;
+    }
+  }
+  return cpus;
+}
+
+auto pin_current_thread(const int cpu) noexcept -> bool
+{
+  if ( cpu < 0 || cpu >= CPU_SETSIZE ) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(static_cast<std::size_t>(cpu), &set);
+  return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set)
+      == 0;
+}
+
+Numa_topology::Numa_topology()
+{
+  const auto threads = static_cast<int>(hardware_threads());
+  Numa_node node {0, {}};
+  for ( int cpu {0}; cpu != threads; ++cpu ) {
+    node.cpus.push_back(cpu);
+  }
+  m_nodes.push_back(std::move(node));
+  m_node_of_cpu.assign(static_cast<std::size_t>(threads), 0);
+}
+
+Numa_topology::Numa_topology(std::vector<Numa_node> nodes)
+{
+  for ( Numa_node& node : nodes ) {
+    if ( !node.cpus.empty() ) {
+      m_nodes.push_back(std::move(node));
+    }
+  }
+  if ( m_nodes.empty() ) {
+    *this = Numa_topology {};
+    return;
+  }
+  std::sort(m_nodes.begin(), m_nodes.end(),
+            [](const Numa_node& lhs, const Numa_node& rhs) {
+              return lhs.id < rhs.id;
+            });
+
+  for ( std::size_t index {0}; index != m_nodes.size(); ++index ) {
+    for ( const int cpu : m_nodes[index].cpus ) {
+      const auto at = static_cast<std::size_t>(cpu);
+      if ( at >= m_node_of_cpu.size() ) {
+        m_node_of_cpu.resize(at + 1, 0);
+      }
+      m_node_of_cpu[at] = index;
+    }
+  }
+}
+
+auto Numa_topology::discover(const std::string& root) -> Numa_topology
+{
+  namespace fs = std::filesystem;
+
+  std::vector<Numa_node> nodes;
+  std::error_code error;
+  for ( fs::directory_iterator entry {root, error}, end;
+        !error && entry != end; entry.increment(error) ) {
+    const std::string name {entry->path().filename().string()};
+    if ( name.size() <= 4 || name.compare(0, 4, "node") != 0
+         || !std::all_of(name.begin() + 4, name.end(), [](const char c) {
+              return std::isdigit(static_cast<unsigned char>(c)) != 0;
+            }) ) {
+      continue;
+    }
+
+    std::ifstream file {entry->path() / "cpulist"};
+    std::string list;
+    if ( std::getline(file, list) ) {
+      nodes.push_back({std::stoi(name.substr(4)), parse_cpu_list(list)});
+    }
+  }
+
+  return Numa_topology {std::move(nodes)};
+}
+
+auto Numa_topology::node_of_cpu(const int cpu) const noexcept
+    -> std::size_t
+{
+  const auto at = static_cast<std::size_t>(cpu);
+  return cpu >= 0 && at < m_node_of_cpu.size() ? m_node_of_cpu[at] : 0;
+}
+
+auto Numa_topology::current_node() const noexcept -> std::size_t
+{
+  return node_of_cpu(::sched_getcpu());
+}
+
+auto Numa_topology::cpu_for_worker(const std::size_t worker) const noexcept
+    -> int
+{
+  const std::vector<int>& cpus {m_nodes[node_for_worker(worker)].cpus};
+  return cpus[(worker / m_nodes.size()) % cpus.size()];
+}
@@ -0,0 +1,163 @@
+#include "page_mapping.h"
+
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+auto round_up(const std::size_t bytes, const std::size_t unit) noexcept
+    -> std::size_t
+{
+  return (bytes + unit - 1) / unit * unit;
+}
+
+auto map_anonymous(const std::size_t bytes, const int extra_flags) noexcept
+    -> void*
+{
+  return ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+}
+
+/// Value in kB of an smaps line such as "AnonHugePages:  4096 kB"
+auto kilobytes(const std::string& line) -> std::size_t
+{
+  std::istringstream fields {line.substr(line.find(':') + 1)};
+  std::size_t value {0};
+  fields >> value;
+  return value;
+}
+
+/// Parse an smaps header line, which starts "start-end perms ..."
+auto mapping_range(const std::string& line, std::uintptr_t& first,
+                   std::uintptr_t& last) -> bool
+{
+  const std::size_t dash {line.find('-')};
+  const std::size_t space {line.find(' ')};
+  if ( dash == std::string::npos || space == std::string::npos
+       || dash > space || line.find(':') < space ) {
+    return false;
+  }
+  first = std::stoull(line.substr(0, dash), nullptr, 16);
+  last  = std::stoull(line.substr(dash + 1, space - dash - 1), nullptr,
+                      16);
+  return true;
+}
+
+} // namespace
+
+auto smaps_coverage(std::istream& smaps, const std::uintptr_t begin,
+                    const std::uintptr_t end) -> Huge_page_coverage
+{
+  Huge_page_coverage coverage;
+  std::size_t overlap {0};
+  std::string line;
+
+  while ( std::getline(smaps, line) ) {
+    std::uintptr_t first {0};
+    std::uintptr_t last {0};
+    if ( mapping_range(line, first, last) ) {
+      // the kernel may merge our mapping with its neighbours
+      overlap = std::max(first, begin) < std::min(last, end)
+                  ? std::min(last, end) - std::max(first, begin)
+                  : 0;
+      coverage.bytes += overlap;
+      continue;
+    }
+    if ( overlap == 0 ) {
+      continue;
+    }
+    if ( line.compare(0, 15, "KernelPageSize:") == 0
+         && kilobytes(line) * 1024 >= huge_page_size ) {
+      coverage.huge_bytes += overlap;
+      overlap = 0;
+    } else if ( line.compare(0, 14, "AnonHugePages:") == 0 ) {
+      coverage.huge_bytes += std::min(kilobytes(line) * 1024, overlap);
+    }
+  }
+  return coverage;
+}
+
+Page_mapping::Page_mapping(const std::size_t bytes, const bool huge)
+{
+  const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+  if ( huge ) {
+    m_size = round_up(bytes, huge_page_size);
+    void* address {map_anonymous(m_size, MAP_HUGETLB)};
+    if ( address != MAP_FAILED ) {
+      m_data    = static_cast<unsigned char*>(address);
+      m_backing = Page_backing::huge_tlb;
+      return;
+    }
+
+    // no reserved huge pages: over-map, trim to 2 MB alignment, advise
+    address = map_anonymous(m_size + huge_page_size, 0);
+    if ( address == MAP_FAILED ) {
+      throw std::bad_alloc {};
+    }
+    auto* const raw = static_cast<unsigned char*>(address);
+    const std::size_t lead {
+        round_up(reinterpret_cast<std::uintptr_t>(raw), huge_page_size)
+        - reinterpret_cast<std::uintptr_t>(raw)};
+    if ( lead != 0 ) {
+      ::munmap(raw, lead);
+    }
+    if ( huge_page_size - lead != 0 ) {
+      ::munmap(raw + lead + m_size, huge_page_size - lead);
+    }
+    m_data    = raw + lead;
+    m_backing = ::madvise(m_data, m_size, MADV_HUGEPAGE) == 0
+                  ? Page_backing::transparent
+                  : Page_backing::normal;
+    return;
+  }
+
+  m_size = round_up(std::max<std::size_t>(bytes, 1), page);
+  void* const address {map_anonymous(m_size, 0)};
+  if ( address == MAP_FAILED ) {
+    throw std::bad_alloc {};
+  }
+  m_data = static_cast<unsigned char*>(address);
+}
+
+Page_mapping::Page_mapping(Page_mapping&& other) noexcept
+    : m_data {std::exchange(other.m_data, nullptr)}
+    , m_size {std::exchange(other.m_size, 0)}
+    , m_backing {other.m_backing}
+{}
+
+auto Page_mapping::operator=(Page_mapping&& other) noexcept
+    -> Page_mapping&
+{
+  if ( this != &other ) {
+    Page_mapping discard {std::move(*this)};
+    m_data    = std::exchange(other.m_data, nullptr);
+    m_size    = std::exchange(other.m_size, 0);
+    m_backing = other.m_backing;
+  }
+  return *this;
+}
+
+Page_mapping::~Page_mapping()
+{
+  if ( m_data != nullptr ) {
+    ::munmap(m_data, m_size);
+  }
+}
+
+auto Page_mapping::coverage() const -> Huge_page_coverage
+{
+  if ( m_data == nullptr ) {
+    return {};
+  }
+  std::ifstream smaps {"/proc/self/smaps"};
+  const auto begin = reinterpret_cast<std::uintptr_t>(m_data);
+  return smaps_coverage(smaps, begin, begin + m_size);
+}
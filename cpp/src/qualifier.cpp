@@ -0,0 +1,249 @@
+#include "qualifier.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "bracket.h"
+#include "probability_table.h"
+#include "random.h"
+#include "task_graph.h"
+#include "tournament.h"
+
+namespace {
+
+/// Qualifiers of one stage for every trial of a batch
+struct Stage_output {
+  std::size_t advance;
+  /// `advance` slots per trial, padded with `bye_line`
+  std::vector<std::size_t> slots;
+
+  [[nodiscard]] auto trial(const std::size_t index) const noexcept
+      -> const std::size_t*
+  {
+    return slots.data() + index * advance;
+  }
+
+  void store(const std::size_t index,
+             const std::vector<std::size_t>& order) noexcept
+  {
+    std::copy(order.begin(), order.end(), slots.data() + index * advance);
+  }
+};
+
+struct Batch {
+  std::size_t first_trial;
+  std::size_t trials;
+  std::vector<Stage_output> districts;
+  std::vector<Stage_output> regions;
+  std::vector<std::size_t> reach_region;
+  std::vector<std::size_t> reach_state;
+  std::vector<std::size_t> places;
+};
+
+void validate(const std::vector<Wrestler>& roster,
+              const Qualifier_format& format)
+{
+  for ( const Qualifier_district& district : format.districts ) {
+    if ( district.region >= format.regions ) {
+      throw std::out_of_range {"District feeds an unknown region"};
+    }
+    for ( const std::size_t slot : district.entrants ) {
+      if ( slot >= roster.size() ) {
+        throw std::out_of_range {"District entrant not on the roster"};
+      }
+    }
+  }
+}
+
+} // namespace
+
+auto Qualifier_odds::placed(const std::size_t slot) const noexcept
+    -> double
+{
+  double total {0.0};
+  for ( std::size_t place {1}; place <= state_places; ++place ) {
+    total += this->place(slot, place);
+  }
+  return total;
+}
+
+auto simulate_qualifiers(const std::vector<Wrestler>& roster,
+                         const Qualifier_format& format,
+                         const Qualifier_params& params) -> Qualifier_odds
+{
+  validate(roster, format);
+
+  const Probability_table table {roster};
+  std::vector<int> ability(roster.size());
+  for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+    ability[slot] = roster[slot].ability();
+  }
+
+  const std::size_t district_count {format.districts.size()};
+  const std::size_t stages {district_count + format.regions + 1};
+  std::vector<std::vector<std::size_t>> district_lines;
+  std::vector<std::vector<std::size_t>> districts_of(format.regions);
+  for ( std::size_t district {0}; district != district_count;
+        ++district ) {
+    district_lines.push_back(
+        seeded_lines(format.districts[district].entrants, ability));
+    districts_of[format.districts[district].region].push_back(district);
+  }
+
+  const std::size_t batch_size {std::max<std::size_t>(1, params.batch)};
+  std::vector<Batch> batches;
+  for ( std::size_t first {0}; first < params.trials;
+        first += batch_size ) {
+    const std::size_t trials {std::min(batch_size, params.trials - first)};
+    batches.push_back(
+        {first, trials,
+         std::vector<Stage_output>(
+             district_count,
+             {format.district_advance,
+              std::vector<std::size_t>(trials * format.district_advance,
+                                       bye_line)}),
+         std::vector<Stage_output>(
+             format.regions,
+             {format.region_advance,
+              std::vector<std::size_t>(trials * format.region_advance,
+                                       bye_line)}),
+         std::vector<std::size_t>(roster.size(), 0),
+         std::vector<std::size_t>(roster.size(), 0),
+         std::vector<std::size_t>(roster.size() * format.state_places,
+                                  0)});
+  }
+
+  const auto stream = [&](const std::size_t trial,
+                          const std::size_t stage) {
+    return static_cast<std::uint64_t>(trial * stages + stage);
+  };
+
+  Task_graph graph;
+  for ( Batch& batch : batches ) {
+    std::vector<Task_graph::Task_id> district_tasks;
+    for ( std::size_t district {0}; district != district_count;
+          ++district ) {
+      district_tasks.push_back(graph.add([&, district] {
+        for ( std::size_t trial {0}; trial != batch.trials; ++trial ) {
+          Rng rng {params.seed,
+                   stream(batch.first_trial + trial, district)};
+          batch.districts[district].store(
+              trial, simulate_bracket(district_lines[district], table, rng,
+                                      format.district_advance));
+        }
+      }));
+    }
+
+    std::vector<Task_graph::Task_id> region_tasks;
+    for ( std::size_t region {0}; region != format.regions; ++region ) {
+      std::vector<Task_graph::Task_id> after;
+      for ( const std::size_t district : districts_of[region] ) {
+        after.push_back(district_tasks[district]);
+      }
+      region_tasks.push_back(graph.add(
+          [&, region] {
+            std::vector<std::size_t> field;
+            for ( std::size_t trial {0}; trial != batch.trials;
+                  ++trial ) {
+              field.clear();
+              for ( const std::size_t district : districts_of[region] ) {
+                const Stage_output& output {batch.districts[district]};
+                const std::size_t* const qualifiers {output.trial(trial)};
+                for ( std::size_t place {0}; place != output.advance;
+                      ++place ) {
+                  if ( qualifiers[place] != bye_line ) {
+                    field.push_back(qualifiers[place]);
+                  }
+                }
+              }
+              Rng rng {params.seed, stream(batch.first_trial + trial,
+                                           district_count + region)};
+              batch.regions[region].store(
+                  trial,
+                  simulate_bracket(seeded_lines(field, ability), table,
+                                   rng, format.region_advance));
+            }
+          },
+          after));
+    }
+
+    graph.add(
+        [&] {
+          std::vector<std::size_t> field;
+          for ( std::size_t trial {0}; trial != batch.trials; ++trial ) {
+            field.clear();
+            for ( const Stage_output& output : batch.regions ) {
+              const std::size_t* const qualifiers {output.trial(trial)};
+              for ( std::size_t place {0}; place != output.advance;
+                    ++place ) {
+                if ( qualifiers[place] != bye_line ) {
+                  field.push_back(qualifiers[place]);
+                }
+              }
+            }
+            for ( std::size_t district {0}; district != district_count;
+                  ++district ) {
+              const Stage_output& output {batch.districts[district]};
+              for ( std::size_t place {0}; place != output.advance;
+                    ++place ) {
+                const std::size_t slot {output.trial(trial)[place]};
+                if ( slot != bye_line ) {
+                  ++batch.reach_region[slot];
+                }
+              }
+            }
+            for ( const std::size_t slot : field ) {
+              ++batch.reach_state[slot];
+            }
+
+            Rng rng {params.seed,
+                     stream(batch.first_trial + trial, stages - 1)};
+            const std::vector<std::size_t> order {
+                simulate_bracket(seeded_lines(field, ability), table, rng,
+                                 format.state_places)};
+            for ( std::size_t place {0}; place != order.size(); ++place ) {
+              ++batch.places[order[place] * format.state_places + place];
+            }
+          }
+        },
+        region_tasks);
+  }
+
+  graph.run(params.threads);
+
+  Qualifier_odds odds {params.trials, format.state_places,
+                       std::vector<double>(roster.size(), 0.0),
+                       std::vector<double>(roster.size(), 0.0),
+                       std::vector<double>(
+                           roster.size() * format.state_places, 0.0)};
+  if ( params.trials == 0 ) {
+    return odds;
+  }
+
+  // sum the integer tallies first so the odds do not depend on batching
+  std::vector<std::size_t> reach_region(roster.size(), 0);
+  std::vector<std::size_t> reach_state(roster.size(), 0);
+  std::vector<std::size_t> places(odds.place_probability.size(), 0);
+  for ( const Batch& batch : batches ) {
+    for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+      reach_region[slot] += batch.reach_region[slot];
+      reach_state[slot] += batch.reach_state[slot];
+    }
+    for ( std::size_t cell {0}; cell != places.size(); ++cell ) {
+      places[cell] += batch.places[cell];
+    }
+  }
+
+  const auto trials = static_cast<double>(params.trials);
+  for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+    odds.reach_region[slot] =
+        static_cast<double>(reach_region[slot]) / trials;
+    odds.reach_state[slot] =
+        static_cast<double>(reach_state[slot]) / trials;
+  }
+  for ( std::size_t cell {0}; cell != places.size(); ++cell ) {
+    odds.place_probability[cell] =
+        static_cast<double>(places[cell]) / trials;
+  }
+  return odds;
+}
@@ -0,0 +1,157 @@
+#include "range_index.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+/// Add `[begin, end)`, merging it into the last slice if they touch
+void append_slice(std::vector<Index_slice>& slices,
+                  const std::size_t begin, const std::size_t end)
+{
+  if ( begin == end ) {
+    return;
+  }
+  if ( !slices.empty() && slices.back().end == begin ) {
+    slices.back().end = end;
+  } else {
+    slices.push_back({begin, end});
+  }
+}
+
+} // namespace
+
+Range_index::Range_index(const Span<const std::int32_t> weights,
+                         const Span<const std::int32_t> ages)
+{
+  build(weights, ages);
+}
+
+Range_index::Range_index(const std::vector<Wrestler>& roster)
+{
+  std::vector<std::int32_t> weights;
+  std::vector<std::int32_t> ages;
+  weights.reserve(roster.size());
+  ages.reserve(roster.size());
+  for ( const Wrestler& wrestler : roster ) {
+    weights.push_back(wrestler.weight());
+    ages.push_back(wrestler.age());
+  }
+  build({weights.data(), weights.size()}, {ages.data(), ages.size()});
+}
+
+void Range_index::build(const Span<const std::int32_t> weights,
+                        const Span<const std::int32_t> ages)
+{
+  if ( weights.size() != ages.size() ) {
+    throw std::invalid_argument {
+        "Weight and age columns differ in length"};
+  }
+  if ( weights.size() > std::numeric_limits<std::uint32_t>::max() ) {
+    throw std::invalid_argument {"Too many rows to index"};
+  }
+
+  // one 64-bit key per row orders by weight, then age; the row number
+  // breaks ties so the layout is fully determined
+  const auto biased = [](const std::int32_t value) {
+    return std::uint64_t {static_cast<std::uint32_t>(value) ^ 0x80000000U};
+  };
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> keys(
+      weights.size());
+  for ( std::size_t row {0}; row != keys.size(); ++row ) {
+    keys[row] = {biased(weights[row]) << 32U | biased(ages[row]),
+                 static_cast<std::uint32_t>(row)};
+  }
+  std::sort(keys.begin(), keys.end());
+
+  m_weight.reserve(keys.size());
+  m_age.reserve(keys.size());
+  m_row.reserve(keys.size());
+  for ( const auto& [key, row] : keys ) {
+    m_weight.push_back(weights[row]);
+    m_age.push_back(ages[row]);
+    m_row.push_back(row);
+  }
+  for ( std::size_t first {0}; first < m_age.size();
+        first += block_rows ) {
+    const auto [min, max] = std::minmax_element(
+        m_age.begin() + static_cast<std::ptrdiff_t>(first),
+        m_age.begin()
+            + static_cast<std::ptrdiff_t>(
+                std::min(first + block_rows, m_age.size())));
+    m_zones.push_back({*min, *max});
+  }
+}
+
+void Range_index::query(const Range_query& query,
+                        std::vector<Index_slice>& out) const
+{
+  out.clear();
+  if ( query.min_weight > query.max_weight
+       || query.min_age > query.max_age ) {
+    return;
+  }
+  const std::size_t first {static_cast<std::size_t>(
+      std::lower_bound(m_weight.begin(), m_weight.end(), query.min_weight)
+      - m_weight.begin())};
+  const std::size_t last {static_cast<std::size_t>(
+      std::upper_bound(
+          m_weight.begin() + static_cast<std::ptrdiff_t>(first),
+          m_weight.end(), query.max_weight)
+      - m_weight.begin())};
+
+  for ( std::size_t block {first / block_rows};
+        block * block_rows < last; ++block ) {
+    const std::size_t begin {std::max(first, block * block_rows)};
+    const std::size_t end {std::min(last, (block + 1) * block_rows)};
+    const Age_zone& zone {m_zones[block]};
+    if ( zone.max < query.min_age || zone.min > query.max_age ) {
+      continue;
+    }
+    if ( zone.min >= query.min_age && zone.max <= query.max_age ) {
+      append_slice(out, begin, end);
+      continue;
+    }
+    std::size_t run {begin};
+    for ( std::size_t position {begin}; position != end; ++position ) {
+      const std::int32_t age {m_age[position]};
+      if ( age < query.min_age || age > query.max_age ) {
+        append_slice(out, run, position);
+        run = position + 1;
+      }
+    }
+    append_slice(out, run, end);
+  }
+}
+
+auto Range_index::query(const Range_query& query) const
+    -> std::vector<Index_slice>
+{
+  std::vector<Index_slice> slices;
+  this->query(query, slices);
+  return slices;
+}
+
+auto Range_index::bitmap(const Range_query& query) const
+    -> std::vector<std::uint64_t>
+{
+  std::vector<std::uint64_t> bits((size() + 63) / 64, 0);
+  for ( const Index_slice& slice : this->query(query) ) {
+    for ( const std::uint32_t row : rows(slice) ) {
+      bits[row / 64] |= std::uint64_t {1} << (row % 64);
+    }
+  }
+  return bits;
+}
+
+auto slice_rows(const std::vector<Index_slice>& slices) noexcept
+    -> std::size_t
+{
+  std::size_t rows {0};
+  for ( const Index_slice& slice : slices ) {
+    rows += slice.end - slice.begin;
+  }
+  return rows;
+}
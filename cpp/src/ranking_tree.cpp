@@ -0,0 +1,451 @@
+#include "ranking_tree.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+auto same(const Ranked& lhs, const Ranked& rhs) noexcept -> bool
+{
+  return lhs.ability == rhs.ability && lhs.id == rhs.id;
+}
+
+} // namespace
+
+auto Ranking_tree::allocate(const bool leaf) -> std::uint32_t
+{
+  std::uint32_t node {};
+  if ( m_free.empty() ) {
+    node = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+  } else {
+    node = m_free.back();
+    m_free.pop_back();
+    m_nodes[node] = {};
+  }
+  m_nodes[node].leaf = leaf;
+  return node;
+}
+
+void Ranking_tree::release(const std::uint32_t node)
+{
+  m_free.push_back(node);
+}
+
+auto Ranking_tree::entries(const std::uint32_t node) const noexcept
+    -> std::uint32_t
+{
+  const Node& current {m_nodes[node]};
+  if ( current.leaf ) {
+    return current.size;
+  }
+  std::uint32_t total {0};
+  for ( std::uint32_t child {0}; child != current.size; ++child ) {
+    total += current.counts[child];
+  }
+  return total;
+}
+
+auto Ranking_tree::child_for(const std::uint32_t node,
+                             const Ranked& key) const noexcept
+    -> std::size_t
+{
+  const Node& current {m_nodes[node]};
+  const auto after = std::upper_bound(
+      current.keys.begin() + 1, current.keys.begin() + current.size, key,
+      ranks_before);
+  return static_cast<std::size_t>(after - current.keys.begin()) - 1;
+}
+
+auto Ranking_tree::insert_into(const std::uint32_t node, const Ranked& key,
+                               bool& inserted) -> std::uint32_t
+{
+  if ( m_nodes[node].leaf ) {
+    Node& leaf {m_nodes[node]};
+    const auto end = leaf.keys.begin() + leaf.size;
+    const auto position =
+        std::lower_bound(leaf.keys.begin(), end, key, ranks_before);
+    if ( position != end && same(*position, key) ) {
+      inserted = false;
+      return none;
+    }
+    std::copy_backward(position, end, end + 1);
+    *position = key;
+    ++leaf.size;
+    inserted = true;
+    if ( leaf.size <= node_capacity ) {
+      return none;
+    }
+
+    const std::uint32_t right {allocate(true)};
+    Node& full {m_nodes[node]};
+    Node& sibling {m_nodes[right]};
+    const std::uint32_t keep {full.size / 2};
+    sibling.size = full.size - keep;
+    std::copy_n(full.keys.begin() + keep, sibling.size,
+                sibling.keys.begin());
+    full.size    = keep;
+    sibling.next = full.next;
+    full.next    = right;
+    return right;
+  }
+
+  const std::size_t child {child_for(node, key)};
+  const std::uint32_t split {
+      insert_into(m_nodes[node].children[child], key, inserted)};
+  if ( !inserted ) {
+    return none;
+  }
+  Node& parent {m_nodes[node]};
+  ++parent.counts[child];
+  if ( ranks_before(key, parent.keys[child]) ) {
+    parent.keys[child] = key;
+  }
+  if ( split == none ) {
+    return none;
+  }
+
+  // the new sibling goes right after the child that split
+  const auto at = static_cast<std::ptrdiff_t>(child + 1);
+  const auto end = static_cast<std::ptrdiff_t>(parent.size);
+  std::copy_backward(parent.keys.begin() + at, parent.keys.begin() + end,
+                     parent.keys.begin() + end + 1);
+  std::copy_backward(parent.children.begin() + at,
+                     parent.children.begin() + end,
+                     parent.children.begin() + end + 1);
+  std::copy_backward(parent.counts.begin() + at,
+                     parent.counts.begin() + end,
+                     parent.counts.begin() + end + 1);
+  parent.keys[child + 1]     = m_nodes[split].keys[0];
+  parent.children[child + 1] = split;
+  parent.counts[child + 1]   = entries(split);
+  parent.counts[child] -= parent.counts[child + 1];
+  ++parent.size;
+  if ( parent.size <= node_capacity ) {
+    return none;
+  }
+
+  const std::uint32_t right {allocate(false)};
+  Node& full {m_nodes[node]};
+  Node& sibling {m_nodes[right]};
+  const std::uint32_t keep {full.size / 2};
+  sibling.size = full.size - keep;
+  std::copy_n(full.keys.begin() + keep, sibling.size,
+              sibling.keys.begin());
+  std::copy_n(full.children.begin() + keep, sibling.size,
+              sibling.children.begin());
+  std::copy_n(full.counts.begin() + keep, sibling.size,
+              sibling.counts.begin());
+  full.size = keep;
+  return right;
+}
+
+auto Ranking_tree::insert(const Ranked& key) -> bool
+{
+  if ( m_root == none ) {
+    m_root = allocate(true);
+  }
+  bool inserted {false};
+  const std::uint32_t split {insert_into(m_root, key, inserted)};
+  if ( split != none ) {
+    const std::uint32_t root {allocate(false)};
+    Node& top {m_nodes[root]};
+    top.size        = 2;
+    top.keys[0]     = m_nodes[m_root].keys[0];
+    top.keys[1]     = m_nodes[split].keys[0];
+    top.children[0] = m_root;
+    top.children[1] = split;
+    top.counts[0]   = entries(m_root);
+    top.counts[1]   = entries(split);
+    m_root          = root;
+  }
+  m_size += inserted ? 1 : 0;
+  return inserted;
+}
+
+void Ranking_tree::rebalance(const std::uint32_t node,
+                             const std::size_t child)
+{
+  Node& parent {m_nodes[node]};
+  const std::size_t left {child == 0 ? 0 : child - 1};
+  Node& lhs {m_nodes[parent.children[left]]};
+  Node& rhs {m_nodes[parent.children[left + 1]]};
+  const std::uint32_t combined {lhs.size + rhs.size};
+
+  if ( combined <= node_capacity ) {
+    // merge the right node into the left and drop it from the parent
+    std::copy_n(rhs.keys.begin(), rhs.size, lhs.keys.begin() + lhs.size);
+    std::copy_n(rhs.children.begin(), rhs.size,
+                lhs.children.begin() + lhs.size);
+    std::copy_n(rhs.counts.begin(), rhs.size,
+                lhs.counts.begin() + lhs.size);
+    lhs.size = combined;
+    lhs.next = rhs.next;
+    release(parent.children[left + 1]);
+
+    parent.keys[left] = lhs.keys[0];
+    parent.counts[left] += parent.counts[left + 1];
+    const auto from = static_cast<std::ptrdiff_t>(left + 2);
+    const auto end = static_cast<std::ptrdiff_t>(parent.size);
+    std::copy(parent.keys.begin() + from, parent.keys.begin() + end,
+              parent.keys.begin() + from - 1);
+    std::copy(parent.children.begin() + from,
+              parent.children.begin() + end,
+              parent.children.begin() + from - 1);
+    std::copy(parent.counts.begin() + from, parent.counts.begin() + end,
+              parent.counts.begin() + from - 1);
+    --parent.size;
+    return;
+  }
+
+  // otherwise share the entries evenly between the two
+  const std::uint32_t keep {combined / 2};
+  if ( lhs.size > keep ) {
+    const std::uint32_t moved {lhs.size - keep};
+    std::copy_backward(rhs.keys.begin(), rhs.keys.begin() + rhs.size,
+                       rhs.keys.begin() + rhs.size + moved);
+    std::copy_backward(rhs.children.begin(),
+                       rhs.children.begin() + rhs.size,
+                       rhs.children.begin() + rhs.size + moved);
+    std::copy_backward(rhs.counts.begin(), rhs.counts.begin() + rhs.size,
+                       rhs.counts.begin() + rhs.size + moved);
+    std::copy_n(lhs.keys.begin() + keep, moved, rhs.keys.begin());
+    std::copy_n(lhs.children.begin() + keep, moved, rhs.children.begin());
+    std::copy_n(lhs.counts.begin() + keep, moved, rhs.counts.begin());
+  } else {
+    const std::uint32_t moved {keep - lhs.size};
+    std::copy_n(rhs.keys.begin(), moved, lhs.keys.begin() + lhs.size);
+    std::copy_n(rhs.children.begin(), moved,
+                lhs.children.begin() + lhs.size);
+    std::copy_n(rhs.counts.begin(), moved, lhs.counts.begin() + lhs.size);
+    std::copy(rhs.keys.begin() + moved, rhs.keys.begin() + rhs.size,
+              rhs.keys.begin());
+    std::copy(rhs.children.begin() + moved,
+              rhs.children.begin() + rhs.size, rhs.children.begin());
+    std::copy(rhs.counts.begin() + moved, rhs.counts.begin() + rhs.size,
+              rhs.counts.begin());
+  }
+  rhs.size = combined - keep;
+  lhs.size = keep;
+  parent.keys[left]       = lhs.keys[0];
+  parent.keys[left + 1]   = rhs.keys[0];
+  parent.counts[left]     = entries(parent.children[left]);
+  parent.counts[left + 1] = entries(parent.children[left + 1]);
+}
+
+auto Ranking_tree::erase_from(const std::uint32_t node, const Ranked& key)
+    -> bool
+{
+  if ( m_nodes[node].leaf ) {
+    Node& leaf {m_nodes[node]};
+    const auto end = leaf.keys.begin() + leaf.size;
+    const auto position =
+        std::lower_bound(leaf.keys.begin(), end, key, ranks_before);
+    if ( position == end || !same(*position, key) ) {
+      return false;
+    }
+    std::copy(position + 1, end, position);
+    --leaf.size;
+    return true;
+  }
+
+  const std::size_t child {child_for(node, key)};
+  const std::uint32_t below {m_nodes[node].children[child]};
+  if ( !erase_from(below, key) ) {
+    return false;
+  }
+  Node& parent {m_nodes[node]};
+  --parent.counts[child];
+  if ( m_nodes[below].size != 0 ) {
+    parent.keys[child] = m_nodes[below].keys[0];
+  }
+  if ( m_nodes[below].size < min_fill && parent.size > 1 ) {
+    rebalance(node, child);
+  }
+  return true;
+}
+
+auto Ranking_tree::erase(const Ranked& key) -> bool
+{
+  if ( m_root == none || !erase_from(m_root, key) ) {
+    return false;
+  }
+  --m_size;
+  const Node& root {m_nodes[m_root]};
+  if ( !root.leaf && root.size == 1 ) {
+    release(m_root);
+    m_root = root.children[0];
+  }
+  return true;
+}
+
+auto Ranking_tree::contains(const Ranked& key) const noexcept -> bool
+{
+  if ( m_root == none ) {
+    return false;
+  }
+  std::uint32_t node {m_root};
+  while ( !m_nodes[node].leaf ) {
+    node = m_nodes[node].children[child_for(node, key)];
+  }
+  const Node& leaf {m_nodes[node]};
+  const auto end = leaf.keys.begin() + leaf.size;
+  const auto position =
+      std::lower_bound(leaf.keys.begin(), end, key, ranks_before);
+  return position != end && same(*position, key);
+}
+
+auto Ranking_tree::position(const Ranked& key) const noexcept
+    -> std::size_t
+{
+  if ( m_root == none ) {
+    return 0;
+  }
+  std::size_t before {0};
+  std::uint32_t node {m_root};
+  while ( !m_nodes[node].leaf ) {
+    const Node& current {m_nodes[node]};
+    const std::size_t child {child_for(node, key)};
+    for ( std::size_t sibling {0}; sibling != child; ++sibling ) {
+      before += current.counts[sibling];
+    }
+    node = current.children[child];
+  }
+  const Node& leaf {m_nodes[node]};
+  return before
+       + static_cast<std::size_t>(
+             std::lower_bound(leaf.keys.begin(),
+                              leaf.keys.begin() + leaf.size, key,
+                              ranks_before)
+             - leaf.keys.begin());
+}
+
+auto Ranking_tree::select(std::size_t position) const noexcept -> Ranked
+{
+  std::uint32_t node {m_root};
+  while ( !m_nodes[node].leaf ) {
+    const Node& current {m_nodes[node]};
+    std::size_t child {0};
+    while ( position >= current.counts[child] ) {
+      position -= current.counts[child];
+      ++child;
+    }
+    node = current.children[child];
+  }
+  return m_nodes[node].keys[position];
+}
+
+void Ranking_tree::read(std::size_t first, const std::size_t count,
+                        std::vector<Ranked>& out) const
+{
+  out.clear();
+  if ( first >= m_size || count == 0 ) {
+    return;
+  }
+  std::uint32_t node {m_root};
+  while ( !m_nodes[node].leaf ) {
+    const Node& current {m_nodes[node]};
+    std::size_t child {0};
+    while ( first >= current.counts[child] ) {
+      first -= current.counts[child];
+      ++child;
+    }
+    node = current.children[child];
+  }
+  while ( node != none && out.size() != count ) {
+    const Node& leaf {m_nodes[node]};
+    for ( ; first != leaf.size && out.size() != count; ++first ) {
+      out.push_back(leaf.keys[first]);
+    }
+    node  = leaf.next;
+    first = 0;
+  }
+}
+
+Class_rankings::Class_rankings(const std::size_t classes)
+    : m_trees(classes)
+{}
+
+auto Class_rankings::entry(const int id) const -> const Entry&
+{
+  const auto found = m_entries.find(id);
+  if ( found == m_entries.end() ) {
+    throw std::out_of_range {"Wrestler " + std::to_string(id)
+                             + " is not ranked"};
+  }
+  return found->second;
+}
+
+auto Class_rankings::tree(const std::size_t weight_class) const
+    -> const Ranking_tree&
+{
+  if ( weight_class >= m_trees.size() ) {
+    throw std::out_of_range {"No weight class "
+                             + std::to_string(weight_class)};
+  }
+  return m_trees[weight_class];
+}
+
+void Class_rankings::add(const Wrestler& wrestler,
+                         const std::size_t weight_class)
+{
+  static_cast<void>(tree(weight_class));
+  if ( !m_entries.emplace(wrestler.id(),
+                          Entry {weight_class, wrestler.ability()})
+            .second ) {
+    throw std::invalid_argument {"Wrestler "
+                                 + std::to_string(wrestler.id())
+                                 + " is already ranked"};
+  }
+  m_trees[weight_class].insert({wrestler.ability(), wrestler.id()});
+}
+
+void Class_rankings::remove(const int id)
+{
+  const Entry found {entry(id)};
+  m_trees[found.weight_class].erase({found.ability, id});
+  m_entries.erase(id);
+}
+
+void Class_rankings::update(const int id, const int ability)
+{
+  static_cast<void>(entry(id));
+  Entry& found {m_entries[id]};
+  Ranking_tree& ranking {m_trees[found.weight_class]};
+  ranking.erase({found.ability, id});
+  ranking.insert({ability, id});
+  found.ability = ability;
+}
+
+auto Class_rankings::size(const std::size_t weight_class) const
+    -> std::size_t
+{
+  return tree(weight_class).size();
+}
+
+auto Class_rankings::rank(const int id) const -> std::size_t
+{
+  const Entry& found {entry(id)};
+  return m_trees[found.weight_class].position({found.ability, id}) + 1;
+}
+
+auto Class_rankings::at(const std::size_t weight_class,
+                        const std::size_t rank) const -> Ranked
+{
+  const Ranking_tree& ranking {tree(weight_class)};
+  if ( rank == 0 || rank > ranking.size() ) {
+    throw std::out_of_range {"No wrestler ranked "
+                             + std::to_string(rank)};
+  }
+  return ranking.select(rank - 1);
+}
+
+auto Class_rankings::top(const std::size_t weight_class,
+                         const std::size_t count) const
+    -> std::vector<Ranked>
+{
+  std::vector<Ranked> best;
+  tree(weight_class).read(0, count, best);
+  return best;
+}
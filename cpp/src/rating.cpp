@@ -0,0 +1,163 @@
+#include "rating.h"
+
+#include <cmath>
+
+namespace {
+
+/// Ratio between the Glicko and Glicko-2 scales
+constexpr double glicko2_scale {173.7178};
+constexpr double pi {3.14159265358979323846};
+constexpr double volatility_epsilon {1e-6};
+constexpr int max_volatility_iterations {64};
+
+auto g_factor(const double phi) noexcept -> double
+{
+  return 1.0 / std::sqrt(1.0 + 3.0 * phi * phi / (pi * pi));
+}
+
+/// New volatility by the Illinois iteration of Glickman's step 5
+auto next_volatility(const Glicko2_engine::State& self, const double delta,
+                     const double variance, const double tau) noexcept
+    -> double
+{
+  const double phi_sq {self.phi * self.phi};
+  const double delta_sq {delta * delta};
+  const double a {std::log(self.sigma * self.sigma)};
+  const double tau_sq {tau * tau};
+
+  const auto f = [&](const double x) {
+    const double ex {std::exp(x)};
+    const double denom {phi_sq + variance + ex};
+    return ex * (delta_sq - phi_sq - variance - ex) / (2.0 * denom * denom)
+         - (x - a) / tau_sq;
+  };
+
+  double lower {a};
+  double upper {};
+  if ( delta_sq > phi_sq + variance ) {
+    upper = std::log(delta_sq - phi_sq - variance);
+  } else {
+    int k {1};
+    while ( f(a - k * tau) < 0.0 && k < max_volatility_iterations ) {
+      ++k;
+    }
+    upper = a - k * tau;
+  }
+
+  double f_lower {f(lower)};
+  double f_upper {f(upper)};
+
+  for ( int iteration {0};
+        std::abs(upper - lower) > volatility_epsilon
+        && iteration != max_volatility_iterations;
+        ++iteration ) {
+    const double next {lower
+                       + (lower - upper) * f_lower / (f_upper - f_lower)};
+    const double f_next {f(next)};
+    if ( f_next * f_upper <= 0.0 ) {
+      lower   = upper;
+      f_lower = f_upper;
+    } else {
+      f_lower /= 2.0;
+    }
+    upper   = next;
+    f_upper = f_next;
+  }
+
+  return std::exp(lower / 2.0);
+}
+
+auto glicko2_step(const Glicko2_engine::State& self,
+                  const Glicko2_engine::State& opponent,
+                  const double score, const double tau) noexcept
+    -> Glicko2_engine::State
+{
+  const double g {g_factor(opponent.phi)};
+  const double expected {
+      1.0 / (1.0 + std::exp(-g * (self.mu - opponent.mu)))};
+  const double variance {1.0 / (g * g * expected * (1.0 - expected))};
+  const double delta {variance * g * (score - expected)};
+
+  const double sigma {next_volatility(self, delta, variance, tau)};
+  const double phi_star {std::sqrt(self.phi * self.phi + sigma * sigma)};
+  const double phi {
+      1.0 / std::sqrt(1.0 / (phi_star * phi_star) + 1.0 / variance)};
+
+  return {self.mu + phi * phi * g * (score - expected), phi, sigma};
+}
+
+} // namespace
+
+Elo_engine::Elo_engine(const std::size_t slots, const Elo_params params)
+    : m_params {params}
+    , m_rating(slots, params.initial)
+{}
+
+void Elo_engine::update(const std::size_t winner,
+                        const std::size_t loser) noexcept
+{
+  const double shift {
+      m_params.k_factor
+      * (1.0 - expected_score(m_rating[winner], m_rating[loser]))};
+  m_rating[winner] += shift;
+  m_rating[loser] -= shift;
+}
+
+void Elo_engine::process(const Bout* first, const Bout* const last,
+                         const Slot_map& slots)
+{
+  for ( ; first != last; ++first ) {
+    const int winner {slots.slot(first->winner)};
+    const int loser {slots.slot(first->loser)};
+    if ( winner != Slot_map::npos && loser != Slot_map::npos ) {
+      update(static_cast<std::size_t>(winner),
+             static_cast<std::size_t>(loser));
+    }
+  }
+}
+
+Glicko2_engine::Glicko2_engine(const std::size_t slots,
+                               const Glicko2_params params)
+    : m_params {params}
+    , m_state(slots,
+              State {(params.initial_rating - 1500.0) / glicko2_scale,
+                     params.initial_deviation / glicko2_scale,
+                     params.initial_volatility})
+{}
+
+void Glicko2_engine::update(const std::size_t winner,
+                            const std::size_t loser) noexcept
+{
+  const State before_winner {m_state[winner]};
+  const State before_loser {m_state[loser]};
+
+  m_state[winner] =
+      glicko2_step(before_winner, before_loser, 1.0, m_params.tau);
+  m_state[loser] =
+      glicko2_step(before_loser, before_winner, 0.0, m_params.tau);
+}
+
+void Glicko2_engine::process(const Bout* first, const Bout* const last,
+                             const Slot_map& slots)
+{
+  for ( ; first != last; ++first ) {
+    const int winner {slots.slot(first->winner)};
+    const int loser {slots.slot(first->loser)};
+    if ( winner != Slot_map::npos && loser != Slot_map::npos ) {
+      update(static_cast<std::size_t>(winner),
+             static_cast<std::size_t>(loser));
+    }
+  }
+}
+
+auto Glicko2_engine::rating(const std::size_t slot) const noexcept
+    -> double
+{
+  return m_state[slot].mu * glicko2_scale + 1500.0;
+}
+
+auto Glicko2_engine::deviation(const std::size_t slot) const noexcept
+    -> double
+{
+  return m_state[slot].phi * glicko2_scale;
+}
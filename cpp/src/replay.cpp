@@ -0,0 +1,292 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+
+#include "random.h"
+#include "tournament.h"
+
+namespace {
+
+auto combine(std::uint64_t hash, const std::uint64_t value) noexcept
+    -> std::uint64_t
+{
+  hash ^= value;
+  return splitmix64(hash);
+}
+
+auto combine(const std::uint64_t hash, const int value) noexcept
+    -> std::uint64_t
+{
+  return combine(hash, static_cast<std::uint64_t>(value));
+}
+
+/// Scores, duration and result of a bout `winner` won with chance
+/// `chance`; always makes the same number of draws
+void score_bout(const Replay_rules& rules, const double chance, Rng& rng,
+                Bout_event& event) noexcept
+{
+  const double dominance {std::max(0.0, 2.0 * chance - 1.0)};
+  const double kind {rng.uniform()};
+  const double time {rng.uniform()};
+  const auto points = static_cast<int>(rng.below(8));
+
+  const double fall {0.10 + 0.30 * dominance};
+  const double tech_fall {fall + 0.10 + 0.20 * dominance};
+  const double major {tech_fall + 0.15 + 0.15 * dominance};
+  const auto early = static_cast<int>(
+      1.0 + std::floor(time * (rules.match_seconds - 1)));
+
+  int loser_score {points};
+  int margin {0};
+  int duration {rules.match_seconds};
+  if ( kind < fall ) {
+    event.result = Result_type::fall;
+    loser_score  = points / 2;
+    margin       = points - loser_score;
+    duration     = early;
+  } else if ( kind < tech_fall ) {
+    event.result = Result_type::tech_fall;
+    loser_score  = points / 2;
+    margin       = rules.tech_fall_margin;
+    duration     = early;
+  } else if ( kind < major ) {
+    event.result = Result_type::major_decision;
+    margin       = rules.major_margin
+           + static_cast<int>(std::floor(
+               time * (rules.tech_fall_margin - rules.major_margin)));
+  } else {
+    event.result = Result_type::decision;
+    margin =
+        1 + static_cast<int>(std::floor(time * (rules.major_margin - 1)));
+  }
+  event.loser_score  = static_cast<std::int16_t>(loser_score);
+  event.winner_score = static_cast<std::int16_t>(loser_score + margin);
+  event.duration     = static_cast<std::uint16_t>(duration);
+}
+
+auto injection_hash(const Injected_result& event) noexcept
+    -> std::uint64_t
+{
+  std::uint64_t hash {combine(combine(0, event.seed), event.replay)};
+  hash = combine(hash, std::uint64_t {event.slot});
+  hash = combine(hash, event.winner);
+  return combine(hash, static_cast<std::uint64_t>(event.result));
+}
+
+/// Injections sort by seed and replay, then by bout
+auto injected_before(const Injected_result& lhs,
+                     const Injected_result& rhs) noexcept -> bool
+{
+  return std::tie(lhs.seed, lhs.replay, lhs.slot)
+       < std::tie(rhs.seed, rhs.replay, rhs.slot);
+}
+
+} // namespace
+
+auto roster_hash(const std::vector<Wrestler>& roster) noexcept
+    -> std::uint64_t
+{
+  std::uint64_t hash {combine(0, std::uint64_t {roster.size()})};
+  for ( const Wrestler& wrestler : roster ) {
+    hash = combine(hash, wrestler.id());
+    hash = combine(hash, wrestler.age());
+    hash = combine(hash, wrestler.weight());
+    hash = combine(hash, wrestler.ability());
+  }
+  return hash;
+}
+
+auto rules_hash(const Replay_rules& rules) noexcept -> std::uint64_t
+{
+  std::uint64_t hash {combine(0, std::uint64_t {rules.places})};
+  hash = combine(hash, rules.match_seconds);
+  hash = combine(hash, rules.major_margin);
+  return combine(hash, rules.tech_fall_margin);
+}
+
+void Divergence_log::inject(const Injected_result& event)
+{
+  const auto position = std::lower_bound(
+      m_events.begin(), m_events.end(), event, injected_before);
+  if ( position != m_events.end()
+       && !injected_before(event, *position) ) {
+    *position = event;
+  } else {
+    m_events.insert(position, event);
+  }
+}
+
+auto Divergence_log::of(const std::uint64_t seed,
+                        const std::uint64_t replay) const noexcept
+    -> Span<const Injected_result>
+{
+  const Injected_result first_bout {seed, replay, 0};
+  const auto first = std::lower_bound(m_events.begin(), m_events.end(),
+                                      first_bout, injected_before);
+  const auto last = std::partition_point(
+      first, m_events.end(), [&](const Injected_result& event) {
+        return event.seed == seed && event.replay == replay;
+      });
+  return {m_events.data() + (first - m_events.begin()),
+          static_cast<std::size_t>(last - first)};
+}
+
+auto Divergence_log::hash(const std::uint64_t seed,
+                          const std::uint64_t replay) const noexcept
+    -> std::uint64_t
+{
+  std::uint64_t hash {0};
+  for ( const Injected_result& event : of(seed, replay) ) {
+    hash += injection_hash(event);
+  }
+  return hash;
+}
+
+Replay_engine::Replay_engine(const std::vector<Wrestler>& field,
+                             const Replay_rules& rules,
+                             const Divergence_log* const log)
+    : m_ids(field.size())
+    , m_table {field}
+    , m_lines {}
+    , m_by_seed {}
+    , m_rules {rules}
+    , m_roster_hash {roster_hash(field)}
+    , m_rules_hash {rules_hash(rules)}
+    , m_log {log}
+{
+  std::vector<std::size_t> everyone(field.size());
+  std::vector<int> ability(field.size());
+  for ( std::size_t index {0}; index != field.size(); ++index ) {
+    everyone[index] = index;
+    ability[index]  = field[index].ability();
+    m_ids[index]    = field[index].id();
+  }
+  m_lines = seeded_lines(everyone, ability);
+
+  const std::vector<std::size_t> seeds {seed_order(m_lines.size())};
+  m_by_seed.resize(field.size());
+  for ( std::size_t line {0}; line != m_lines.size(); ++line ) {
+    if ( m_lines[line] != bye_line ) {
+      m_by_seed[seeds[line] - 1] = m_lines[line];
+    }
+  }
+}
+
+auto Replay_engine::key(const std::uint64_t seed,
+                        const std::uint64_t replay) const noexcept
+    -> Replay_key
+{
+  return {m_roster_hash, m_rules_hash, seed, replay,
+          m_log == nullptr ? 0 : m_log->hash(seed, replay)};
+}
+
+auto Replay_engine::play(const std::uint64_t seed,
+                         const std::uint64_t replay,
+                         std::vector<Bout_event>* const bouts) const
+    -> std::vector<std::size_t>
+{
+  // the field and rules are part of the seed, so changing either gives
+  // unrelated replays rather than subtly shifted ones
+  const std::uint64_t base {
+      combine(combine(m_roster_hash, m_rules_hash), seed)};
+  Rng winners {base, 2 * replay};
+  Rng details {base, 2 * replay + 1};
+
+  const Span<const Injected_result> injected {
+      m_log == nullptr ? Span<const Injected_result> {}
+                       : m_log->of(seed, replay)};
+  std::size_t next_injected {0};
+  std::uint32_t slot {0};
+
+  auto decide = [&](const std::size_t top, const std::size_t bottom) {
+    std::size_t winner {winners.uniform() < m_table(top, bottom) ? top
+                                                                 : bottom};
+    const Injected_result* forced {nullptr};
+    if ( next_injected != injected.size()
+         && injected[next_injected].slot == slot ) {
+      forced = &injected[next_injected++];
+      if ( forced->winner == m_ids[top] ) {
+        winner = top;
+      } else if ( forced->winner == m_ids[bottom] ) {
+        winner = bottom;
+      } else {
+        throw std::runtime_error {
+            "Injected result names a wrestler not in the bout"};
+      }
+    }
+
+    if ( bouts != nullptr ) {
+      const std::size_t loser {winner == top ? bottom : top};
+      Bout_event event;
+      event.tournament = replay;
+      event.slot       = slot;
+      event.winner     = m_ids[winner];
+      event.loser      = m_ids[loser];
+      score_bout(m_rules, m_table(winner, loser), details, event);
+      if ( forced != nullptr ) {
+        event.result       = forced->result;
+        event.winner_score = 0;
+        event.loser_score  = 0;
+        if ( forced->result == Result_type::forfeit ) {
+          event.duration = 0;
+        }
+      }
+      bouts->push_back(event);
+    }
+    ++slot;
+    return winner;
+  };
+
+  std::vector<std::size_t> placings;
+  if ( !m_lines.empty() && m_rules.places != 0 ) {
+    play_bracket(m_lines, bouts == nullptr ? 1 : m_rules.places, placings,
+                 decide);
+  }
+  // scans stop at the champion, so only a full replay plays every bout
+  if ( bouts != nullptr && next_injected != injected.size() ) {
+    throw std::runtime_error {
+        "Injected result names a bout the replay never plays"};
+  }
+  return placings;
+}
+
+auto Replay_engine::replay(const Replay_key& key) const -> Replay
+{
+  if ( key.roster != m_roster_hash || key.rules != m_rules_hash ) {
+    throw std::invalid_argument {
+        "Replay key belongs to another field or rule set"};
+  }
+  if ( key.log
+       != (m_log == nullptr ? 0 : m_log->hash(key.seed, key.replay)) ) {
+    throw std::invalid_argument {
+        "Replay key was made with other injected results"};
+  }
+  Replay result {key, {}, {}};
+  result.placings = play(key.seed, key.replay, &result.bouts);
+  return result;
+}
+
+auto Replay_engine::replay(const std::uint64_t seed,
+                           const std::uint64_t replay) const -> Replay
+{
+  return this->replay(key(seed, replay));
+}
+
+auto Replay_engine::find_champion(const std::uint64_t seed,
+                                  const std::size_t champion,
+                                  const std::uint64_t first,
+                                  const std::uint64_t count) const
+    -> std::uint64_t
+{
+  for ( std::uint64_t replay {first}; replay != first + count;
+        ++replay ) {
+    const std::vector<std::size_t> placings {play(seed, replay, nullptr)};
+    if ( !placings.empty() && placings.front() == champion ) {
+      return replay;
+    }
+  }
+  return not_found;
+}
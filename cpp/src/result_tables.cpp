@@ -0,0 +1,60 @@
+#include "result_tables.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+auto league_table(const std::vector<League_team>& teams,
+                  const League_summary& summary) -> Arrow_table
+{
+  std::vector<std::string> names;
+  std::vector<std::int32_t> wrestlers;
+  for ( const League_team& team : teams ) {
+    names.push_back(team.name);
+    wrestlers.push_back(static_cast<std::int32_t>(team.roster.size()));
+  }
+
+  Arrow_table table {teams.size()};
+  table.add_strings("team", names);
+  table.add_int32("wrestlers", wrestlers);
+  table.add_float64("title_probability", summary.title_probability);
+  table.add_float64("mean_place", summary.mean_place);
+  table.add_float64("mean_wins", summary.mean_wins);
+  return table;
+}
+
+auto qualifier_table(const std::vector<Wrestler>& roster,
+                     const std::vector<std::string>& team_of,
+                     const Qualifier_odds& odds) -> Arrow_table
+{
+  const std::size_t rows {roster.size()};
+  if ( team_of.size() != rows || odds.reach_region.size() != rows
+       || odds.reach_state.size() != rows
+       || odds.place_probability.size() != rows * odds.state_places ) {
+    throw std::invalid_argument {
+        "Qualifier odds and teams must cover every wrestler"};
+  }
+
+  std::vector<std::int32_t> ids;
+  std::vector<std::int32_t> ages;
+  std::vector<std::int32_t> weights;
+  std::vector<std::int32_t> abilities;
+  std::vector<double> placed;
+  for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+    ids.push_back(roster[slot].id());
+    ages.push_back(roster[slot].age());
+    weights.push_back(roster[slot].weight());
+    abilities.push_back(roster[slot].ability());
+    placed.push_back(odds.placed(slot));
+  }
+
+  Arrow_table table {rows};
+  table.add_strings("team", team_of);
+  table.add_int32("id", ids);
+  table.add_int32("age", ages);
+  table.add_int32("weight", weights);
+  table.add_int32("ability", abilities);
+  table.add_float64("reach_region", odds.reach_region);
+  table.add_float64("reach_state", odds.reach_state);
+  table.add_float64("placed", placed);
+  return table;
+}
@@ -0,0 +1,227 @@
+#include "result_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+namespace {
+
+/// Yields before a waiting thread starts sleeping
+constexpr std::size_t spin_limit {64};
+constexpr std::chrono::microseconds idle_sleep {100};
+
+template <typename T>
+void put(unsigned char*& out, const T value) noexcept
+{
+  std::memcpy(out, &value, sizeof(T));
+  out += sizeof(T);
+}
+
+template <typename T>
+auto get(const unsigned char*& in) noexcept -> T
+{
+  T value {};
+  std::memcpy(&value, in, sizeof(T));
+  in += sizeof(T);
+  return value;
+}
+
+/// Yield for a while, then sleep, so a waiting thread does not starve
+/// the one it waits for
+void back_off(std::size_t& attempts)
+{
+  if ( attempts < spin_limit ) {
+    ++attempts;
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(idle_sleep);
+  }
+}
+
+} // namespace
+
+void encode_result(const Result_record& record,
+                   unsigned char* const out) noexcept
+{
+  unsigned char* cursor {out};
+  put(cursor, record.replay);
+  put(cursor, static_cast<std::int32_t>(record.bout.winner));
+  put(cursor, static_cast<std::int32_t>(record.bout.loser));
+  put(cursor, static_cast<std::int32_t>(record.bout.date));
+  put(cursor, static_cast<std::int32_t>(record.bout.tournament));
+  put(cursor, record.bout.winner_score);
+  put(cursor, record.bout.loser_score);
+  put(cursor, record.bout.result);
+  std::memset(cursor, 0, result_record_bytes
+                             - static_cast<std::size_t>(cursor - out));
+}
+
+auto decode_result(const unsigned char* in) noexcept -> Result_record
+{
+  Result_record record;
+  record.replay            = get<std::uint64_t>(in);
+  record.bout.winner       = get<std::int32_t>(in);
+  record.bout.loser        = get<std::int32_t>(in);
+  record.bout.date         = get<std::int32_t>(in);
+  record.bout.tournament   = get<std::int32_t>(in);
+  record.bout.winner_score = get<std::int16_t>(in);
+  record.bout.loser_score  = get<std::int16_t>(in);
+  record.bout.result       = get<Result_type>(in);
+  return record;
+}
+
+auto descriptor_sink(const int descriptor) -> Byte_sink
+{
+  return [descriptor](const unsigned char* data, std::size_t size) {
+    while ( size != 0 ) {
+      const ::ssize_t wrote {::write(descriptor, data, size)};
+      if ( wrote < 0 ) {
+        if ( errno == EINTR ) {
+          continue;
+        }
+        throw std::runtime_error {std::string {"Cannot write results: "}
+                                  + std::strerror(errno)};
+      }
+      data += wrote;
+      size -= static_cast<std::size_t>(wrote);
+    }
+  };
+}
+
+Result_writer::Result_writer(Byte_sink sink,
+                             const Result_writer_params& params)
+    : m_ring {params.capacity}
+    , m_sink {std::move(sink)}
+    , m_batch(std::max(params.batch_bytes / result_record_bytes,
+                       std::size_t {1})
+              * result_record_bytes)
+{
+  m_thread = std::thread {&Result_writer::drain, this};
+}
+
+Result_writer::~Result_writer()
+{
+  try {
+    close();
+  } catch ( ... ) {
+    // a failure a submit already threw is the caller's to handle, and
+    // may be what is unwinding through here
+    if ( !m_reported.load(std::memory_order_relaxed)
+         && std::uncaught_exceptions() == 0 ) {
+      std::terminate();
+    }
+  }
+}
+
+void Result_writer::append(const Result_record& record)
+{
+  encode_result(record, m_batch.data() + m_batch_used);
+  m_batch_used += result_record_bytes;
+  if ( m_batch_used == m_batch.size() ) {
+    flush();
+  }
+}
+
+void Result_writer::flush()
+{
+  if ( m_batch_used == 0 ) {
+    return;
+  }
+  m_sink(m_batch.data(), m_batch_used);
+  m_written.fetch_add(m_batch_used / result_record_bytes,
+                      std::memory_order_relaxed);
+  m_writes.fetch_add(1, std::memory_order_relaxed);
+  m_batch_used = 0;
+}
+
+void Result_writer::drain()
+{
+  try {
+    Result_record record;
+    std::size_t idle {0};
+    while ( true ) {
+      if ( m_ring.try_pop(record) ) {
+        append(record);
+        idle = 0;
+      } else if ( m_closing.load(std::memory_order_acquire) ) {
+        // producers finished before closing, so one last pass empties
+        // the ring
+        while ( m_ring.try_pop(record) ) {
+          append(record);
+        }
+        flush();
+        return;
+      } else {
+        if ( idle == spin_limit ) {
+          flush();
+        }
+        back_off(idle);
+      }
+    }
+  } catch ( ... ) {
+    m_failure = std::current_exception();
+    m_failed.store(true, std::memory_order_release);
+  }
+}
+
+void Result_writer::check_open() const
+{
+  if ( m_failed.load(std::memory_order_acquire) ) {
+    m_reported.store(true, std::memory_order_relaxed);
+    throw std::runtime_error {"Result writer failed; record not written"};
+  }
+  if ( m_closing.load(std::memory_order_relaxed) ) {
+    throw std::logic_error {"Result writer is closed"};
+  }
+}
+
+auto Result_writer::try_submit(const Result_record& record) -> bool
+{
+  check_open();
+  if ( m_ring.try_push(record) ) {
+    return true;
+  }
+  m_rejected.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void Result_writer::submit(const Result_record& record)
+{
+  check_open();
+  if ( m_ring.try_push(record) ) {
+    return;
+  }
+  m_stalls.fetch_add(1, std::memory_order_relaxed);
+  std::size_t attempts {0};
+  do {
+    back_off(attempts);
+    check_open();
+  } while ( !m_ring.try_push(record) );
+}
+
+void Result_writer::close()
+{
+  if ( !m_thread.joinable() ) {
+    return;
+  }
+  m_closing.store(true, std::memory_order_release);
+  m_thread.join();
+  if ( m_failure ) {
+    std::rethrow_exception(std::exchange(m_failure, nullptr));
+  }
+}
+
+auto Result_writer::stats() const noexcept -> Result_writer_stats
+{
+  return {m_ring.pushed(), m_rejected.load(std::memory_order_relaxed),
+          m_stalls.load(std::memory_order_relaxed),
+          m_written.load(std::memory_order_relaxed),
+          m_writes.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,211 @@
+#include "roster_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+#include "async_file.h"
+#include "parallel.h"
+#include "random.h"
+
+namespace {
+
+// headers and records are written as they sit in memory
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Binary rosters are little-endian");
+static_assert(sizeof(Roster_file_format::Header) == 16);
+static_assert(sizeof(Roster_record) == 20);
+
+/// Wrestlers each worker generates between writes
+constexpr std::size_t batch_rows {std::size_t {1} << 15};
+
+/// Standard normal variate by Box-Muller
+auto normal(Rng& rng) -> double
+{
+  constexpr double two_pi {6.283185307179586};
+  const double radius {std::sqrt(-2.0 * std::log(1.0 - rng.uniform()))};
+  return radius * std::cos(two_pi * rng.uniform());
+}
+
+} // namespace
+
+void encode_roster(const Span<const Roster_record> records,
+                   const Roster_encoding encoding, Text_buffer& out)
+{
+  if ( encoding == Roster_encoding::binary ) {
+    //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    out << std::string_view {reinterpret_cast<const char*>(records.data()),
+                             records.size() * sizeof(Roster_record)};
+    return;
+  }
+  for ( const Roster_record& record : records ) {
+    out << record.id << ',' << record.team << ',' << record.age << ','
+        << record.weight << ',' << record.ability << '\n';
+  }
+}
+
+Roster_file::Roster_file(const std::string& path)
+    : m_file {path}
+{
+  Roster_file_format::Header header {};
+  if ( m_file.size() < sizeof(header) ) {
+    throw std::runtime_error {"Truncated roster " + path};
+  }
+  std::memcpy(&header, m_file.data(), sizeof(header));
+  if ( header.magic != Roster_file_format::magic
+       || header.version != Roster_file_format::version
+       || header.record_bytes != sizeof(Roster_record)
+       || (m_file.size() - sizeof(header)) % sizeof(Roster_record) != 0 ) {
+    throw std::runtime_error {"Malformed roster " + path};
+  }
+  m_size = (m_file.size() - sizeof(header)) / sizeof(Roster_record);
+}
+
+auto Roster_file::operator[](const std::size_t index) const noexcept
+    -> Roster_record
+{
+  Roster_record record;
+  std::memcpy(&record,
+              m_file.data() + sizeof(Roster_file_format::Header)
+                  + index * sizeof(Roster_record),
+              sizeof(record));
+  return record;
+}
+
+void Roster_file::read(const std::size_t first, const std::size_t count,
+                       std::vector<Roster_record>& out) const
+{
+  const std::size_t begin {std::min(first, m_size)};
+  out.resize(std::min(count, m_size - begin));
+  if ( !out.empty() ) {
+    std::memcpy(out.data(),
+                m_file.data() + sizeof(Roster_file_format::Header)
+                    + begin * sizeof(Roster_record),
+                out.size() * sizeof(Roster_record));
+  }
+}
+
+Roster_generator::Roster_generator(const Roster_params& params)
+    : m_params {params}
+{
+  if ( params.teams == 0
+       || params.teams > std::numeric_limits<std::int32_t>::max() ) {
+    throw std::invalid_argument {
+        "A roster needs between 1 and 2^31 teams"};
+  }
+  if ( params.min_age > params.max_age
+       || params.weight_floor > params.max_weight
+       || params.weight_median <= 0 || params.weight_sigma < 0
+       || params.ability_sd < 0 || params.team_spread < 0 ) {
+    throw std::invalid_argument {"Invalid roster parameters"};
+  }
+
+  Rng rng {params.seed, 0};
+  m_team_strength.resize(params.teams);
+  for ( double& strength : m_team_strength ) {
+    strength = params.team_spread * normal(rng);
+  }
+}
+
+void Roster_generator::generate(const std::size_t first,
+                                const std::size_t count,
+                                std::vector<Roster_record>& out) const
+{
+  if ( first + count
+       > std::size_t {std::numeric_limits<std::int32_t>::max()} ) {
+    throw std::invalid_argument {"Wrestler ids must fit in 31 bits"};
+  }
+  const Roster_params& params {m_params};
+  const auto ages = static_cast<std::uint32_t>(params.max_age
+                                               - params.min_age + 1);
+
+  out.resize(count);
+  for ( std::size_t index {0}; index != count; ++index ) {
+    const std::size_t row {first + index};
+    // stream 0 is the teams'
+    Rng rng {params.seed, row + 1};
+    Roster_record& record {out[index]};
+    record.id   = static_cast<std::int32_t>(row);
+    record.team = static_cast<std::int32_t>(
+        rng.below(static_cast<std::uint32_t>(params.teams)));
+    record.age = params.min_age + static_cast<int>(rng.below(ages));
+
+    const int years {record.age - params.min_age};
+    const double median {params.weight_median
+                         + params.weight_per_year * years};
+    const double above {median
+                        * std::exp(params.weight_sigma * normal(rng))};
+    record.weight = std::min(
+        params.max_weight,
+        params.weight_floor + static_cast<int>(std::lround(above)));
+
+    record.ability = static_cast<int>(std::lround(
+        params.ability_mean + params.ability_per_year * years
+        + m_team_strength[static_cast<std::size_t>(record.team)]
+        + params.ability_sd * normal(rng)));
+  }
+}
+
+void Roster_generator::write(const std::string& path,
+                             const std::size_t wrestlers,
+                             const Roster_encoding encoding) const
+{
+  // checked here, as a worker's exception would end the program
+  if ( wrestlers
+       > std::size_t {std::numeric_limits<std::int32_t>::max()} ) {
+    throw std::invalid_argument {"Wrestler ids must fit in 31 bits"};
+  }
+  const std::size_t threads {m_params.threads == 0 ? hardware_threads()
+                                                   : m_params.threads};
+  Async_file_writer file {path};
+  const auto append = [&file](const std::string_view bytes) {
+    //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    file.append(reinterpret_cast<const unsigned char*>(bytes.data()),
+                bytes.size());
+  };
+
+  if ( encoding == Roster_encoding::binary ) {
+    const Roster_file_format::Header header {
+        Roster_file_format::magic, Roster_file_format::version,
+        sizeof(Roster_record)};
+    //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    append({reinterpret_cast<const char*>(&header), sizeof(header)});
+  } else {
+    append(roster_csv_header);
+  }
+
+  // each round every worker encodes its own batch; the batches are then
+  // written in order while the file writes the previous round behind
+  std::deque<Text_buffer> encoded;
+  std::vector<std::vector<Roster_record>> records(threads);
+  for ( std::size_t worker {0}; worker != threads; ++worker ) {
+    encoded.emplace_back(batch_rows * sizeof(Roster_record));
+  }
+  for ( std::size_t round {0}; round < wrestlers;
+        round += threads * batch_rows ) {
+    const std::size_t rows {std::min(threads * batch_rows,
+                                     wrestlers - round)};
+    const std::size_t workers {(rows + batch_rows - 1) / batch_rows};
+    parallel_for(
+        workers,
+        [&](const std::size_t, const std::size_t begin,
+            const std::size_t end) {
+          for ( std::size_t worker {begin}; worker != end; ++worker ) {
+            const std::size_t first {round + worker * batch_rows};
+            generate(first, std::min(batch_rows, round + rows - first),
+                     records[worker]);
+            encoded[worker].clear();
+            encode_roster({records[worker].data(), records[worker].size()},
+                          encoding, encoded[worker]);
+          }
+        },
+        workers);
+    for ( std::size_t worker {0}; worker != workers; ++worker ) {
+      append(encoded[worker].view());
+    }
+  }
+  file.close();
+}
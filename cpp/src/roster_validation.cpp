@@ -0,0 +1,344 @@
+#include "roster_validation.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "parallel.h"
+
+namespace {
+
+/// Rows per duplicate-detection partition, so its table stays in cache
+constexpr std::size_t partition_rows {4096};
+
+/// Ids spanning at most this many values per row are checked against a
+/// bitmap of the whole range instead of being partitioned
+constexpr std::size_t dense_bits_per_row {32};
+
+/// Bit `i` set where `values[i]` is outside `[low, high]`; `count` is at
+/// most 64
+auto outside(const std::int32_t* const values, const std::size_t count,
+             const std::int32_t low, const std::int32_t high) noexcept
+    -> std::uint64_t
+{
+  std::uint64_t bits {0};
+  std::size_t index {0};
+#ifdef __SSE2__
+  const __m128i lows {_mm_set1_epi32(low)};
+  const __m128i highs {_mm_set1_epi32(high)};
+  for ( ; index + 4 <= count; index += 4 ) {
+    //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const __m128i value {_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(values + index))};
+    const __m128i bad {_mm_or_si128(_mm_cmplt_epi32(value, lows),
+                                    _mm_cmpgt_epi32(value, highs))};
+    bits |= static_cast<std::uint64_t>(
+                _mm_movemask_ps(_mm_castsi128_ps(bad)))
+         << index;
+  }
+#endif
+  for ( ; index != count; ++index ) {
+    bits |= static_cast<std::uint64_t>(values[index] < low
+                                       || values[index] > high)
+         << index;
+  }
+  return bits;
+}
+
+/// Bit `i` set unless `lows[i] < weights[i] <= highs[i]`
+auto outside_each(const std::int32_t* const weights,
+                  const std::int32_t* const lows,
+                  const std::int32_t* const highs,
+                  const std::size_t count) noexcept -> std::uint64_t
+{
+  std::uint64_t bits {0};
+  std::size_t index {0};
+#ifdef __SSE2__
+  const __m128i ones {_mm_set1_epi32(-1)};
+  for ( ; index + 4 <= count; index += 4 ) {
+    //NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    const __m128i weight {_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(weights + index))};
+    const __m128i low {
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(lows + index))};
+    const __m128i high {
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(highs + index))};
+    //NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    const __m128i bad {
+        _mm_or_si128(_mm_andnot_si128(_mm_cmpgt_epi32(weight, low), ones),
+                     _mm_cmpgt_epi32(weight, high))};
+    bits |= static_cast<std::uint64_t>(
+                _mm_movemask_ps(_mm_castsi128_ps(bad)))
+         << index;
+  }
+#endif
+  for ( ; index != count; ++index ) {
+    bits |= static_cast<std::uint64_t>(weights[index] <= lows[index]
+                                       || weights[index] > highs[index])
+         << index;
+  }
+  return bits;
+}
+
+/// Murmur3's finalizer; ids are often sequential or strided
+constexpr auto id_hash(const std::int32_t id) noexcept -> std::uint32_t
+{
+  auto hash = static_cast<std::uint32_t>(id);
+  hash ^= hash >> 16U;
+  hash *= 0x85ebca6bU;
+  hash ^= hash >> 13U;
+  hash *= 0xc2b2ae35U;
+  return hash ^ (hash >> 16U);
+}
+
+void mark(std::vector<std::uint64_t>& bitmap, const std::size_t row)
+{
+  bitmap[row / 64] |= std::uint64_t {1} << (row % 64);
+}
+
+/// Mark repeated ids by two bitmaps over the id range: ids seen, then
+/// ids seen twice
+void mark_dense_duplicates(const std::vector<std::int32_t>& ids,
+                           const std::int32_t lowest,
+                           const std::size_t range,
+                           std::vector<std::uint64_t>& bitmap)
+{
+  std::vector<std::uint64_t> seen((range + 63) / 64, 0);
+  std::vector<std::uint64_t> repeated(seen.size(), 0);
+  bool any {false};
+  for ( const std::int32_t id : ids ) {
+    const auto offset = static_cast<std::size_t>(
+        static_cast<std::int64_t>(id) - lowest);
+    const std::uint64_t bit {std::uint64_t {1} << (offset % 64)};
+    const std::uint64_t was {seen[offset / 64] & bit};
+    repeated[offset / 64] |= was;
+    seen[offset / 64] |= bit;
+    any = any || was != 0;
+  }
+  if ( !any ) {
+    return;
+  }
+  for ( std::size_t row {0}; row != ids.size(); ++row ) {
+    const auto offset = static_cast<std::size_t>(
+        static_cast<std::int64_t>(ids[row]) - lowest);
+    if ( (repeated[offset / 64] >> (offset % 64) & 1U) != 0 ) {
+      mark(bitmap, row);
+    }
+  }
+}
+
+/// Mark every row whose id appears more than once
+void mark_duplicates(const std::vector<std::int32_t>& ids,
+                     std::vector<std::uint64_t>& bitmap)
+{
+  if ( ids.empty() ) {
+    return;
+  }
+  const auto [lowest, highest] =
+      std::minmax_element(ids.begin(), ids.end());
+  const auto range = static_cast<std::size_t>(
+      static_cast<std::int64_t>(*highest) - *lowest + 1);
+  if ( range <= dense_bits_per_row * ids.size() ) {
+    mark_dense_duplicates(ids, *lowest, range, bitmap);
+    return;
+  }
+
+  struct Entry {
+    std::int32_t id {};
+    std::uint32_t row {};
+  };
+
+  // scatter the ids into partitions by the top bits of their hash
+  unsigned bits {0};
+  while ( bits < 16 && ids.size() >> bits > partition_rows ) {
+    ++bits;
+  }
+  const auto partition_of = [bits](const std::uint32_t hash) {
+    return bits == 0 ? std::size_t {0}
+                     : std::size_t {hash >> (32U - bits)};
+  };
+  std::vector<std::size_t> offsets((std::size_t {1} << bits) + 1, 0);
+  for ( const std::int32_t id : ids ) {
+    ++offsets[partition_of(id_hash(id)) + 1];
+  }
+  std::size_t largest {0};
+  for ( std::size_t partition {1}; partition != offsets.size();
+        ++partition ) {
+    largest = std::max(largest, offsets[partition]);
+    offsets[partition] += offsets[partition - 1];
+  }
+  std::vector<Entry> entries(ids.size());
+  std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+  for ( std::size_t row {0}; row != ids.size(); ++row ) {
+    entries[next[partition_of(id_hash(ids[row]))]++] = {
+        ids[row], static_cast<std::uint32_t>(row)};
+  }
+
+  // then probe a table sized for each partition, holding entry + 1
+  std::size_t capacity {1};
+  while ( capacity < 2 * largest ) {
+    capacity *= 2;
+  }
+  std::vector<std::uint32_t> table(capacity);
+  for ( std::size_t partition {0}; partition + 1 != offsets.size();
+        ++partition ) {
+    const std::size_t first {offsets[partition]};
+    const std::size_t size {offsets[partition + 1] - first};
+    std::size_t mask {1};
+    while ( mask < 2 * size ) {
+      mask *= 2;
+    }
+    --mask;
+    std::fill_n(table.begin(), mask + 1, 0U);
+
+    for ( std::size_t index {0}; index != size; ++index ) {
+      const Entry& entry {entries[first + index]};
+      std::size_t slot {id_hash(entry.id) & mask};
+      while ( table[slot] != 0 ) {
+        const Entry& other {entries[first + table[slot] - 1]};
+        if ( other.id == entry.id ) {
+          mark(bitmap, other.row);
+          mark(bitmap, entry.row);
+          break;
+        }
+        slot = (slot + 1) & mask;
+      }
+      if ( table[slot] == 0 ) {
+        table[slot] = static_cast<std::uint32_t>(index + 1);
+      }
+    }
+  }
+}
+
+} // namespace
+
+auto to_columns(const Span<const Roster_record> records) -> Roster_columns
+{
+  Roster_columns columns;
+  columns.id.reserve(records.size());
+  columns.age.reserve(records.size());
+  columns.weight.reserve(records.size());
+  columns.ability.reserve(records.size());
+  for ( const Roster_record& record : records ) {
+    columns.id.push_back(record.id);
+    columns.age.push_back(record.age);
+    columns.weight.push_back(record.weight);
+    columns.ability.push_back(record.ability);
+  }
+  return columns;
+}
+
+Roster_violations::Roster_violations(const std::size_t rows)
+    : m_rows {rows}
+    , m_bitmaps {}
+{
+  for ( auto& bitmap : m_bitmaps ) {
+    bitmap.assign((rows + 63) / 64, 0);
+  }
+}
+
+auto Roster_violations::count(const Violation kind) const noexcept
+    -> std::size_t
+{
+  std::size_t rows {0};
+  for ( const std::uint64_t word : bitmap(kind) ) {
+    rows += static_cast<std::size_t>(__builtin_popcountll(word));
+  }
+  return rows;
+}
+
+auto Roster_violations::violating_rows() const -> std::vector<std::size_t>
+{
+  std::vector<std::size_t> rows;
+  for ( std::size_t word {0}; word != m_bitmaps.front().size(); ++word ) {
+    std::uint64_t any {0};
+    for ( const auto& bitmap : m_bitmaps ) {
+      any |= bitmap[word];
+    }
+    while ( any != 0 ) {
+      rows.push_back(word * 64
+                     + static_cast<std::size_t>(__builtin_ctzll(any)));
+      any &= any - 1;
+    }
+  }
+  return rows;
+}
+
+auto validate_roster(const Roster_columns& roster,
+                     const Weight_classes& classes,
+                     const Roster_limits& limits,
+                     const std::size_t threads) -> Roster_violations
+{
+  const std::size_t rows {roster.size()};
+  if ( roster.age.size() != rows || roster.weight.size() != rows
+       || roster.ability.size() != rows
+       || (!roster.weight_class.empty()
+           && roster.weight_class.size() != rows) ) {
+    throw std::invalid_argument {"Roster columns differ in length"};
+  }
+  if ( rows > std::numeric_limits<std::uint32_t>::max() ) {
+    throw std::invalid_argument {"Roster has too many rows to validate"};
+  }
+
+  // class `c` takes weights in `(low[c], high[c]]`; a class that does
+  // not exist takes none
+  constexpr std::int32_t lowest {std::numeric_limits<std::int32_t>::min()};
+  constexpr std::int32_t highest {
+      std::numeric_limits<std::int32_t>::max()};
+  std::array<std::int32_t, 256> class_low {};
+  std::array<std::int32_t, 256> class_high {};
+  class_low.fill(highest);
+  class_high.fill(lowest);
+  for ( std::size_t index {0};
+        index != std::min(classes.size(), class_low.size()); ++index ) {
+    class_high[index] = classes.limit(index) + limits.allowance;
+    class_low[index] =
+        index > limits.classes_up
+            ? classes.limit(index - limits.classes_up - 1)
+                  + limits.allowance
+            : lowest;
+  }
+
+  Roster_violations violations {rows};
+  const bool check_classes {!roster.weight_class.empty()};
+  parallel_for(
+      (rows + 63) / 64,
+      [&](const std::size_t, const std::size_t begin,
+          const std::size_t end) {
+        std::array<std::int32_t, 64> low {};
+        std::array<std::int32_t, 64> high {};
+        for ( std::size_t word {begin}; word != end; ++word ) {
+          const std::size_t first {word * 64};
+          const std::size_t count {
+              std::min<std::size_t>(64, rows - first)};
+          violations.bitmap(Violation::age)[word] =
+              outside(roster.age.data() + first, count, limits.min_age,
+                      limits.max_age);
+          violations.bitmap(Violation::weight)[word] =
+              outside(roster.weight.data() + first, count,
+                      limits.min_weight, limits.max_weight);
+          violations.bitmap(Violation::ability)[word] =
+              outside(roster.ability.data() + first, count,
+                      limits.min_ability, limits.max_ability);
+          if ( check_classes ) {
+            for ( std::size_t index {0}; index != count; ++index ) {
+              const std::uint8_t declared {
+                  roster.weight_class[first + index]};
+              low[index]  = class_low[declared];
+              high[index] = class_high[declared];
+            }
+            violations.bitmap(Violation::weight_class)[word] =
+                outside_each(roster.weight.data() + first, low.data(),
+                             high.data(), count);
+          }
+        }
+      },
+      threads);
+
+  mark_duplicates(roster.id, violations.bitmap(Violation::duplicate_id));
+  return violations;
+}
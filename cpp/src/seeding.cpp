@@ -0,0 +1,401 @@
+#include "seeding.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+namespace {
+
+/// Tarjan's algorithm over a dense row-major "beats" matrix. Component
+/// ids come out in reverse topological order.
+auto strongly_connected(const std::vector<unsigned char>& beats,
+                        const std::size_t count)
+    -> std::vector<std::size_t>
+{
+  constexpr std::size_t unvisited {~std::size_t {0}};
+
+  std::vector<std::size_t> index(count, unvisited);
+  std::vector<std::size_t> low(count, 0);
+  std::vector<std::size_t> component(count, unvisited);
+  std::vector<bool> on_stack(count, false);
+  std::vector<std::size_t> stack;
+  std::size_t next_index {0};
+  std::size_t next_component {0};
+
+  const std::function<void(std::size_t)> visit =
+      [&](const std::size_t node) {
+        index[node] = low[node] = next_index++;
+        stack.push_back(node);
+        on_stack[node] = true;
+
+        for ( std::size_t other {0}; other != count; ++other ) {
+          if ( beats[node * count + other] == 0 ) {
+            continue;
+          }
+          if ( index[other] == unvisited ) {
+            visit(other);
+            low[node] = std::min(low[node], low[other]);
+          } else if ( on_stack[other] ) {
+            low[node] = std::min(low[node], index[other]);
+          }
+        }
+
+        if ( low[node] == index[node] ) {
+          std::size_t member {};
+          do {
+            member = stack.back();
+            stack.pop_back();
+            on_stack[member]  = false;
+            component[member] = next_component;
+          } while ( member != node );
+          ++next_component;
+        }
+      };
+
+  for ( std::size_t node {0}; node != count; ++node ) {
+    if ( index[node] == unvisited ) {
+      visit(node);
+    }
+  }
+
+  return component;
+}
+
+} // namespace
+
+Seeding_engine::Seeding_engine(const std::vector<Wrestler>& roster,
+                               std::vector<std::size_t> class_of,
+                               std::vector<Seed_criterion> criteria)
+    : m_roster {&roster}
+    , m_criteria {std::move(criteria)}
+    , m_class_of {std::move(class_of)}
+    , m_members {}
+    , m_seeds {}
+    , m_dirty {}
+    , m_opponents(roster.size())
+{
+  m_class_of.resize(roster.size(), unassigned);
+
+  std::size_t classes {0};
+  int max_id {-1};
+  for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+    if ( m_class_of[slot] != unassigned ) {
+      classes = std::max(classes, m_class_of[slot] + 1);
+    }
+    max_id = std::max(max_id, roster[slot].id());
+  }
+
+  m_members.resize(classes);
+  m_seeds.resize(classes);
+  m_dirty.assign(classes, true);
+  m_slot_of_id.assign(static_cast<std::size_t>(max_id + 1), -1);
+
+  for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+    if ( m_class_of[slot] != unassigned ) {
+      m_members[m_class_of[slot]].push_back(slot);
+    }
+    if ( roster[slot].id() >= 0 ) {
+      m_slot_of_id[static_cast<std::size_t>(roster[slot].id())] =
+          static_cast<int>(slot);
+    }
+  }
+}
+
+auto Seeding_engine::slot_of(const int id) const noexcept -> std::size_t
+{
+  if ( id < 0 || static_cast<std::size_t>(id) >= m_slot_of_id.size()
+       || m_slot_of_id[static_cast<std::size_t>(id)] < 0 ) {
+    return unassigned;
+  }
+  return static_cast<std::size_t>(
+      m_slot_of_id[static_cast<std::size_t>(id)]);
+}
+
+void Seeding_engine::mark_dirty(const std::size_t slot) noexcept
+{
+  if ( slot != unassigned && m_class_of[slot] != unassigned ) {
+    m_dirty[m_class_of[slot]] = true;
+  }
+}
+
+void Seeding_engine::set_ratings(std::vector<double> ratings)
+{
+  m_rating = std::move(ratings);
+  invalidate();
+}
+
+void Seeding_engine::add_result(const Bout& bout)
+{
+  if ( bout.winner == bout.loser ) {
+    return;
+  }
+
+  const std::size_t winner {slot_of(bout.winner)};
+  const std::size_t loser {slot_of(bout.loser)};
+
+  const auto remember = [this](const std::size_t slot, const int opponent,
+                                const bool won) {
+    if ( slot == unassigned ) {
+      return;
+    }
+    auto& opponents = m_opponents[slot];
+    auto position   = std::lower_bound(
+        opponents.begin(), opponents.end(), opponent,
+        [](const Opponent_record& record, const int id) {
+          return record.id < id;
+        });
+    if ( position == opponents.end() || position->id != opponent ) {
+      position =
+          opponents.insert(position, Opponent_record {opponent, 0, 0});
+    }
+    ++(won ? position->wins : position->losses);
+  };
+  remember(winner, bout.loser, true);
+  remember(loser, bout.winner, false);
+
+  mark_dirty(winner);
+  mark_dirty(loser);
+}
+
+void Seeding_engine::invalidate() noexcept
+{
+  std::fill(m_dirty.begin(), m_dirty.end(), true);
+}
+
+auto Seeding_engine::seeds(const std::size_t weight_class)
+    -> const std::vector<std::size_t>&
+{
+  if ( m_dirty[weight_class] ) {
+    reseed(weight_class);
+  }
+  return m_seeds[weight_class];
+}
+
+void Seeding_engine::reseed_all()
+{
+  for ( std::size_t weight_class {0}; weight_class != m_members.size();
+        ++weight_class ) {
+    if ( m_dirty[weight_class] ) {
+      reseed(weight_class);
+    }
+  }
+}
+
+void Seeding_engine::reseed(const std::size_t weight_class)
+{
+  const std::vector<Wrestler>& roster {*m_roster};
+  std::vector<std::size_t>& order {m_seeds[weight_class]};
+
+  order = m_members[weight_class];
+  std::sort(order.begin(), order.end(),
+            [&](const std::size_t lhs, const std::size_t rhs) {
+              return roster[lhs].id() < roster[rhs].id();
+            });
+
+  // boundaries of runs still tied under every criterion so far
+  std::vector<std::size_t> bounds {0, order.size()};
+
+  for ( const Seed_criterion criterion : m_criteria ) {
+    std::vector<std::size_t> refined {0};
+    for ( std::size_t run {0}; run + 1 < bounds.size(); ++run ) {
+      const auto first =
+          order.begin() + static_cast<std::ptrdiff_t>(bounds[run]);
+      const auto last =
+          order.begin() + static_cast<std::ptrdiff_t>(bounds[run + 1]);
+      if ( last - first > 1 ) {
+        std::vector<std::size_t> group(first, last);
+        order_group(criterion, group, refined);
+        std::copy(group.begin(), group.end(), first);
+      }
+      refined.push_back(bounds[run + 1]);
+    }
+    bounds = std::move(refined);
+  }
+
+  m_dirty[weight_class] = false;
+}
+
+void Seeding_engine::order_group(
+    const Seed_criterion criterion, std::vector<std::size_t>& group,
+    std::vector<std::size_t>& boundaries) const
+{
+  std::vector<double> key;
+  switch ( criterion ) {
+  case Seed_criterion::head_to_head:
+    key = head_to_head_levels(group);
+    break;
+  case Seed_criterion::common_opponents:
+    key = common_opponent_scores(group);
+    break;
+  case Seed_criterion::rating:
+    for ( const std::size_t slot : group ) {
+      key.push_back(slot < m_rating.size() ? m_rating[slot] : 0.0);
+    }
+    break;
+  case Seed_criterion::ability:
+    for ( const std::size_t slot : group ) {
+      key.push_back((*m_roster)[slot].ability());
+    }
+    break;
+  }
+
+  std::vector<std::size_t> position(group.size());
+  std::iota(position.begin(), position.end(), std::size_t {0});
+  std::stable_sort(position.begin(), position.end(),
+                   [&](const std::size_t lhs, const std::size_t rhs) {
+                     return key[lhs] > key[rhs];
+                   });
+
+  const std::size_t offset {boundaries.back()};
+  std::vector<std::size_t> reordered(group.size());
+  for ( std::size_t index {0}; index != group.size(); ++index ) {
+    reordered[index] = group[position[index]];
+    if ( index != 0 && key[position[index]] < key[position[index - 1]] ) {
+      boundaries.push_back(offset + index);
+    }
+  }
+  group = std::move(reordered);
+}
+
+auto Seeding_engine::head_to_head_levels(
+    const std::vector<std::size_t>& group) const -> std::vector<double>
+{
+  const std::size_t count {group.size()};
+  const std::vector<std::size_t> position {group_positions(group)};
+
+  std::vector<unsigned char> beats(count * count, 0);
+  for ( std::size_t node {0}; node != count; ++node ) {
+    for ( const Opponent_record& record : m_opponents[group[node]] ) {
+      const std::size_t other {position_of(group, position, record.id)};
+      if ( other != unassigned && record.wins > record.losses ) {
+        beats[node * count + other] = 1;
+      }
+    }
+  }
+
+  const std::vector<std::size_t> component {
+      strongly_connected(beats, count)};
+  const std::size_t components {
+      count == 0 ? 0
+                 : *std::max_element(component.begin(), component.end())
+                       + 1};
+
+  // longest path from a source of the condensation; Tarjan numbers
+  // components sinks first, so walk them in descending order
+  std::vector<std::vector<std::size_t>> nodes_of(components);
+  for ( std::size_t node {0}; node != count; ++node ) {
+    nodes_of[component[node]].push_back(node);
+  }
+
+  std::vector<std::size_t> level(components, 0);
+  for ( std::size_t current {components}; current-- != 0; ) {
+    for ( const std::size_t node : nodes_of[current] ) {
+      for ( std::size_t other {0}; other != count; ++other ) {
+        if ( beats[node * count + other] != 0
+             && component[other] != current ) {
+          level[component[other]] =
+              std::max(level[component[other]], level[current] + 1);
+        }
+      }
+    }
+  }
+
+  std::vector<double> key(count);
+  for ( std::size_t node {0}; node != count; ++node ) {
+    key[node] = -static_cast<double>(level[component[node]]);
+  }
+  return key;
+}
+
+auto Seeding_engine::common_opponent_scores(
+    const std::vector<std::size_t>& group) const -> std::vector<double>
+{
+  const std::size_t count {group.size()};
+
+  // lay every member's record out against a shared list of opponents so
+  // each pairwise comparison is a straight pass over two rows
+  std::vector<int> columns;
+  for ( const std::size_t slot : group ) {
+    for ( const Opponent_record& record : m_opponents[slot] ) {
+      columns.push_back(record.id);
+    }
+  }
+  std::sort(columns.begin(), columns.end());
+  columns.erase(std::unique(columns.begin(), columns.end()),
+                columns.end());
+  const std::size_t width {columns.size()};
+
+  std::vector<double> share(count * width, 0.0);
+  std::vector<double> met(count * width, 0.0);
+  for ( std::size_t member {0}; member != count; ++member ) {
+    // opponent lists are sorted by id, as are the columns
+    std::size_t column {0};
+    for ( const Opponent_record& record : m_opponents[group[member]] ) {
+      while ( columns[column] != record.id ) {
+        ++column;
+      }
+      share[member * width + column] =
+          static_cast<double>(record.wins) / (record.wins + record.losses);
+      met[member * width + column] = 1.0;
+    }
+  }
+
+  std::vector<double> points(count, 0.0);
+  for ( std::size_t lhs {0}; lhs != count; ++lhs ) {
+    for ( std::size_t rhs {lhs + 1}; rhs != count; ++rhs ) {
+      const double* const lhs_share {share.data() + lhs * width};
+      const double* const rhs_share {share.data() + rhs * width};
+      const double* const lhs_met {met.data() + lhs * width};
+      const double* const rhs_met {met.data() + rhs * width};
+
+      // branch-free so the compiler can vectorize it; nobody is their own
+      // opponent, so the pair's bouts against each other drop out
+      double margin {0.0};
+      for ( std::size_t column {0}; column != width; ++column ) {
+        margin += lhs_met[column] * rhs_met[column]
+                * (lhs_share[column] - rhs_share[column]);
+      }
+
+      if ( margin > 0.0 ) {
+        points[lhs] += 1.0;
+      } else if ( margin < 0.0 ) {
+        points[rhs] += 1.0;
+      } else {
+        points[lhs] += 0.5;
+        points[rhs] += 0.5;
+      }
+    }
+  }
+
+  return points;
+}
+
+auto Seeding_engine::group_positions(
+    const std::vector<std::size_t>& group) const
+    -> std::vector<std::size_t>
+{
+  std::vector<std::size_t> position(group.size());
+  std::iota(position.begin(), position.end(), std::size_t {0});
+  std::sort(position.begin(), position.end(),
+            [&](const std::size_t lhs, const std::size_t rhs) {
+              return (*m_roster)[group[lhs]].id()
+                   < (*m_roster)[group[rhs]].id();
+            });
+  return position;
+}
+
+auto Seeding_engine::position_of(const std::vector<std::size_t>& group,
+                                 const std::vector<std::size_t>& position,
+                                 const int id) const noexcept
+    -> std::size_t
+{
+  const auto found = std::lower_bound(
+      position.begin(), position.end(), id,
+      [&](const std::size_t member, const int key) {
+        return (*m_roster)[group[member]].id() < key;
+      });
+  return found != position.end() && (*m_roster)[group[*found]].id() == id
+           ? *found
+           : unassigned;
+}
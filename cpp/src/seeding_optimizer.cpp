@@ -0,0 +1,294 @@
+#include "seeding_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "bracket.h"
+#include "parallel.h"
+#include "random.h"
+
+Bracket_evaluator::Bracket_evaluator(const Probability_table& table,
+                                     std::vector<std::size_t> lines)
+    : m_stride {table.size() + 1}
+    , m_probability(m_stride * m_stride, 0.0)
+    , m_lines {std::move(lines)}
+    , m_column(m_lines.size(), table.size())
+    , m_rounds {bracket_rounds(m_lines.size())}
+    , m_rank(table.size(), 0)
+    , m_entrants {0}
+    , m_reach((m_rounds + 1) * m_lines.size(), 0.0)
+{
+  // rank entrants by expected wins against the rest of the field
+  std::vector<std::size_t> present;
+  for ( const std::size_t entrant : m_lines ) {
+    if ( entrant != bye_line ) {
+      present.push_back(entrant);
+    }
+  }
+  m_entrants = present.size();
+
+  for ( std::size_t line {0}; line != m_lines.size(); ++line ) {
+    if ( m_lines[line] != bye_line ) {
+      m_column[line] = m_lines[line];
+    }
+  }
+  for ( std::size_t row {0}; row != table.size(); ++row ) {
+    std::copy_n(table.data() + row * table.size(), table.size(),
+                m_probability.begin()
+                    + static_cast<std::ptrdiff_t>(row * m_stride));
+  }
+
+  std::vector<double> strength(table.size(), 0.0);
+  for ( const std::size_t entrant : present ) {
+    for ( const std::size_t opponent : present ) {
+      if ( opponent != entrant ) {
+        strength[entrant] += table(entrant, opponent);
+      }
+    }
+  }
+  std::stable_sort(present.begin(), present.end(),
+                   [&](const std::size_t lhs, const std::size_t rhs) {
+                     return strength[lhs] > strength[rhs];
+                   });
+  for ( std::size_t rank {0}; rank != present.size(); ++rank ) {
+    m_rank[present[rank]] = rank;
+  }
+
+  evaluate();
+}
+
+auto Bracket_evaluator::compute(const std::size_t round,
+                                const std::size_t line) const noexcept
+    -> double
+{
+  const std::size_t entrant {m_lines[line]};
+  if ( entrant == bye_line ) {
+    return 0.0;
+  }
+
+  const std::size_t half {std::size_t {1} << (round - 1)};
+  const std::size_t opponents {(line ^ half) & ~(half - 1)};
+  const double* const row {&m_probability[entrant * m_stride]};
+  const double* const previous {&m_reach[cell(round - 1, 0)]};
+
+  // byes reach nothing and have a zero column, so no branches
+  double present {0.0};
+  double wins {0.0};
+  for ( std::size_t other {opponents}; other != opponents + half;
+        ++other ) {
+    present += previous[other];
+    wins += previous[other] * row[m_column[other]];
+  }
+
+  // an empty half means a bye through this round
+  return previous[line] * (present > 0.0 ? wins : 1.0);
+}
+
+auto Bracket_evaluator::contribution(const std::size_t round,
+                                     const std::size_t line,
+                                     const double reach) const noexcept
+    -> double
+{
+  const std::size_t entrant {m_lines[line]};
+  if ( entrant == bye_line ) {
+    return 0.0;
+  }
+  const std::size_t survivors {
+      std::min(m_entrants, m_lines.size() >> round)};
+  const double chalk {m_rank[entrant] < survivors ? 1.0 : 0.0};
+  return (reach - chalk) * (reach - chalk);
+}
+
+void Bracket_evaluator::evaluate()
+{
+  m_objective = 0.0;
+  for ( std::size_t line {0}; line != m_lines.size(); ++line ) {
+    m_reach[cell(0, line)] = m_lines[line] == bye_line ? 0.0 : 1.0;
+  }
+  for ( std::size_t round {1}; round <= m_rounds; ++round ) {
+    for ( std::size_t line {0}; line != m_lines.size(); ++line ) {
+      const double reach {compute(round, line)};
+      m_reach[cell(round, line)] = reach;
+      m_objective += contribution(round, line, reach);
+    }
+  }
+}
+
+void Bracket_evaluator::refresh_block(const std::size_t round,
+                                      const std::size_t block)
+{
+  const std::size_t first {block << round};
+  const std::size_t last {(block + 1) << round};
+  for ( std::size_t line {first}; line != last; ++line ) {
+    double& reach {m_reach[cell(round, line)]};
+    m_undo_cells.emplace_back(cell(round, line), reach);
+    reach = compute(round, line);
+    m_objective += contribution(round, line, reach);
+  }
+}
+
+void Bracket_evaluator::swap(const std::size_t lhs, const std::size_t rhs)
+{
+  m_undo_cells.clear();
+  m_undo_lhs       = lhs;
+  m_undo_rhs       = rhs;
+  m_undo_objective = m_objective;
+
+  // contributions depend on who holds the line, so retire the old ones
+  // before the entrants move
+  for ( std::size_t round {1}; round <= m_rounds; ++round ) {
+    const std::size_t lhs_block {lhs >> round};
+    const std::size_t rhs_block {rhs >> round};
+    for ( const std::size_t block : {lhs_block, rhs_block} ) {
+      for ( std::size_t line {block << round};
+            line != (block + 1) << round; ++line ) {
+        m_objective -=
+            contribution(round, line, m_reach[cell(round, line)]);
+      }
+      if ( lhs_block == rhs_block ) {
+        break;
+      }
+    }
+  }
+
+  std::swap(m_lines[lhs], m_lines[rhs]);
+  std::swap(m_column[lhs], m_column[rhs]);
+
+  // a bye may have moved
+  for ( const std::size_t line : {lhs, rhs} ) {
+    double& reach {m_reach[cell(0, line)]};
+    m_undo_cells.emplace_back(cell(0, line), reach);
+    reach = m_lines[line] == bye_line ? 0.0 : 1.0;
+  }
+
+  for ( std::size_t round {1}; round <= m_rounds; ++round ) {
+    refresh_block(round, lhs >> round);
+    if ( (lhs >> round) != (rhs >> round) ) {
+      refresh_block(round, rhs >> round);
+    }
+  }
+}
+
+void Bracket_evaluator::undo()
+{
+  if ( m_undo_cells.empty() ) {
+    return;
+  }
+  for ( auto it = m_undo_cells.rbegin(); it != m_undo_cells.rend();
+        ++it ) {
+    m_reach[it->first] = it->second;
+  }
+  m_undo_cells.clear();
+  std::swap(m_lines[m_undo_lhs], m_lines[m_undo_rhs]);
+  std::swap(m_column[m_undo_lhs], m_column[m_undo_rhs]);
+  m_objective = m_undo_objective;
+}
+
+namespace {
+
+struct Replica {
+  Bracket_evaluator state;
+  Rng rng;
+  std::vector<std::size_t> best_lines;
+  double best;
+  std::size_t evaluations;
+};
+
+} // namespace
+
+auto optimize_seeding(const Probability_table& table,
+                      std::vector<std::size_t> lines,
+                      const std::vector<bool>& pinned,
+                      const Tempering_params& params) -> Seeding_result
+{
+  std::vector<std::size_t> movable;
+  for ( std::size_t line {0}; line != lines.size(); ++line ) {
+    const bool fixed {line < pinned.size() && pinned[line]};
+    if ( !fixed && lines[line] != bye_line ) {
+      movable.push_back(line);
+    }
+  }
+
+  const Bracket_evaluator initial {table, std::move(lines)};
+  Seeding_result result {initial.lines(), initial.objective(),
+                         initial.objective(), 1};
+  if ( movable.size() < 2 || params.replicas == 0 ) {
+    return result;
+  }
+
+  const std::size_t count {params.replicas};
+  std::vector<double> temperature(count, params.min_temperature);
+  for ( std::size_t slot {1}; slot < count; ++slot ) {
+    temperature[slot] =
+        params.min_temperature
+        * std::pow(params.max_temperature / params.min_temperature,
+                   static_cast<double>(slot)
+                       / static_cast<double>(count - 1));
+  }
+
+  std::vector<Replica> replicas;
+  replicas.reserve(count);
+  for ( std::size_t slot {0}; slot != count; ++slot ) {
+    replicas.push_back({initial, Rng {params.seed, slot},
+                        initial.lines(), initial.objective(), 0});
+  }
+
+  const auto choices = static_cast<std::uint32_t>(movable.size());
+  Rng exchange_rng {params.seed, count};
+
+  for ( std::size_t sweep {0}; sweep != params.sweeps; ++sweep ) {
+    parallel_for(
+        count,
+        [&](std::size_t, const std::size_t begin, const std::size_t end) {
+          for ( std::size_t slot {begin}; slot != end; ++slot ) {
+            Replica& replica {replicas[slot]};
+            for ( std::size_t step {0}; step != params.steps_per_sweep;
+                  ++step ) {
+              const std::size_t lhs {movable[replica.rng.below(choices)]};
+              const std::size_t rhs {movable[replica.rng.below(choices)]};
+              if ( lhs == rhs ) {
+                continue;
+              }
+              const double before {replica.state.objective()};
+              replica.state.swap(lhs, rhs);
+              ++replica.evaluations;
+
+              const double delta {replica.state.objective() - before};
+              if ( delta > 0.0
+                   && replica.rng.uniform()
+                          >= std::exp(-delta / temperature[slot]) ) {
+                replica.state.undo();
+              } else if ( replica.state.objective() < replica.best ) {
+                replica.best       = replica.state.objective();
+                replica.best_lines = replica.state.lines();
+              }
+            }
+          }
+        },
+        params.threads);
+
+    // exchange neighbours, alternating which pairs are tried
+    for ( std::size_t slot {sweep % 2}; slot + 1 < count; slot += 2 ) {
+      const double energy_gap {replicas[slot].state.objective()
+                               - replicas[slot + 1].state.objective()};
+      const double beta_gap {1.0 / temperature[slot]
+                             - 1.0 / temperature[slot + 1]};
+      const double chance {std::exp(std::min(0.0, energy_gap * beta_gap))};
+      if ( exchange_rng.uniform() < chance ) {
+        std::swap(replicas[slot].state, replicas[slot + 1].state);
+      }
+    }
+  }
+
+  for ( const Replica& replica : replicas ) {
+    result.evaluations += replica.evaluations;
+    if ( replica.best < result.objective ) {
+      result.objective = replica.best;
+      result.lines     = replica.best_lines;
+    }
+  }
+
+  // incremental updates drift; report the exact value for the winner
+  result.objective = Bracket_evaluator {table, result.lines}.objective();
+  return result;
+}
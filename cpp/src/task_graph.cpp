@@ -0,0 +1,168 @@
+#include "task_graph.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "parallel.h"
+#include "work_deque.h"
+
+namespace {
+
+/// Failed searches for work before an idle worker goes to sleep
+constexpr std::size_t spin_limit {64};
+
+} // namespace
+
+auto Task_graph::add(std::function<void()> work,
+                     const std::vector<Task_id>& after) -> Task_id
+{
+  const Task_id id {m_tasks.size()};
+  for ( const Task_id dependency : after ) {
+    if ( dependency >= id ) {
+      throw std::out_of_range {"Task depends on an unknown task"};
+    }
+    m_tasks[dependency].dependents.push_back(id);
+  }
+  m_tasks.push_back({std::move(work), {}, after.size()});
+  return id;
+}
+
+void Task_graph::run(const std::size_t threads)
+{
+  execute(threads == 0 ? hardware_threads() : threads);
+}
+
+void Task_graph::run_deterministic()
+{
+  execute(1);
+}
+
+void Task_graph::execute(const std::size_t threads)
+{
+  constexpr Task_id none {Work_deque::empty};
+  const std::size_t count {m_tasks.size()};
+
+  std::vector<std::atomic<std::size_t>> waiting(count);
+  std::atomic<std::size_t> unfinished {count};
+  std::atomic<bool> failed {false};
+  std::mutex failure_mutex;
+  std::exception_ptr failure {};
+
+  // idle workers sleep until the epoch moves: a task was pushed or the
+  // last one finished
+  std::atomic<std::uint64_t> epoch {0};
+  std::atomic<std::size_t> sleepers {0};
+  std::mutex idle_mutex;
+  std::condition_variable idle;
+  const auto wake = [&] {
+    epoch.fetch_add(1);
+    if ( sleepers.load() != 0 ) {
+      const std::lock_guard<std::mutex> lock {idle_mutex};
+      idle.notify_all();
+    }
+  };
+
+  // a task is pushed at most once, so no deque can outgrow the graph
+  std::vector<std::unique_ptr<Work_deque>> deques;
+  for ( std::size_t worker {0}; worker != threads; ++worker ) {
+    deques.push_back(std::make_unique<Work_deque>(count));
+  }
+
+  // deal the roots out round robin; later roots end up on top, so each
+  // worker starts from the last it was dealt
+  std::size_t dealt {0};
+  for ( Task_id id {0}; id != count; ++id ) {
+    waiting[id].store(m_tasks[id].dependencies, std::memory_order_relaxed);
+    if ( m_tasks[id].dependencies == 0 ) {
+      deques[dealt++ % threads]->push(id);
+    }
+  }
+
+  /// Run `id` unless a task has failed; returns its continuation
+  const auto complete = [&](const Task_id id, Work_deque& own) {
+    if ( !failed.load(std::memory_order_relaxed) ) {
+      try {
+        m_tasks[id].work();
+      } catch ( ... ) {
+        const std::lock_guard<std::mutex> lock {failure_mutex};
+        if ( !failure ) {
+          failure = std::current_exception();
+        }
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+
+    // skipped tasks still release their dependents so the run drains
+    Task_id next {none};
+    bool pushed {false};
+    for ( const Task_id dependent : m_tasks[id].dependents ) {
+      if ( waiting[dependent].fetch_sub(1, std::memory_order_acq_rel)
+           == 1 ) {
+        if ( next == none ) {
+          next = dependent;
+        } else {
+          own.push(dependent);
+          pushed = true;
+        }
+      }
+    }
+    if ( unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1
+         || pushed ) {
+      wake();
+    }
+    return next;
+  };
+
+  const auto worker = [&](const std::size_t self) {
+    Work_deque& own {*deques[self]};
+    std::size_t failures {0};
+    while ( unfinished.load(std::memory_order_acquire) != 0 ) {
+      // read before searching, so work pushed after the search shows
+      const std::uint64_t seen {epoch.load()};
+      Task_id id {own.pop()};
+      for ( std::size_t offset {1}; id == none && offset < threads;
+            ++offset ) {
+        id = deques[(self + offset) % threads]->steal();
+      }
+      if ( id == none ) {
+        if ( ++failures < spin_limit ) {
+          std::this_thread::yield();
+          continue;
+        }
+        std::unique_lock<std::mutex> lock {idle_mutex};
+        sleepers.fetch_add(1);
+        idle.wait(lock, [&] {
+          return epoch.load() != seen
+              || unfinished.load(std::memory_order_acquire) == 0;
+        });
+        sleepers.fetch_sub(1);
+        failures = 0;
+        continue;
+      }
+      failures = 0;
+      while ( id != none ) {
+        id = complete(id, own);
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for ( std::size_t index {1}; index < threads; ++index ) {
+    workers.emplace_back(worker, index);
+  }
+  worker(0);
+  for ( auto& thread : workers ) {
+    thread.join();
+  }
+
+  if ( failure ) {
+    std::rethrow_exception(failure);
+  }
+}
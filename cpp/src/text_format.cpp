@@ -0,0 +1,120 @@
+#include "text_format.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+Text_buffer::Text_buffer(const std::size_t capacity)
+    : m_data(std::max(capacity, fixed_chars(64)))
+{}
+
+Text_buffer::Text_buffer(std::FILE* const stream,
+                         const std::size_t capacity)
+    : m_data(std::max(capacity, fixed_chars(64)))
+    , m_stream {stream}
+{}
+
+Text_buffer::~Text_buffer()
+{
+  try {
+    flush();
+  } catch ( ... ) { // NOLINT(bugprone-empty-catch)
+    // a closed pipe is no reason to abort
+  }
+}
+
+auto Text_buffer::room(const std::size_t bytes) -> char*
+{
+  if ( m_size + bytes > m_data.size() ) {
+    if ( m_stream != nullptr ) {
+      flush();
+    }
+    if ( m_size + bytes > m_data.size() ) {
+      m_data.resize(std::max(m_size + bytes, 2 * m_data.size()));
+    }
+  }
+  return m_data.data() + m_size;
+}
+
+auto Text_buffer::format(char* const first, char* const last,
+                         const Fixed value) -> char*
+{
+  if ( !std::isfinite(value.value) ) {
+    const std::string_view text {std::isnan(value.value) ? "nan"
+                                 : value.value < 0       ? "-inf"
+                                                         : "inf"};
+    std::memcpy(first, text.data(), text.size());
+    return first + text.size();
+  }
+  return std::to_chars(first, last, value.value, std::chars_format::fixed,
+                       std::clamp(value.decimals, 0, 64))
+      .ptr;
+}
+
+void Text_buffer::flush()
+{
+  if ( m_stream == nullptr || m_size == 0 ) {
+    return;
+  }
+  const std::size_t size {m_size};
+  m_size = 0;
+  if ( std::fwrite(m_data.data(), 1, size, m_stream) != size ) {
+    throw std::runtime_error {"Failed to write formatted text"};
+  }
+}
+
+auto Text_buffer::operator<<(const std::string_view text) -> Text_buffer&
+{
+  if ( m_stream != nullptr && text.size() > m_data.size() ) {
+    // too long to be worth copying
+    flush();
+    if ( std::fwrite(text.data(), 1, text.size(), m_stream)
+         != text.size() ) {
+      throw std::runtime_error {"Failed to write formatted text"};
+    }
+    return *this;
+  }
+  std::memcpy(room(text.size()), text.data(), text.size());
+  m_size += text.size();
+  return *this;
+}
+
+auto Text_buffer::operator<<(const char character) -> Text_buffer&
+{
+  *room(1) = character;
+  ++m_size;
+  return *this;
+}
+
+auto Text_buffer::operator<<(const bool value) -> Text_buffer&
+{
+  return *this << std::string_view {value ? "true" : "false"};
+}
+
+auto Text_buffer::operator<<(const Fixed value) -> Text_buffer&
+{
+  const std::size_t bytes {fixed_chars(std::clamp(value.decimals, 0, 64))};
+  char* const first {room(bytes)};
+  m_size += static_cast<std::size_t>(format(first, first + bytes, value)
+                                     - first);
+  return *this;
+}
+
+auto Text_buffer::operator<<(const Padded<std::string_view>& padded)
+    -> Text_buffer&
+{
+  const std::size_t fill {
+      padded.width > padded.value.size()
+          ? padded.width - padded.value.size()
+          : 0};
+  if ( padded.align == Align::left ) {
+    *this << padded.value;
+  }
+  std::memset(room(fill), padded.fill, fill);
+  m_size += fill;
+  if ( padded.align == Align::right ) {
+    *this << padded.value;
+  }
+  return *this;
+}
@@ -0,0 +1,40 @@
+#include "tournament.h"
+
+#include <algorithm>
+
+#include "bracket.h"
+
+auto seeded_lines(const std::vector<std::size_t>& entrants,
+                  const std::vector<int>& strength)
+    -> std::vector<std::size_t>
+{
+  std::vector<std::size_t> ranked {entrants};
+  std::stable_sort(ranked.begin(), ranked.end(),
+                   [&](const std::size_t lhs, const std::size_t rhs) {
+                     return strength[lhs] > strength[rhs];
+                   });
+
+  const std::size_t size {bracket_size(ranked.size())};
+  const std::vector<std::size_t> seeds {seed_order(size)};
+  std::vector<std::size_t> lines(size, bye_line);
+  for ( std::size_t line {0}; line != size; ++line ) {
+    if ( seeds[line] <= ranked.size() ) {
+      lines[line] = ranked[seeds[line] - 1];
+    }
+  }
+  return lines;
+}
+
+auto simulate_bracket(const std::vector<std::size_t>& lines,
+                      const Probability_table& table, Rng& rng,
+                      const std::size_t places) -> std::vector<std::size_t>
+{
+  std::vector<std::size_t> order;
+  if ( !lines.empty() && places != 0 ) {
+    auto decide = [&](const std::size_t top, const std::size_t bottom) {
+      return rng.uniform() < table(top, bottom) ? top : bottom;
+    };
+    play_bracket(lines, places, order, decide);
+  }
+  return order;
+}
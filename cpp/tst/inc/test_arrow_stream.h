@@ -0,0 +1,14 @@
+#ifndef TEST_ARROW_STREAM_H
+#define TEST_ARROW_STREAM_H
+
+#include "arrow_stream.h"
+#include "result_tables.h"
+#include "test_utils.hpp"
+
+auto test_arrow_framing() -> ehanc::test;
+auto test_arrow_dictionary() -> ehanc::test;
+auto test_result_tables() -> ehanc::test;
+
+void test_arrow_stream();
+
+#endif
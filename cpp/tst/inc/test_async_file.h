@@ -0,0 +1,13 @@
+#ifndef TEST_ASYNC_FILE_H
+#define TEST_ASYNC_FILE_H
+
+#include "async_file.h"
+#include "test_utils.hpp"
+
+auto test_async_file_backends() -> ehanc::test;
+auto test_async_file_results() -> ehanc::test;
+auto test_async_file_unwinding() -> ehanc::test;
+
+void test_async_file();
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef TEST_BOUT_LOG_H
+#define TEST_BOUT_LOG_H
+
+#include "bout_log.h"
+#include "test_utils.hpp"
+
+auto test_bout_log_round_trip() -> ehanc::test;
+auto test_bout_log_seek() -> ehanc::test;
+auto test_bout_log_corruption() -> ehanc::test;
+auto test_bout_log_bounds() -> ehanc::test;
+auto test_bout_log_failure() -> ehanc::test;
+
+void test_bout_log();
+
+#endif
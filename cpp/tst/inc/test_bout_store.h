@@ -0,0 +1,14 @@
+#ifndef TEST_BOUT_STORE_H
+#define TEST_BOUT_STORE_H
+
+#include "bout_store.h"
+#include "test_utils.hpp"
+
+auto test_varint_round_trip() -> ehanc::test;
+auto test_bout_segment_round_trip() -> ehanc::test;
+auto test_bout_store_season_query() -> ehanc::test;
+auto test_bout_store_failed_flush() -> ehanc::test;
+
+void test_bout_store();
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef TEST_BOUTS_HPP
+#define TEST_BOUTS_HPP
+
+#include "bout.h"
+
+/// A decision with no score, for tests that only care who beat whom
+inline auto make_bout(const int winner, const int loser,
+                      const int date = 0, const int tournament = 0)
+    -> Bout
+{
+  Bout bout;
+  bout.winner     = winner;
+  bout.loser      = loser;
+  bout.date       = date;
+  bout.tournament = tournament;
+  return bout;
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TEST_BRACKET_PLACEMENT_H
+#define TEST_BRACKET_PLACEMENT_H
+
+#include "bracket_placement.h"
+#include "test_utils.hpp"
+
+auto test_seed_order() -> ehanc::test;
+auto test_placement_seeds_and_byes() -> ehanc::test;
+auto test_placement_teammate_separation() -> ehanc::test;
+auto test_placement_reproducible() -> ehanc::test;
+
+void test_bracket_placement();
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TEST_BRADLEY_TERRY_H
+#define TEST_BRADLEY_TERRY_H
+
+#include "bradley_terry.h"
+#include "test_utils.hpp"
+
+auto test_win_matrix() -> ehanc::test;
+auto test_bradley_terry_order() -> ehanc::test;
+auto test_bradley_terry_warm_start() -> ehanc::test;
+
+void test_bradley_terry();
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TEST_EXTERNAL_SORT_H
+#define TEST_EXTERNAL_SORT_H
+
+#include "external_sort.h"
+#include "test_utils.hpp"
+
+auto test_external_partitions() -> ehanc::test;
+auto test_external_errors() -> ehanc::test;
+
+void test_external_sort();
+
+#endif
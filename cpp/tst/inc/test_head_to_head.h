@@ -0,0 +1,12 @@
+#ifndef TEST_HEAD_TO_HEAD_H
+#define TEST_HEAD_TO_HEAD_H
+
+#include "head_to_head.h"
+#include "test_utils.hpp"
+
+auto test_head_to_head_lookup() -> ehanc::test;
+auto test_head_to_head_parallel_build() -> ehanc::test;
+
+void test_head_to_head();
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TEST_LEAGUE_H
+#define TEST_LEAGUE_H
+
+#include "league.h"
+#include "test_utils.hpp"
+
+auto test_arena() -> ehanc::test;
+auto test_round_robin() -> ehanc::test;
+auto test_league_season() -> ehanc::test;
+auto test_league_monte_carlo() -> ehanc::test;
+
+void test_league();
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TEST_LINEUP_H
+#define TEST_LINEUP_H
+
+#include "lineup.h"
+#include "test_utils.hpp"
+
+auto test_weight_class_eligibility() -> ehanc::test;
+auto test_assignment_solver() -> ehanc::test;
+auto test_lineup_optimizer() -> ehanc::test;
+
+void test_lineup();
+
+#endif
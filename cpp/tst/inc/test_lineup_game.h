@@ -0,0 +1,14 @@
+#ifndef TEST_LINEUP_GAME_H
+#define TEST_LINEUP_GAME_H
+
+#include "lineup_game.h"
+#include "test_utils.hpp"
+
+auto test_matrix_game_value() -> ehanc::test;
+auto test_prune_dominated() -> ehanc::test;
+auto test_enumerate_lineups() -> ehanc::test;
+auto test_lineup_game_equilibrium() -> ehanc::test;
+
+void test_lineup_game();
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TEST_NUMA_H
+#define TEST_NUMA_H
+
+#include "numa.h"
+#include "test_utils.hpp"
+
+auto test_parse_cpu_list() -> ehanc::test;
+auto test_numa_discover() -> ehanc::test;
+auto test_node_replicated() -> ehanc::test;
+
+void test_numa();
+
+#endif
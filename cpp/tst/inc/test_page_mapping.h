@@ -0,0 +1,13 @@
+#ifndef TEST_PAGE_MAPPING_H
+#define TEST_PAGE_MAPPING_H
+
+#include "page_mapping.h"
+#include "test_utils.hpp"
+
+auto test_smaps_coverage() -> ehanc::test;
+auto test_page_mapping_alignment() -> ehanc::test;
+auto test_huge_page_arena() -> ehanc::test;
+
+void test_page_mapping();
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TEST_QUALIFIER_H
+#define TEST_QUALIFIER_H
+
+#include "qualifier.h"
+#include "test_utils.hpp"
+
+auto test_simulate_bracket() -> ehanc::test;
+auto test_qualifier_odds() -> ehanc::test;
+
+void test_qualifier();
+
+#endif
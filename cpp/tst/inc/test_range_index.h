@@ -0,0 +1,12 @@
+#ifndef TEST_RANGE_INDEX_H
+#define TEST_RANGE_INDEX_H
+
+#include "range_index.h"
+#include "test_utils.hpp"
+
+auto test_range_query() -> ehanc::test;
+auto test_range_bitmap() -> ehanc::test;
+
+void test_range_index();
+
+#endif
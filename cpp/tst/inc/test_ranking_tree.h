@@ -0,0 +1,12 @@
+#ifndef TEST_RANKING_TREE_H
+#define TEST_RANKING_TREE_H
+
+#include "ranking_tree.h"
+#include "test_utils.hpp"
+
+auto test_ranking_tree_order() -> ehanc::test;
+auto test_class_rankings() -> ehanc::test;
+
+void test_ranking_tree();
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TEST_RATING_H
+#define TEST_RATING_H
+
+#include "rating.h"
+#include "test_utils.hpp"
+
+auto test_elo_update() -> ehanc::test;
+auto test_elo_process() -> ehanc::test;
+auto test_glicko2_update() -> ehanc::test;
+auto test_apply_ratings() -> ehanc::test;
+
+void test_rating();
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TEST_REPLAY_H
+#define TEST_REPLAY_H
+
+#include "replay.h"
+#include "test_utils.hpp"
+
+auto test_replay_determinism() -> ehanc::test;
+auto test_replay_find_champion() -> ehanc::test;
+auto test_replay_injection() -> ehanc::test;
+auto test_replay_unreached_injection() -> ehanc::test;
+
+void test_replay();
+
+#endif
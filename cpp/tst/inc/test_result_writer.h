@@ -0,0 +1,15 @@
+#ifndef TEST_RESULT_WRITER_H
+#define TEST_RESULT_WRITER_H
+
+#include "result_writer.h"
+#include "test_utils.hpp"
+
+auto test_result_encoding() -> ehanc::test;
+auto test_result_producers() -> ehanc::test;
+auto test_result_backpressure() -> ehanc::test;
+auto test_result_sink_failure() -> ehanc::test;
+auto test_result_failure_unwinding() -> ehanc::test;
+
+void test_result_writer();
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TEST_ROSTER_FILE_H
+#define TEST_ROSTER_FILE_H
+
+#include "roster_file.h"
+#include "test_utils.hpp"
+
+auto test_roster_generator() -> ehanc::test;
+auto test_roster_binary() -> ehanc::test;
+auto test_roster_csv() -> ehanc::test;
+
+void test_roster_file();
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TEST_ROSTER_VALIDATION_H
+#define TEST_ROSTER_VALIDATION_H
+
+#include "roster_validation.h"
+#include "test_utils.hpp"
+
+auto test_validate_ranges() -> ehanc::test;
+auto test_validate_classes() -> ehanc::test;
+auto test_validate_duplicates() -> ehanc::test;
+
+void test_roster_validation();
+
+#endif
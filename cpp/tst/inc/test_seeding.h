@@ -0,0 +1,13 @@
+#ifndef TEST_SEEDING_H
+#define TEST_SEEDING_H
+
+#include "seeding.h"
+#include "test_utils.hpp"
+
+auto test_seeding_circular_head_to_head() -> ehanc::test;
+auto test_seeding_incremental() -> ehanc::test;
+auto test_seeding_common_opponents() -> ehanc::test;
+
+void test_seeding();
+
+#endif
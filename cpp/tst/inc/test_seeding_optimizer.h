@@ -0,0 +1,13 @@
+#ifndef TEST_SEEDING_OPTIMIZER_H
+#define TEST_SEEDING_OPTIMIZER_H
+
+#include "seeding_optimizer.h"
+#include "test_utils.hpp"
+
+auto test_bracket_probabilities() -> ehanc::test;
+auto test_incremental_swap() -> ehanc::test;
+auto test_optimize_seeding() -> ehanc::test;
+
+void test_seeding_optimizer();
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef TEST_TASK_GRAPH_H
+#define TEST_TASK_GRAPH_H
+
+#include "task_graph.h"
+#include "test_utils.hpp"
+
+auto test_work_deque() -> ehanc::test;
+auto test_task_graph_order() -> ehanc::test;
+auto test_task_graph_failure() -> ehanc::test;
+auto test_task_graph_deterministic() -> ehanc::test;
+auto test_task_graph_stealing() -> ehanc::test;
+auto test_task_graph_idle() -> ehanc::test;
+
+void test_task_graph();
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TEST_TEXT_FORMAT_H
+#define TEST_TEXT_FORMAT_H
+
+#include "test_utils.hpp"
+#include "text_format.h"
+
+auto test_format_numbers() -> ehanc::test;
+auto test_format_padding() -> ehanc::test;
+auto test_format_flush() -> ehanc::test;
+
+void test_text_format();
+
+#endif
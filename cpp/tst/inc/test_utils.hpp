@@ -1,10 +1,8 @@
 #ifndef EHANC_TEST_UTILS_HPP
 #define EHANC_TEST_UTILS_HPP
 
+#include <cstdio>
 #include <functional>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -13,6 +11,8 @@
 #include <supl/term_colors.h>
 #include <supl/utility.hpp>
 
+#include "text_format.h"
+
 constexpr inline int TEST_OUTPUT_WIDTH         = 60;
 constexpr inline std::string_view HEADER_COLOR = supl::FG_RED;
 
@@ -37,11 +37,10 @@ public:
     ++m_case_index;
     if ( result != expected ) {
       m_pass = false;
-      std::stringstream detail;
+      Text_buffer detail {256};
 
-      detail << std::boolalpha << std::left << std::setw(10)
-             << supl::FG_RED << "Case " << m_case_index << '\t' << message
-             << "\n\n\tExpected:\n"
+      detail << Padded {std::string_view {supl::FG_RED}, 10} << "Case "
+             << m_case_index << '\t' << message << "\n\n\tExpected:\n"
              << supl::RESET << '\t' << supl::to_string(expected)
              << supl::FG_RED << "\n\n\tGot:\n"
              << supl::RESET << '\t' << supl::to_string(result) << '\n'
@@ -65,6 +64,13 @@ public:
 
 }; // class test
 
+/// Every test reports through this one buffer, flushed as each finishes
+inline auto test_output() -> Text_buffer&
+{
+  static Text_buffer out {stdout};
+  return out;
+}
+
 template <typename TestFunc>
 inline void run_test(const std::string_view name, TestFunc&& test_func)
 {
@@ -72,21 +78,21 @@ inline void run_test(const std::string_view name, TestFunc&& test_func)
                 "Test function must have correct signature");
 
   test result = test_func();
+  Text_buffer& out {test_output()};
 
   if ( result.pass() ) {
-    std::cout << std::left << std::setw(TEST_OUTPUT_WIDTH)
-              << std::setfill('.') << name << supl::FG_GREEN << "PASS"
-              << supl::RESET << '\n';
+    out << Padded {name, TEST_OUTPUT_WIDTH, '.'} << supl::FG_GREEN
+        << "PASS" << supl::RESET << '\n';
   } else {
-    std::cout << std::left << std::setw(TEST_OUTPUT_WIDTH)
-              << std::setfill('.') << name << supl::FG_RED << "FAIL"
-              << supl::RESET << '\n'
-              << '\n';
+    out << Padded {name, TEST_OUTPUT_WIDTH, '.'} << supl::FG_RED << "FAIL"
+        << supl::RESET << '\n'
+        << '\n';
 
     for ( const auto& details : result.cases() ) {
-      std::cout << details;
+      out << details;
     }
   }
+  out.flush();
 }
 
 template <typename Func>
@@ -95,10 +101,13 @@ inline void test_section(const std::string_view section_name,
 {
   static_assert(std::is_invocable_r_v<void, Func>);
 
-  std::cout << '\n';
-  std::cout << HEADER_COLOR << section_name << ':' << supl::RESET << '\n';
+  Text_buffer& out {test_output()};
+  out << '\n' << HEADER_COLOR << section_name << ':' << supl::RESET
+      << '\n';
+  out.flush();
   section_func();
-  std::cout << '\n';
+  out << '\n';
+  out.flush();
 }
 
 } // namespace ehanc
@@ -1,8 +1,58 @@
+#include "test_arrow_stream.h"
+#include "test_async_file.h"
+#include "test_bout_log.h"
+#include "test_bout_store.h"
+#include "test_bracket_placement.h"
+#include "test_bradley_terry.h"
+#include "test_external_sort.h"
+#include "test_head_to_head.h"
+#include "test_league.h"
+#include "test_lineup.h"
+#include "test_lineup_game.h"
+#include "test_numa.h"
+#include "test_page_mapping.h"
+#include "test_qualifier.h"
+#include "test_range_index.h"
+#include "test_ranking_tree.h"
+#include "test_rating.h"
+#include "test_replay.h"
+#include "test_result_writer.h"
+#include "test_roster_file.h"
+#include "test_roster_validation.h"
+#include "test_seeding.h"
+#include "test_seeding_optimizer.h"
+#include "test_task_graph.h"
+#include "test_text_format.h"
 #include "test_utils.hpp"
 
 auto main([[maybe_unused]] const int argc,
           [[maybe_unused]] const char* const* const argv) -> int
 {
+  test_rating();
+  test_bradley_terry();
+  test_bout_store();
+  test_head_to_head();
+  test_seeding();
+  test_bracket_placement();
+  test_seeding_optimizer();
+  test_lineup();
+  test_lineup_game();
+  test_league();
+  test_task_graph();
+  test_qualifier();
+  test_numa();
+  test_page_mapping();
+  test_result_writer();
+  test_async_file();
+  test_bout_log();
+  test_replay();
+  test_arrow_stream();
+  test_text_format();
+  test_roster_file();
+  test_roster_validation();
+  test_range_index();
+  test_ranking_tree();
+  test_external_sort();
 
   return 0;
 }
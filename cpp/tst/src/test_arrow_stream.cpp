@@ -0,0 +1,181 @@
+#include "test_arrow_stream.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Message {
+  std::uint8_t header_type {};
+  std::size_t metadata_bytes {};
+  std::int64_t body_bytes {};
+};
+
+template <typename T>
+auto read(const std::vector<unsigned char>& bytes, const std::size_t at)
+    -> T
+{
+  T value {};
+  std::memcpy(&value, bytes.data() + at, sizeof(T));
+  return value;
+}
+
+/// Walk the stream's framing, reading just enough of each message's
+/// flatbuffer to find its type and body length
+auto messages(const std::vector<unsigned char>& stream)
+    -> std::vector<Message>
+{
+  std::vector<Message> found;
+  std::size_t at {0};
+  while ( read<std::uint32_t>(stream, at + 4) != 0 ) {
+    Message message;
+    message.metadata_bytes = read<std::uint32_t>(stream, at + 4);
+    const std::size_t metadata {at + 8};
+    const std::size_t table {metadata
+                             + read<std::uint32_t>(stream, metadata)};
+    const auto vtable = static_cast<std::size_t>(
+        static_cast<std::int64_t>(table)
+        - read<std::int32_t>(stream, table));
+    message.header_type = read<std::uint8_t>(
+        stream, table + read<std::uint16_t>(stream, vtable + 6));
+    message.body_bytes = read<std::int64_t>(
+        stream, table + read<std::uint16_t>(stream, vtable + 10));
+    found.push_back(message);
+    at = metadata + message.metadata_bytes
+       + static_cast<std::size_t>(message.body_bytes);
+  }
+  return found;
+}
+
+} // namespace
+
+auto test_arrow_framing() -> ehanc::test
+{
+  ehanc::test results;
+
+  Arrow_table table {3};
+  table.add_int32("id", {1, 2, 3});
+  table.add_int64("bouts", {10, 20, 30});
+  table.add_float64("rate", {0.5, 0.25, 0.125});
+  const std::vector<unsigned char> stream {table.encode()};
+  const std::vector<Message> found {messages(stream)};
+
+  results.add_case(found.size(), std::size_t {2},
+                   "Schema and record batch");
+  results.add_case(found.front().header_type, std::uint8_t {1});
+  results.add_case(found.back().header_type, std::uint8_t {3});
+  // twelve bytes of ids padded to 16, then 24 of each 64-bit column
+  results.add_case(found.back().body_bytes, std::int64_t {64},
+                   "Data buffers 8-aligned");
+  bool aligned {true};
+  for ( const Message& message : found ) {
+    aligned = aligned && message.metadata_bytes % 8 == 0;
+  }
+  results.add_case(aligned, true, "Metadata padded to 8 bytes");
+  results.add_case(read<std::uint32_t>(stream, 0), 0xFFFFFFFFU);
+  results.add_case(read<std::uint64_t>(stream, stream.size() - 8),
+                   std::uint64_t {0xFFFFFFFFU}, "End-of-stream marker");
+
+  bool threw {false};
+  try {
+    table.add_int32("short", {1, 2});
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Column length must match rows");
+
+  return results;
+}
+
+auto test_arrow_dictionary() -> ehanc::test
+{
+  ehanc::test results;
+
+  Arrow_table table {5};
+  table.add_strings("team", {"Ames", "Boone", "Ames", "Cedar", "Boone"});
+  const Arrow_table::Column& column {table.columns().front()};
+  std::vector<std::int32_t> indices(5);
+  std::memcpy(indices.data(), column.values.data(), column.values.size());
+
+  results.add_case(column.dictionary,
+                   std::vector<std::string> {"Ames", "Boone", "Cedar"},
+                   "Distinct names in order of first appearance");
+  results.add_case(indices, std::vector<std::int32_t> {0, 1, 0, 2, 1});
+
+  const std::vector<Message> found {messages(table.encode())};
+  results.add_case(found.size(), std::size_t {3});
+  results.add_case(found[1].header_type, std::uint8_t {2},
+                   "Dictionary batch before the rows");
+  // four offsets, then "AmesBooneCedar" padded to 16
+  results.add_case(found[1].body_bytes, std::int64_t {32});
+
+  return results;
+}
+
+auto test_result_tables() -> ehanc::test
+{
+  ehanc::test results;
+
+  std::vector<League_team> teams(2);
+  teams[0] = {"North", {Wrestler {0, 17, 120, 1500}}};
+  teams[1] = {"South", {}};
+  League_summary summary;
+  summary.seasons           = 10;
+  summary.title_probability = {0.7, 0.3};
+  summary.mean_place        = {1.3, 1.7};
+  summary.mean_wins         = {0.7, 0.3};
+  const Arrow_table league {league_table(teams, summary)};
+  results.add_case(league.columns().size(), std::size_t {5});
+  results.add_case(league.columns()[1].values,
+                   std::vector<unsigned char> {1, 0, 0, 0, 0, 0, 0, 0},
+                   "Roster sizes");
+
+  summary.mean_wins.pop_back();
+  bool threw {false};
+  try {
+    static_cast<void>(league_table(teams, summary));
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Summary must cover every team");
+
+  Qualifier_odds odds;
+  odds.trials            = 1;
+  odds.state_places      = 1;
+  odds.reach_region      = {1.0, 0.5};
+  odds.reach_state       = {1.0, 0.0};
+  odds.place_probability = {1.0, 0.0};
+  const Arrow_table wrestlers {
+      qualifier_table({Wrestler {4, 17, 120, 1600},
+                       Wrestler {9, 16, 120, 1400}},
+                      {"North", "North"}, odds)};
+  results.add_case(wrestlers.rows(), std::size_t {2});
+  results.add_case(wrestlers.columns().front().dictionary.size(),
+                   std::size_t {1}, "One team name stored once");
+
+  odds.reach_state.pop_back();
+  bool short_odds {false};
+  try {
+    static_cast<void>(
+        qualifier_table({Wrestler {4, 17, 120, 1600},
+                         Wrestler {9, 16, 120, 1400}},
+                        {"North", "North"}, odds));
+  } catch ( const std::invalid_argument& ) {
+    short_odds = true;
+  }
+  results.add_case(short_odds, true, "Odds must cover every wrestler");
+
+  return results;
+}
+
+void test_arrow_stream()
+{
+  ehanc::test_section("Arrow stream", [] {
+    ehanc::run_test("Framing", &test_arrow_framing);
+    ehanc::run_test("Dictionary", &test_arrow_dictionary);
+    ehanc::run_test("Result tables", &test_result_tables);
+  });
+}
@@ -0,0 +1,130 @@
+#include "test_async_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace {
+
+auto scratch_file(const char* name) -> std::string
+{
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+/// Append `bytes` of a known pattern in uneven pieces, then read it back
+auto round_trip(const std::string& path, const Async_file_params& params,
+                const std::size_t bytes, Write_backend& backend) -> bool
+{
+  std::vector<unsigned char> data(bytes);
+  for ( std::size_t index {0}; index != bytes; ++index ) {
+    data[index] = static_cast<unsigned char>(index * 31 + index / 4096);
+  }
+
+  {
+    Async_file_writer file {path, params};
+    backend = file.backend();
+    std::size_t offset {0};
+    for ( std::size_t piece {1}; offset != bytes;
+          piece = piece * 3 % 7919 ) {
+      const std::size_t size {std::min(piece, bytes - offset)};
+      file.append(data.data() + offset, size);
+      offset += size;
+    }
+    file.close();
+  }
+
+  const Mapped_file written {path};
+  std::filesystem::remove(path);
+  return written.size() == bytes
+      && std::equal(data.begin(), data.end(), written.data());
+}
+
+} // namespace
+
+auto test_async_file_backends() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::string path {scratch_file("wrestling_async_file.bin")};
+  constexpr std::size_t bytes {(std::size_t {3} << 20) + 12345};
+  Write_backend backend {Write_backend::pwrite};
+
+  results.add_case(round_trip(path, {std::size_t {1} << 20, true, false},
+                              bytes, backend),
+                   true, "Default backend with O_DIRECT");
+  results.add_case(round_trip(path, {std::size_t {1} << 20, false, false},
+                              bytes, backend),
+                   true, "Default backend through the page cache");
+  results.add_case(round_trip(path, {std::size_t {1} << 20, true, true},
+                              bytes, backend),
+                   true, "pwrite fallback");
+  results.add_case(backend == Write_backend::pwrite, true,
+                   "Fallback was used");
+
+  return results;
+}
+
+auto test_async_file_results() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::string path {scratch_file("wrestling_async_results.bin")};
+  constexpr std::uint64_t count {100000};
+
+  {
+    Async_file_writer file {path, {std::size_t {1} << 20, true, false}};
+    Result_writer writer {file.sink(), {1024, std::size_t {1} << 18}};
+    for ( std::uint64_t replay {0}; replay != count; ++replay ) {
+      writer.submit({replay, {static_cast<int>(replay % 97)}});
+    }
+    writer.close();
+    file.close();
+    results.add_case(file.bytes(), count * result_record_bytes);
+  }
+
+  const Mapped_file written {path};
+  const Result_record last {decode_result(
+      written.data() + (count - 1) * result_record_bytes)};
+  results.add_case(written.size(), count * result_record_bytes,
+                   "Trimmed to the records written");
+  results.add_case(last.replay, count - 1, "Last record intact");
+  std::filesystem::remove(path);
+
+  return results;
+}
+
+auto test_async_file_unwinding() -> ehanc::test
+{
+  ehanc::test results;
+
+  // the tail cannot be written, but something else failed first
+  bool caught {false};
+  try {
+    Async_file_writer file {"/dev/full", {4096, false, true}};
+    const unsigned char byte {1};
+    file.append(&byte, 1);
+    throw std::logic_error {"unrelated"};
+  } catch ( const std::logic_error& ) {
+    caught = true;
+  }
+  results.add_case(caught, true, "Earlier error is not replaced");
+
+  return results;
+}
+
+void test_async_file()
+{
+  ehanc::test_section("Async file writer", [] {
+    ehanc::run_test("Backends", &test_async_file_backends);
+    ehanc::run_test("Result records", &test_async_file_results);
+    ehanc::run_test("Failure while unwinding",
+                    &test_async_file_unwinding);
+  });
+}
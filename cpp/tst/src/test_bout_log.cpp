@@ -0,0 +1,260 @@
+#include "test_bout_log.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "random.h"
+
+namespace {
+
+auto scratch_file(const char* name) -> std::string
+{
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+/// A 16-man bracket's worth of bouts for each of `tournaments`
+auto sample_events(const std::uint64_t tournaments)
+    -> std::vector<Bout_event>
+{
+  std::vector<Bout_event> events;
+  Rng rng {67, 0};
+  for ( std::uint64_t tournament {0}; tournament != tournaments;
+        ++tournament ) {
+    const int base {static_cast<int>(rng.below(100'000))};
+    for ( std::uint32_t slot {0}; slot != 15; ++slot ) {
+      Bout_event event;
+      event.tournament   = tournament * 3;
+      event.slot         = slot;
+      event.winner       = base + static_cast<int>(rng.below(16));
+      event.loser        = base - static_cast<int>(rng.below(16));
+      event.winner_score = static_cast<std::int16_t>(rng.below(20));
+      event.loser_score  = static_cast<std::int16_t>(
+          rng.below(static_cast<std::uint32_t>(event.winner_score) + 1));
+      event.duration     = static_cast<std::uint16_t>(rng.below(420));
+      event.result       = static_cast<Result_type>(rng.below(7));
+      events.push_back(event);
+    }
+  }
+  return events;
+}
+
+auto same(const Bout_event& lhs, const Bout_event& rhs) -> bool
+{
+  return lhs.tournament == rhs.tournament && lhs.slot == rhs.slot
+      && lhs.winner == rhs.winner && lhs.loser == rhs.loser
+      && lhs.winner_score == rhs.winner_score
+      && lhs.loser_score == rhs.loser_score
+      && lhs.duration == rhs.duration && lhs.result == rhs.result;
+}
+
+void write_log(const std::string& path,
+               const std::vector<Bout_event>& events)
+{
+  Bout_log_writer writer {path, 1024};
+  for ( const Bout_event& event : events ) {
+    writer.append(event);
+  }
+  writer.close();
+}
+
+} // namespace
+
+auto test_bout_log_round_trip() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::string path {scratch_file("wrestling_round_trip.wbl")};
+  const std::vector<Bout_event> events {sample_events(500)};
+  write_log(path, events);
+
+  const Bout_log log {path};
+  results.add_case(log.events(), std::uint64_t {events.size()});
+  results.add_case(log.blocks() > 1, true, "Several blocks");
+
+  std::size_t index {0};
+  bool matches {true};
+  log.scan([&](const Bout_event& event) {
+    matches = matches && index < events.size()
+           && same(event, events[index]);
+    ++index;
+  });
+  results.add_case(matches && index == events.size(), true,
+                   "Scan returns every event unchanged");
+  results.add_case(log.bytes() < events.size() * 10, true,
+                   "Under ten bytes an event");
+
+  std::filesystem::remove(path);
+  return results;
+}
+
+auto test_bout_log_seek() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::string path {scratch_file("wrestling_seek.wbl")};
+  const std::vector<Bout_event> events {sample_events(500)};
+  write_log(path, events);
+  const Bout_log log {path};
+
+  const std::vector<Bout_event> found {log.tournament(3 * 321)};
+  results.add_case(found.size(), std::size_t {15});
+  results.add_case(same(found.front(), events[321 * 15])
+                       && same(found.back(), events[321 * 15 + 14]),
+                   true, "Whole tournament found");
+  results.add_case(log.tournament(3 * 321 + 1).empty(), true,
+                   "Missing tournament");
+  results.add_case(log.tournament(3 * 500).empty(), true,
+                   "Past the last tournament");
+
+  bool rejected {false};
+  try {
+    Bout_log_writer writer {path};
+    writer.append(events[30]);
+    writer.append(events[0]);
+  } catch ( const std::invalid_argument& ) {
+    rejected = true;
+  }
+  results.add_case(rejected, true, "Tournaments must ascend");
+
+  std::filesystem::remove(path);
+  return results;
+}
+
+auto test_bout_log_corruption() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::string path {scratch_file("wrestling_corrupt.wbl")};
+  write_log(path, sample_events(100));
+
+  {
+    std::fstream file {path,
+                       std::ios::in | std::ios::out | std::ios::binary};
+    file.seekp(100);
+    file.put('\x5a');
+  }
+
+  const Bout_log log {path};
+  bool detected {false};
+  try {
+    static_cast<void>(log.tournament(0));
+  } catch ( const std::runtime_error& ) {
+    detected = true;
+  }
+  results.add_case(detected, true, "Checksum catches a flipped byte");
+  results.add_case(log.tournament(3 * 99).size(), std::size_t {15},
+                   "Other blocks still readable");
+
+  std::filesystem::remove(path);
+  return results;
+}
+
+auto test_bout_log_bounds() -> ehanc::test
+{
+  ehanc::test results;
+
+  using Format = Bout_log_format;
+  const std::string path {scratch_file("wrestling_bounds.wbl")};
+  const auto rejected = [&path] {
+    try {
+      const Bout_log log {path};
+    } catch ( const std::runtime_error& ) {
+      return true;
+    }
+    return false;
+  };
+  const auto rewrite = [&path](const auto& edit) {
+    std::vector<unsigned char> bytes(std::filesystem::file_size(path));
+    std::fstream file {path,
+                       std::ios::in | std::ios::out | std::ios::binary};
+    file.read(reinterpret_cast<char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    Format::Trailer trailer {};
+    unsigned char* const tail {bytes.data() + bytes.size()
+                               - sizeof(trailer)};
+    std::memcpy(&trailer, tail, sizeof(trailer));
+    edit(bytes, trailer);
+    std::memcpy(tail, &trailer, sizeof(trailer));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+  };
+
+  // 2^61 more entries multiply out to the same index size
+  write_log(path, sample_events(100));
+  rewrite([](std::vector<unsigned char>&, Format::Trailer& trailer) {
+    trailer.block_count += std::uint64_t {1} << 61U;
+  });
+  results.add_case(rejected(), true, "Wrapping block count");
+
+  // a block that runs off the end of the address space
+  write_log(path, sample_events(100));
+  rewrite([](std::vector<unsigned char>& bytes,
+             Format::Trailer& trailer) {
+    Format::Block_entry entry {};
+    unsigned char* const first {bytes.data() + trailer.index};
+    std::memcpy(&entry, first, sizeof(entry));
+    entry.offset = ~std::uint64_t {0} - 4;
+    std::memcpy(first, &entry, sizeof(entry));
+    trailer.index_checksum = log_checksum(
+        first, trailer.block_count * sizeof(Format::Block_entry));
+  });
+  results.add_case(rejected(), true, "Wrapping block offset");
+
+  std::filesystem::remove(path);
+  return results;
+}
+
+auto test_bout_log_failure() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Bout_event> events {sample_events(4)};
+
+  // a failed close is reported once, not again by the destructor
+  bool reported {false};
+  {
+    Bout_log_writer writer {"/dev/full"};
+    for ( const Bout_event& event : events ) {
+      writer.append(event);
+    }
+    try {
+      writer.close();
+    } catch ( const std::runtime_error& ) {
+      reported = true;
+    }
+  }
+  results.add_case(reported, true, "Close reports the full disk");
+
+  // the log cannot be finished, but something else failed first
+  bool caught {false};
+  try {
+    Bout_log_writer writer {"/dev/full"};
+    for ( const Bout_event& event : events ) {
+      writer.append(event);
+    }
+    throw std::logic_error {"unrelated"};
+  } catch ( const std::logic_error& ) {
+    caught = true;
+  }
+  results.add_case(caught, true, "Earlier error is not replaced");
+
+  return results;
+}
+
+void test_bout_log()
+{
+  ehanc::test_section("Bout log", [] {
+    ehanc::run_test("Round trip", &test_bout_log_round_trip);
+    ehanc::run_test("Seek to tournament", &test_bout_log_seek);
+    ehanc::run_test("Corruption", &test_bout_log_corruption);
+    ehanc::run_test("Trailer bounds", &test_bout_log_bounds);
+    ehanc::run_test("Write failure", &test_bout_log_failure);
+  });
+}
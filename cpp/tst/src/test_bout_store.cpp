@@ -0,0 +1,196 @@
+#include "test_bout_store.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "test_bouts.hpp"
+#include "varint.h"
+
+namespace {
+
+auto scratch_directory(const char* name) -> std::filesystem::path
+{
+  auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(path);
+  return path;
+}
+
+/// As `make_bout`, with a score so the round trips cover one
+auto scored_bout(const int winner, const int loser, const int date,
+                 const int tournament) -> Bout
+{
+  Bout bout {make_bout(winner, loser, date, tournament)};
+  bout.winner_score = 7;
+  bout.loser_score  = 2;
+  return bout;
+}
+
+auto same_bout(const Bout& lhs, const Bout& rhs) -> bool
+{
+  return lhs.winner == rhs.winner && lhs.loser == rhs.loser
+      && lhs.date == rhs.date && lhs.tournament == rhs.tournament
+      && lhs.winner_score == rhs.winner_score
+      && lhs.loser_score == rhs.loser_score && lhs.result == rhs.result;
+}
+
+} // namespace
+
+auto test_varint_round_trip() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<std::int64_t> values {0, 1, -1, 63, -64, 300,
+                                          -100000, 1LL << 40};
+  std::vector<unsigned char> encoded;
+  for ( const auto value : values ) {
+    put_signed_varint(encoded, value);
+  }
+
+  const unsigned char* cursor {encoded.data()};
+  for ( const auto value : values ) {
+    results.add_case(get_signed_varint(cursor), value);
+  }
+  results.add_case(cursor == encoded.data() + encoded.size(), true,
+                   "Decoder consumed exactly the encoded bytes");
+
+  return results;
+}
+
+auto test_bout_segment_round_trip() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto directory = scratch_directory("wrestling_test_segment");
+  std::filesystem::create_directories(directory);
+  const std::string path {(directory / "segment.wbs").string()};
+
+  std::vector<Bout> bouts;
+  for ( int index {0}; index != 300; ++index ) {
+    bouts.push_back(scored_bout(index % 17, 100 + index % 5,
+                                20000 + (300 - index), index / 10));
+  }
+  bouts[42].result       = Result_type::fall;
+  bouts[42].winner_score = -1;
+
+  Bout_segment::write(path, bouts);
+  const Bout_segment segment {path};
+
+  results.add_case(segment.rows(), std::size_t {300});
+  results.add_case(segment.first_date(), 20001);
+  results.add_case(segment.last_date(), 20300);
+
+  std::vector<Bout> scanned;
+  segment.scan([&](const Bout& bout) { scanned.push_back(bout); });
+  results.add_case(scanned.size(), bouts.size());
+  results.add_case(same_bout(scanned.front(), bouts.back()), true,
+                   "Rows are stored in date order");
+  results.add_case(same_bout(segment.bout(300 - 1 - 42), bouts[42]),
+                   true, "Random access decodes one row");
+
+  const auto postings = segment.postings_of(3);
+  bool sorted {true};
+  for ( std::size_t index {1}; index < postings.size(); ++index ) {
+    sorted = sorted && postings[index - 1].date <= postings[index].date;
+  }
+  results.add_case(postings.size(), std::size_t {18});
+  results.add_case(sorted, true, "Postings are date ordered");
+  results.add_case(segment.postings_of(9999).empty(), true);
+
+  std::filesystem::remove_all(directory);
+  return results;
+}
+
+auto test_bout_store_season_query() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto directory = scratch_directory("wrestling_test_store");
+  const Season season {Season::starting(2021)};
+
+  {
+    Bout_store store {directory.string()};
+    store.append(scored_bout(1, 2, season.first_day - 5, 1));
+    store.append(scored_bout(1, 3, season.first_day + 3, 2));
+    store.flush();
+    store.append(scored_bout(4, 1, season.last_day, 3));
+    store.append(scored_bout(1, 2, season.last_day + 1, 4));
+    store.flush();
+    results.add_case(store.segments().size(), std::size_t {2});
+  }
+
+  const Bout_store reopened {directory.string()};
+  const auto runs = reopened.bouts_of(1, season);
+
+  std::size_t found {0};
+  int losses {0};
+  for ( const auto& run : runs ) {
+    found += run.postings.size();
+    for ( const auto& posting : run.postings ) {
+      losses += posting.won == 0 ? 1 : 0;
+    }
+  }
+
+  results.add_case(reopened.segments().size(), std::size_t {2},
+                   "Segments survive reopening");
+  results.add_case(found, std::size_t {2}, "Only in-season bouts");
+  results.add_case(losses, 1);
+
+  std::filesystem::remove_all(directory);
+  return results;
+}
+
+auto test_bout_store_failed_flush() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto directory = scratch_directory("wrestling_test_failed_flush");
+  Bout_store store {directory.string()};
+  store.append(scored_bout(1, 2, 100, 1));
+  store.append(scored_bout(2, 3, 101, 1));
+
+  // the directory vanishes, so the segment cannot be written
+  std::filesystem::remove_all(directory);
+  bool threw {false};
+  try {
+    store.flush();
+  } catch ( const std::runtime_error& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Failed flush throws");
+  results.add_case(store.pending(), std::size_t {2},
+                   "Failed flush keeps pending bouts");
+
+  std::filesystem::create_directories(directory);
+  store.flush();
+  results.add_case(store.pending(), std::size_t {0});
+  results.add_case(store.segments().size() == 1
+                       && store.segments()[0].rows() == 2,
+                   true, "Retried flush seals them");
+
+  // with an earlier segment gone, numbering still carries on past the
+  // newest, so no sealed segment is overwritten
+  store.append(scored_bout(3, 4, 102, 1));
+  store.flush();
+  std::filesystem::remove(directory / "segment_00000000.wbs");
+  Bout_store reopened {directory.string()};
+  reopened.append(scored_bout(4, 5, 103, 1));
+  reopened.flush();
+  std::size_t rows {0};
+  reopened.scan([&rows](const Bout&) { ++rows; });
+  results.add_case(rows, std::size_t {2}, "Segment names never reused");
+
+  std::filesystem::remove_all(directory);
+  return results;
+}
+
+void test_bout_store()
+{
+  ehanc::test_section("Bout store", [] {
+    ehanc::run_test("Varint round trip", &test_varint_round_trip);
+    ehanc::run_test("Segment round trip", &test_bout_segment_round_trip);
+    ehanc::run_test("Season query", &test_bout_store_season_query);
+    ehanc::run_test("Failed flush", &test_bout_store_failed_flush);
+  });
+}
@@ -0,0 +1,128 @@
+#include "test_bracket_placement.h"
+
+#include <vector>
+
+#include "bracket.h"
+
+namespace {
+
+auto team_entrants(const std::size_t count, const int teams)
+    -> std::vector<Entrant>
+{
+  std::vector<Entrant> entrants;
+  for ( std::size_t index {0}; index != count; ++index ) {
+    Entrant entrant;
+    entrant.slot   = index;
+    entrant.team   = static_cast<int>(index) % teams;
+    entrant.region = static_cast<int>(index) % 3;
+    entrants.push_back(entrant);
+  }
+  return entrants;
+}
+
+} // namespace
+
+auto test_seed_order() -> ehanc::test
+{
+  ehanc::test results;
+
+  results.add_case(seed_order(8),
+                   std::vector<std::size_t> {1, 8, 4, 5, 2, 7, 3, 6});
+  results.add_case(bracket_size(9), std::size_t {16});
+  results.add_case(bracket_rounds(16), std::size_t {4});
+
+  return results;
+}
+
+auto test_placement_seeds_and_byes() -> ehanc::test
+{
+  ehanc::test results;
+
+  auto entrants = team_entrants(6, 6);
+  entrants[3].seed = 1;
+  entrants[5].seed = 2;
+
+  const auto placement = place_bracket(entrants);
+
+  results.add_case(placement.lines.size(), std::size_t {8});
+  results.add_case(placement.lines[0], std::size_t {3}, "Top seed");
+  results.add_case(placement.lines[4], std::size_t {5}, "Second seed");
+  results.add_case(placement.lines[1], Bracket_placement::bye,
+                   "Top seed gets a bye");
+  results.add_case(placement.lines[5], Bracket_placement::bye,
+                   "Second seed gets a bye");
+
+  return results;
+}
+
+auto test_placement_teammate_separation() -> ehanc::test
+{
+  ehanc::test results;
+
+  // 8 teams of 2 in 16 lines; teammates held apart until the final
+  const auto entrants = team_entrants(16, 8);
+  Placement_rules rules;
+  rules.separation_round = 4;
+  rules.seed             = 7;
+
+  const auto placement = place_bracket(entrants, rules);
+
+  bool separated {true};
+  for ( std::size_t lhs {0}; lhs != 16; ++lhs ) {
+    for ( std::size_t rhs {lhs + 1}; rhs != 16; ++rhs ) {
+      const auto& a = entrants[placement.lines[lhs]];
+      const auto& b = entrants[placement.lines[rhs]];
+      if ( a.team == b.team && lhs / 8 == rhs / 8 ) {
+        separated = false;
+      }
+    }
+  }
+
+  results.add_case(placement.quality.feasible(), true);
+  results.add_case(separated, true, "Teammates in opposite halves");
+
+  return results;
+}
+
+auto test_placement_reproducible() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto entrants = team_entrants(27, 5);
+  Placement_rules rules;
+  rules.seed     = 11;
+  rules.restarts = 3;
+
+  rules.threads = 1;
+  const auto serial = place_bracket(entrants, rules);
+  rules.threads = 3;
+  const auto parallel = place_bracket(entrants, rules);
+
+  results.add_case(serial.lines, parallel.lines,
+                   "Same seed, same draw at any thread count");
+  results.add_case(serial.quality.restarts, std::size_t {3});
+
+  // the default number of restarts does not follow the thread count
+  Placement_rules defaults;
+  defaults.seed    = 11;
+  defaults.threads = 1;
+  const auto one = place_bracket(entrants, defaults);
+  defaults.threads = 5;
+  const auto five = place_bracket(entrants, defaults);
+  results.add_case(one.lines, five.lines,
+                   "Default restarts, same draw at any thread count");
+  results.add_case(one.quality.restarts, five.quality.restarts);
+
+  return results;
+}
+
+void test_bracket_placement()
+{
+  ehanc::test_section("Bracket placement", [] {
+    ehanc::run_test("Seed order", &test_seed_order);
+    ehanc::run_test("Seeds and byes", &test_placement_seeds_and_byes);
+    ehanc::run_test("Teammate separation",
+                    &test_placement_teammate_separation);
+    ehanc::run_test("Reproducible", &test_placement_reproducible);
+  });
+}
@@ -0,0 +1,109 @@
+#include "test_bradley_terry.h"
+
+#include <vector>
+
+#include "test_bouts.hpp"
+#include "wrestler.h"
+
+namespace {
+
+auto sample_roster() -> std::vector<Wrestler>
+{
+  return {
+      {1, 16, 120, 0},
+      {2, 16, 120, 0},
+      {3, 16, 120, 0},
+  };
+}
+
+auto sample_bouts() -> std::vector<Bout>
+{
+  return {make_bout(1, 2), make_bout(1, 2), make_bout(2, 1),
+          make_bout(2, 3), make_bout(2, 3), make_bout(1, 3),
+          make_bout(1, 3)};
+}
+
+} // namespace
+
+auto test_win_matrix() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto roster = sample_roster();
+  const Win_matrix matrix {sample_bouts(), Slot_map {roster},
+                           roster.size()};
+
+  results.add_case(matrix.rows(), std::size_t {3});
+  results.add_case(matrix.entries(), std::size_t {6},
+                   "One entry per direction per pair");
+  results.add_case(matrix.wins(0), std::uint32_t {4});
+  results.add_case(matrix.wins(2), std::uint32_t {0});
+  results.add_case(matrix.column(matrix.row_begin(0)), std::size_t {1});
+  results.add_case(matrix.games(matrix.row_begin(0)), std::uint32_t {3},
+                   "Repeated meetings are counted");
+
+  return results;
+}
+
+auto test_bradley_terry_order() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto roster = sample_roster();
+  const Win_matrix matrix {sample_bouts(), Slot_map {roster},
+                           roster.size()};
+
+  Bradley_terry_params params;
+  params.threads = 2;
+  const auto fit = fit_bradley_terry(matrix, params);
+
+  results.add_case(fit.converged, true);
+  results.add_case(fit.strength[0] > fit.strength[1], true);
+  results.add_case(fit.strength[1] > fit.strength[2], true);
+  results.add_case(fit.rating(2) < 1500.0, true,
+                   "Weakest wrestler sits below the prior");
+
+  return results;
+}
+
+auto test_bradley_terry_warm_start() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto roster = sample_roster();
+  const Win_matrix matrix {sample_bouts(), Slot_map {roster},
+                           roster.size()};
+
+  const auto cold = fit_bradley_terry(matrix);
+  const auto warm = fit_bradley_terry(matrix, {}, cold.strength);
+
+  results.add_case(warm.converged, true);
+  results.add_case(warm.iterations < cold.iterations, true,
+                   "Warm start converges faster");
+
+  // a fourth wrestler joins; the others keep their fitted strengths
+  std::vector<Wrestler> grown {sample_roster()};
+  grown.emplace_back(4, 16, 120, 0);
+  std::vector<Bout> bouts {sample_bouts()};
+  bouts.push_back(make_bout(4, 3));
+  bouts.push_back(make_bout(2, 4));
+  const Win_matrix grown_matrix {bouts, Slot_map {grown}, grown.size()};
+  const auto grown_cold = fit_bradley_terry(grown_matrix);
+  const auto grown_warm =
+      fit_bradley_terry(grown_matrix, {}, cold.strength);
+
+  results.add_case(grown_warm.converged, true);
+  results.add_case(grown_warm.iterations < grown_cold.iterations, true,
+                   "Warm start survives a new wrestler");
+
+  return results;
+}
+
+void test_bradley_terry()
+{
+  ehanc::test_section("Bradley-Terry", [] {
+    ehanc::run_test("Win matrix", &test_win_matrix);
+    ehanc::run_test("Strength order", &test_bradley_terry_order);
+    ehanc::run_test("Warm start", &test_bradley_terry_warm_start);
+  });
+}
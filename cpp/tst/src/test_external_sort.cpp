@@ -0,0 +1,154 @@
+#include "test_external_sort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "roster_file.h"
+
+namespace {
+
+auto scratch_file(const char* name) -> std::string
+{
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+auto read_all(const std::string& path) -> std::vector<Roster_record>
+{
+  const Roster_file file {path};
+  std::vector<Roster_record> records;
+  file.read(0, file.size(), records);
+  return records;
+}
+
+} // namespace
+
+auto test_external_partitions() -> ehanc::test
+{
+  ehanc::test results;
+
+  Roster_params roster;
+  roster.teams = 40;
+  roster.seed  = 75;
+  const std::string input {scratch_file("roster_unsorted.bin")};
+  Roster_generator {roster}.write(input, 20'000, Roster_encoding::binary);
+
+  // blocks small enough to need several merge passes
+  const auto classes = Weight_classes::high_school();
+  External_sort_params small;
+  small.memory_bytes = std::size_t {16} << 10;
+  small.block_bytes  = std::size_t {4} << 10;
+  const std::string prefix {
+      (std::filesystem::temp_directory_path() / "partition_").string()};
+  const Partition_report report {
+      partition_roster(input, classes, prefix, small)};
+
+  results.add_case(report.partitions.size(), classes.size() + 1);
+  results.add_case(report.merge_passes > 2, true, "Several merge passes");
+  results.add_case(report.runs > 16, true, "Many runs");
+
+  std::vector<bool> seen(20'000, false);
+  bool sorted {true};
+  bool classed {true};
+  bool counted {true};
+  std::size_t total {0};
+  for ( std::size_t partition {0}; partition != report.partitions.size();
+        ++partition ) {
+    const std::vector<Roster_record> records {
+        read_all(report.partitions[partition].path)};
+    counted = counted
+           && records.size() == report.partitions[partition].wrestlers;
+    total += records.size();
+    for ( std::size_t row {0}; row != records.size(); ++row ) {
+      const Roster_record& record {records[row]};
+      const std::size_t natural {classes.natural_class(record.weight)};
+      classed = classed
+             && (natural == Weight_classes::none ? classes.size()
+                                                 : natural)
+                    == partition;
+      seen[static_cast<std::size_t>(record.id)] = true;
+      if ( row != 0 ) {
+        const Roster_record& last {records[row - 1]};
+        sorted = sorted
+              && (last.ability > record.ability
+                  || (last.ability == record.ability
+                      && last.id < record.id));
+      }
+    }
+  }
+  results.add_case(total, std::size_t {20'000}, "Every wrestler kept");
+  results.add_case(std::find(seen.begin(), seen.end(), false)
+                       == seen.end(),
+                   true, "Every id once");
+  results.add_case(counted, true, "Counts match the files");
+  results.add_case(classed, true, "Partitioned by natural class");
+  results.add_case(sorted, true, "Sorted by ability, then id");
+
+  // one run in memory gives the same partitions
+  const std::vector<Roster_record> lightest {
+      read_all(report.partitions[0].path)};
+  const Partition_report single {
+      partition_roster(input, classes, prefix)};
+  results.add_case(single.runs, std::size_t {1});
+  results.add_case(single.merge_passes, std::size_t {1});
+  const std::vector<Roster_record> again {
+      read_all(single.partitions[0].path)};
+  bool same {lightest.size() == again.size()};
+  for ( std::size_t row {0}; same && row != again.size(); ++row ) {
+    same = lightest[row].id == again[row].id;
+  }
+  results.add_case(same, true, "Independent of memory");
+
+  for ( const Roster_partition& partition : single.partitions ) {
+    std::filesystem::remove(partition.path);
+  }
+  std::filesystem::remove(input);
+
+  return results;
+}
+
+auto test_external_errors() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto classes = Weight_classes::high_school();
+  const std::string path {scratch_file("roster_malformed.bin")};
+  std::ofstream {path} << "not a roster at all";
+  const std::string prefix {
+      (std::filesystem::temp_directory_path() / "malformed_").string()};
+
+  bool threw {false};
+  try {
+    static_cast<void>(partition_roster(path, classes, prefix));
+  } catch ( const std::runtime_error& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Malformed roster throws");
+
+  threw = false;
+  External_sort_params cramped;
+  cramped.memory_bytes = cramped.block_bytes;
+  try {
+    static_cast<void>(partition_roster(path, classes, prefix, cramped));
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Too little memory throws");
+  std::filesystem::remove(path);
+
+  return results;
+}
+
+void test_external_sort()
+{
+  ehanc::test_section("External sort", [] {
+    ehanc::run_test("Partitions", &test_external_partitions);
+    ehanc::run_test("Errors", &test_external_errors);
+  });
+}
@@ -0,0 +1,67 @@
+#include "test_head_to_head.h"
+
+#include <vector>
+
+#include "test_bouts.hpp"
+
+auto test_head_to_head_lookup() -> ehanc::test
+{
+  ehanc::test results;
+
+  Head_to_head_index index;
+  index.record(make_bout(7, 3, 100));
+  index.record(make_bout(7, 3, 90));
+  index.record(make_bout(3, 7, 120));
+
+  const Head_to_head seven {index.lookup(7, 3)};
+  const Head_to_head three {index.lookup(3, 7)};
+
+  results.add_case(seven.wins, 2);
+  results.add_case(seven.losses, 1);
+  results.add_case(three.wins, 1, "Symmetric view");
+  results.add_case(three.losses, 2, "Symmetric view");
+  results.add_case(seven.last_met, 120);
+  results.add_case(index.lookup(7, 4).met(), false);
+  results.add_case(index.pairs(), std::size_t {1});
+
+  return results;
+}
+
+auto test_head_to_head_parallel_build() -> ehanc::test
+{
+  ehanc::test results;
+
+  std::vector<Bout> bouts;
+  for ( int index {0}; index != 12000; ++index ) {
+    bouts.push_back(make_bout(index % 97, 1000 + index % 89, index));
+  }
+
+  const Head_to_head_index parallel {bouts, 4};
+  Head_to_head_index sequential;
+  for ( const auto& bout : bouts ) {
+    sequential.record(bout);
+  }
+
+  bool same {parallel.pairs() == sequential.pairs()};
+  for ( int id {0}; id != 97; ++id ) {
+    for ( int opponent {1000}; opponent != 1089; ++opponent ) {
+      const auto lhs = parallel.lookup(id, opponent);
+      const auto rhs = sequential.lookup(id, opponent);
+      same = same && lhs.wins == rhs.wins && lhs.losses == rhs.losses
+          && lhs.last_met == rhs.last_met;
+    }
+  }
+
+  results.add_case(same, true, "Parallel build matches incremental");
+  results.add_case(parallel.pairs(), std::size_t {97 * 89});
+
+  return results;
+}
+
+void test_head_to_head()
+{
+  ehanc::test_section("Head to head", [] {
+    ehanc::run_test("Lookup", &test_head_to_head_lookup);
+    ehanc::run_test("Parallel build", &test_head_to_head_parallel_build);
+  });
+}
@@ -0,0 +1,151 @@
+#include "test_league.h"
+
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// `count` teams of one wrestler per high school class; team 0 is best
+auto make_league(const std::size_t count) -> std::vector<League_team>
+{
+  const auto classes = Weight_classes::high_school();
+  std::vector<League_team> teams(count);
+  int id {0};
+  for ( std::size_t team {0}; team != count; ++team ) {
+    teams[team].name = "Team " + std::to_string(team);
+    for ( std::size_t weight_class {0}; weight_class != classes.size();
+          ++weight_class ) {
+      const int ability {team == 0 ? 2200
+                                   : 1400 + 7 * static_cast<int>(team)};
+      teams[team].roster.emplace_back(id++, 17,
+                                      classes.limit(weight_class) - 1,
+                                      ability);
+    }
+  }
+  return teams;
+}
+
+} // namespace
+
+auto test_arena() -> ehanc::test
+{
+  ehanc::test results;
+
+  Arena arena {64};
+  const auto small = arena.make_array<std::uint64_t>(4);
+  const auto large = arena.make_array<double>(100);
+  const auto aligned = reinterpret_cast<std::uintptr_t>(large.data());
+
+  results.add_case(small[3], std::uint64_t {0}, "Value-initialized");
+  results.add_case(aligned % alignof(double), std::uintptr_t {0},
+                   "Aligned");
+  results.add_case(arena.capacity() > 64, true, "Grows past capacity");
+
+  arena.reset();
+  const std::size_t merged {arena.capacity()};
+  static_cast<void>(arena.make_array<double>(100));
+  results.add_case(arena.capacity(), merged, "Reuses merged block");
+  results.add_case(arena.used() >= 800, true);
+
+  return results;
+}
+
+auto test_round_robin() -> ehanc::test
+{
+  ehanc::test results;
+
+  for ( const std::size_t teams : {std::size_t {5}, std::size_t {6}} ) {
+    const auto rounds = round_robin(teams);
+    std::set<std::pair<std::size_t, std::size_t>> pairs;
+    bool once_per_round {true};
+    for ( const auto& round : rounds ) {
+      std::set<std::size_t> seen;
+      for ( const auto& [home, away] : round ) {
+        pairs.emplace(std::min(home, away), std::max(home, away));
+        once_per_round = once_per_round && seen.insert(home).second
+                      && seen.insert(away).second;
+      }
+    }
+    results.add_case(pairs.size(), teams * (teams - 1) / 2,
+                     "Every pair meets");
+    results.add_case(once_per_round, true, "One dual per round");
+  }
+  results.add_case(round_robin(6).size(), std::size_t {5});
+
+  return results;
+}
+
+auto test_league_season() -> ehanc::test
+{
+  ehanc::test results;
+
+  const League league {make_league(9), Weight_classes::high_school()};
+  Arena arena;
+  Rng rng {4};
+  const auto table = league.simulate_season(rng, arena);
+
+  int record {0};
+  bool ordered {true};
+  for ( std::size_t place {0}; place != table.size(); ++place ) {
+    record += table[place].record_points();
+    ordered = ordered
+           && (place == 0
+               || table[place - 1].record_points()
+                      >= table[place].record_points());
+  }
+
+  results.add_case(league.duals(), std::size_t {36});
+  results.add_case(record, 2 * 36, "Every dual decided or tied");
+  results.add_case(ordered, true, "Ordered by record");
+  results.add_case(table[0].team, std::size_t {0}, "Best team wins");
+
+  return results;
+}
+
+auto test_league_monte_carlo() -> ehanc::test
+{
+  ehanc::test results;
+
+  const League league {make_league(12), Weight_classes::high_school()};
+  League_params params;
+  params.seasons = 200;
+  params.seed    = 9;
+
+  params.threads = 1;
+  const auto serial = league.simulate(params);
+  params.threads = 3;
+  const auto parallel = league.simulate(params);
+  const Numa_topology topology {{{0, {0}}, {1, {0}}}};
+  params.topology = &topology;
+  const auto pinned = league.simulate(params);
+
+  double total {0.0};
+  for ( const double probability : serial.title_probability ) {
+    total += probability;
+  }
+
+  results.add_case(std::abs(total - 1.0) < 1e-9, true,
+                   "One champion a season");
+  results.add_case(serial.title_probability[0] > 0.99, true);
+  results.add_case(serial.mean_place, parallel.mean_place,
+                   "Same seed, same summary at any thread count");
+  results.add_case(serial.mean_place, pinned.mean_place,
+                   "Node replicas give the same summary");
+  results.add_case(pinned.pin_failures, std::size_t {0});
+
+  return results;
+}
+
+void test_league()
+{
+  ehanc::test_section("League", [] {
+    ehanc::run_test("Arena", &test_arena);
+    ehanc::run_test("Round robin", &test_round_robin);
+    ehanc::run_test("Season", &test_league_season);
+    ehanc::run_test("Monte Carlo", &test_league_monte_carlo);
+  });
+}
@@ -0,0 +1,135 @@
+#include "test_lineup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "random.h"
+
+auto test_weight_class_eligibility() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto classes = Weight_classes::high_school();
+
+  results.add_case(classes.natural_class(106), std::size_t {0});
+  results.add_case(classes.natural_class(107), std::size_t {1});
+  results.add_case(classes.natural_class(108, 2), std::size_t {0},
+                   "Allowance");
+  results.add_case(classes.natural_class(300), Weight_classes::none);
+  results.add_case(classes.eligible(140, 6, 0, 1), true, "Natural class");
+  results.add_case(classes.eligible(140, 7, 0, 1), true, "One class up");
+  results.add_case(classes.eligible(140, 8, 0, 1), false,
+                   "Two classes up");
+  results.add_case(classes.eligible(140, 5, 0, 1), false,
+                   "Over the limit");
+
+  return results;
+}
+
+auto test_assignment_solver() -> ehanc::test
+{
+  ehanc::test results;
+
+  Rng rng {3};
+  Assignment_solver solver;
+  bool optimal {true};
+
+  for ( int trial {0}; trial != 50; ++trial ) {
+    constexpr std::size_t rows {4};
+    constexpr std::size_t columns {6};
+    std::vector<double> cost(rows * columns);
+    for ( double& entry : cost ) {
+      entry = std::floor(rng.uniform() * 20.0) - 5.0;
+    }
+
+    const auto& assigned = solver.solve(rows, columns, cost.data());
+    double solved {0.0};
+    for ( std::size_t row {0}; row != rows; ++row ) {
+      solved += cost[row * columns + assigned[row]];
+    }
+
+    // every injective map of rows into columns
+    std::vector<std::size_t> order(columns);
+    std::iota(order.begin(), order.end(), std::size_t {0});
+    double best {1e18};
+    do {
+      double total {0.0};
+      for ( std::size_t row {0}; row != rows; ++row ) {
+        total += cost[row * columns + order[row]];
+      }
+      best = std::min(best, total);
+    } while ( std::next_permutation(order.begin(), order.end()) );
+
+    optimal = optimal && std::abs(solved - best) < 1e-9;
+  }
+
+  results.add_case(optimal, true, "Matches exhaustive search");
+
+  return results;
+}
+
+auto test_lineup_optimizer() -> ehanc::test
+{
+  ehanc::test results;
+
+  const Weight_classes classes {{120, 132, 145}};
+
+  // the 140-pounder can only wrestle 145, the 118-pounder can move up
+  const std::vector<Wrestler> team {{1, 17, 118, 1700},
+                                    {2, 17, 130, 1500},
+                                    {3, 17, 140, 1550}};
+  const std::vector<Wrestler> opponents {{11, 17, 120, 1500},
+                                         {12, 17, 132, 1900},
+                                         {13, 17, 145, 1500}};
+
+  Lineup_optimizer optimizer {team, opponents, classes};
+
+  const auto full = optimizer.optimize({0, 1, 2});
+  double best {-1e18};
+  for ( std::size_t light {0}; light != 4; ++light ) {
+    for ( std::size_t middle {0}; middle != 4; ++middle ) {
+      for ( std::size_t heavy {0}; heavy != 4; ++heavy ) {
+        const std::vector<std::size_t> lineup {
+            light == 3 ? Lineup::open : light,
+            middle == 3 ? Lineup::open : middle,
+            heavy == 3 ? Lineup::open : heavy};
+        bool valid {true};
+        for ( std::size_t weight_class {0}; weight_class != 3;
+              ++weight_class ) {
+          const std::size_t slot {lineup[weight_class]};
+          valid = valid
+               && (slot == Lineup::open
+                   || (optimizer.eligible(slot, weight_class)
+                       && std::count(lineup.begin(), lineup.end(), slot)
+                              == 1));
+        }
+        if ( valid ) {
+          best = std::max(best, optimizer.margin(lineup, {0, 1, 2}));
+        }
+      }
+    }
+  }
+
+  results.add_case(std::abs(full.expected_margin - best) < 1e-9, true,
+                   "Matches exhaustive search");
+  results.add_case(full.wrestler_at[2], std::size_t {2},
+                   "Heavyweight stays put");
+
+  const auto forfeit = optimizer.optimize({0, Lineup::open, 2});
+  results.add_case(forfeit.wrestler_at[1] != Lineup::open, true,
+                   "Takes the open class");
+
+  return results;
+}
+
+void test_lineup()
+{
+  ehanc::test_section("Lineup", [] {
+    ehanc::run_test("Weight class eligibility",
+                    &test_weight_class_eligibility);
+    ehanc::run_test("Assignment solver", &test_assignment_solver);
+    ehanc::run_test("Lineup optimizer", &test_lineup_optimizer);
+  });
+}
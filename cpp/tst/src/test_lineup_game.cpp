@@ -0,0 +1,136 @@
+#include "test_lineup_game.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+auto close(const double lhs, const double rhs) -> bool
+{
+  return std::abs(lhs - rhs) < 1e-9;
+}
+
+auto matrix(const std::vector<std::vector<double>>& rows)
+    -> Payoff_matrix
+{
+  Payoff_matrix payoff {rows.size(), rows.front().size()};
+  for ( std::size_t row {0}; row != rows.size(); ++row ) {
+    for ( std::size_t column {0}; column != rows[row].size(); ++column ) {
+      payoff(row, column) = rows[row][column];
+    }
+  }
+  return payoff;
+}
+
+} // namespace
+
+auto test_matrix_game_value() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto pennies = solve_matrix_game(matrix({{3, -1}, {-2, 1}}));
+  results.add_case(close(pennies.value, 1.0 / 7.0), true, "2x2 value");
+  results.add_case(close(pennies.row_strategy[0], 3.0 / 7.0), true,
+                   "Row mix");
+  results.add_case(close(pennies.column_strategy[0], 2.0 / 7.0), true,
+                   "Column mix");
+
+  const auto rps =
+      solve_matrix_game(matrix({{0, -1, 1}, {1, 0, -1}, {-1, 1, 0}}));
+  results.add_case(close(rps.value, 0.0), true, "Symmetric game");
+  results.add_case(close(rps.column_strategy[2], 1.0 / 3.0), true,
+                   "Uniform mix");
+
+  const auto saddle = solve_matrix_game(matrix({{4, 2}, {3, 1}}));
+  results.add_case(close(saddle.value, 2.0), true, "Saddle point");
+
+  return results;
+}
+
+auto test_prune_dominated() -> ehanc::test
+{
+  ehanc::test results;
+
+  // row 1 is dominated, then column 0, then row 2; row 3 repeats row 0
+  const auto live = prune_dominated(
+      matrix({{1, 0, 2}, {0, -1, 1}, {3, -2, 0}, {1, 0, 2}}));
+
+  results.add_case(live.rows, std::vector<std::size_t> {0});
+  results.add_case(live.columns, std::vector<std::size_t> {1});
+
+  return results;
+}
+
+auto test_enumerate_lineups() -> ehanc::test
+{
+  ehanc::test results;
+
+  const Weight_classes classes {{120, 132, 145}};
+  const std::vector<Wrestler> roster {{1, 17, 118, 1500},
+                                      {2, 17, 119, 1600},
+                                      {3, 17, 140, 1500}};
+
+  const auto lineups = enumerate_lineups(roster, classes, {}, 100);
+
+  // either light wrestler at 120, the other bumped up to 132
+  results.add_case(lineups.size(), std::size_t {2});
+  results.add_case(lineups.front(), std::vector<std::size_t> {1, 0, 2},
+                   "Strongest first");
+  results.add_case(enumerate_lineups(roster, classes, {}, 1).size(),
+                   std::size_t {1}, "Limit");
+
+  return results;
+}
+
+auto test_lineup_game_equilibrium() -> ehanc::test
+{
+  ehanc::test results;
+
+  const Weight_classes classes {{120, 132, 145, 160}};
+  const std::vector<Wrestler> team {{1, 17, 118, 1700}, {2, 17, 119, 1450},
+                                    {3, 17, 131, 1600}, {4, 17, 140, 1550},
+                                    {5, 17, 150, 1500}};
+  const std::vector<Wrestler> opponents {
+      {11, 17, 117, 1650}, {12, 17, 130, 1500}, {13, 17, 131, 1700},
+      {14, 17, 144, 1500}, {15, 17, 158, 1600}};
+
+  Lineup_game_params params;
+  params.threads = 2;
+  const auto game =
+      solve_lineup_game(team, opponents, classes, {}, params);
+
+  const auto& rows = game.surviving.rows;
+  const auto& columns = game.surviving.columns;
+  bool stable {true};
+  for ( const std::size_t column : columns ) {
+    double payoff {0.0};
+    for ( std::size_t row {0}; row != rows.size(); ++row ) {
+      payoff += game.solution.row_strategy[row]
+              * game.payoff(rows[row], column);
+    }
+    stable = stable && payoff > game.solution.value - 1e-9;
+  }
+  for ( const std::size_t row : rows ) {
+    double payoff {0.0};
+    for ( std::size_t column {0}; column != columns.size(); ++column ) {
+      payoff += game.solution.column_strategy[column]
+              * game.payoff(row, columns[column]);
+    }
+    stable = stable && payoff < game.solution.value + 1e-9;
+  }
+
+  results.add_case(game.our_lineups.size() > 1, true, "Several lineups");
+  results.add_case(stable, true, "Neither coach gains by deviating");
+
+  return results;
+}
+
+void test_lineup_game()
+{
+  ehanc::test_section("Lineup game", [] {
+    ehanc::run_test("Matrix game value", &test_matrix_game_value);
+    ehanc::run_test("Prune dominated", &test_prune_dominated);
+    ehanc::run_test("Enumerate lineups", &test_enumerate_lineups);
+    ehanc::run_test("Equilibrium", &test_lineup_game_equilibrium);
+  });
+}
@@ -0,0 +1,114 @@
+#include "test_numa.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+auto test_parse_cpu_list() -> ehanc::test
+{
+  ehanc::test results;
+
+  results.add_case(parse_cpu_list("0-3,8,10-11\n"),
+                   std::vector<int> {0, 1, 2, 3, 8, 10, 11});
+  results.add_case(parse_cpu_list(""), std::vector<int> {}, "Empty node");
+
+  bool threw {false};
+  try {
+    static_cast<void>(parse_cpu_list("0-"));
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Malformed list");
+
+  return results;
+}
+
+auto test_numa_discover() -> ehanc::test
+{
+  ehanc::test results;
+
+  // a fake sysfs tree: two nodes, one memory-only node
+  const auto root =
+      std::filesystem::temp_directory_path() / "wrestling_numa_test";
+  std::filesystem::remove_all(root);
+  for ( const auto& [name, list] :
+        {std::pair {"node0", "0-1,4-5"}, std::pair {"node1", "2-3,6-7"},
+         std::pair {"node2", ""}} ) {
+    std::filesystem::create_directories(root / name);
+    std::ofstream {root / name / "cpulist"} << list << '\n';
+  }
+
+  const auto topology = Numa_topology::discover(root.string());
+  std::filesystem::remove_all(root);
+
+  results.add_case(topology.node_count(), std::size_t {2});
+  results.add_case(topology.node_of_cpu(6), std::size_t {1});
+  results.add_case(topology.cpu_for_worker(0), 0, "Spread over nodes");
+  results.add_case(topology.cpu_for_worker(1), 2);
+  results.add_case(topology.cpu_for_worker(2), 1);
+
+  const auto missing = Numa_topology::discover("/nonexistent");
+  results.add_case(missing.node_count(), std::size_t {1},
+                   "Falls back to one node");
+
+  return results;
+}
+
+auto test_node_replicated() -> ehanc::test
+{
+  ehanc::test results;
+
+  const Numa_topology topology {{{0, {0}}, {1, {0}}}};
+  const std::vector<int> original {1, 2, 3};
+  const Node_replicated<std::vector<int>> replicas {topology, original};
+
+  results.add_case(replicas.nodes(), std::size_t {2});
+  results.add_case(replicas.copy(1), original);
+  results.add_case(replicas.copy(0).data() != replicas.copy(1).data(),
+                   true, "Separate copies");
+
+  std::vector<int> seen(4, -1);
+  const std::size_t unpinned {pinned_parallel_for(
+      topology, seen.size(),
+      [&](const std::size_t chunk, const std::size_t begin,
+          const std::size_t end) {
+        for ( std::size_t index {begin}; index != end; ++index ) {
+          seen[index] = static_cast<int>(chunk);
+        }
+      },
+      2)};
+  results.add_case(seen, std::vector<int> {0, 0, 1, 1});
+  results.add_case(unpinned, std::size_t {0});
+
+  // a CPU the system cannot have is refused, and the refusal counted
+  const Numa_topology missing {{{0, {0}}, {1, {100'000}}}};
+  const Node_replicated<std::vector<int>> stray {missing, original};
+  results.add_case(stray.pin_failures(), std::size_t {1},
+                   "Refused pin counted");
+  results.add_case(stray.copy(1), original, "Unpinned copy still made");
+  std::vector<int> ran(2, 0);
+  const std::size_t refused {pinned_parallel_for(
+      missing, ran.size(),
+      [&ran](std::size_t, const std::size_t begin, const std::size_t end) {
+        for ( std::size_t index {begin}; index != end; ++index ) {
+          ran[index] = 1;
+        }
+      },
+      2)};
+  results.add_case(refused, std::size_t {1}, "Refused worker counted");
+  results.add_case(ran, std::vector<int> {1, 1},
+                   "Chunks run whether pinned or not");
+
+  return results;
+}
+
+void test_numa()
+{
+  ehanc::test_section("NUMA", [] {
+    ehanc::run_test("Parse CPU list", &test_parse_cpu_list);
+    ehanc::run_test("Discover", &test_numa_discover);
+    ehanc::run_test("Node replicated", &test_node_replicated);
+  });
+}
@@ -0,0 +1,81 @@
+#include "test_page_mapping.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include "arena.h"
+
+auto test_smaps_coverage() -> ehanc::test
+{
+  ehanc::test results;
+
+  std::istringstream smaps {
+      "00400000-00600000 r-xp 00000000 08:01 42 /usr/bin/wrestling\n"
+      "Size:               2048 kB\n"
+      "KernelPageSize:        4 kB\n"
+      "AnonHugePages:         0 kB\n"
+      "7f0000000000-7f0000800000 rw-p 00000000 00:00 0\n"
+      "Size:               8192 kB\n"
+      "KernelPageSize:        4 kB\n"
+      "AnonHugePages:      4096 kB\n"
+      "VmFlags: rd wr mr mw me ac hg\n"
+      "7f0000800000-7f0000c00000 rw-p 00000000 00:00 0\n"
+      "KernelPageSize:     2048 kB\n"};
+
+  const auto coverage =
+      smaps_coverage(smaps, 0x7f0000000000, 0x7f0000c00000);
+
+  results.add_case(coverage.bytes, std::size_t {12} * 1024 * 1024,
+                   "Only mappings in range");
+  results.add_case(coverage.huge_bytes, std::size_t {8} * 1024 * 1024,
+                   "Transparent plus reserved huge pages");
+
+  return results;
+}
+
+auto test_page_mapping_alignment() -> ehanc::test
+{
+  ehanc::test results;
+
+  const Page_mapping small {100, false};
+  results.add_case(small.backing() == Page_backing::normal, true);
+  results.add_case(small.size() >= 100, true);
+
+  const Page_mapping huge {3 * 1024 * 1024, true};
+  std::memset(huge.data(), 1, huge.size());
+  results.add_case(huge.size(), 2 * huge_page_size, "Whole huge pages");
+  results.add_case(reinterpret_cast<std::uintptr_t>(huge.data())
+                       % huge_page_size,
+                   std::uintptr_t {0}, "Aligned to a huge page");
+  results.add_case(huge.coverage().bytes, huge.size(),
+                   "Coverage spans the mapping");
+
+  return results;
+}
+
+auto test_huge_page_arena() -> ehanc::test
+{
+  ehanc::test results;
+
+  Arena arena {1024 * 1024, true};
+  const auto values = arena.make_array<double>(1000);
+  values[999] = 1.0;
+
+  results.add_case(arena.capacity(), huge_page_size,
+                   "Block rounded up to a huge page");
+  results.add_case(arena.huge_page_coverage().bytes, huge_page_size);
+  results.add_case(Arena {}.huge_page_coverage().huge_bytes,
+                   std::size_t {0}, "Ordinary arenas report none");
+
+  return results;
+}
+
+void test_page_mapping()
+{
+  ehanc::test_section("Page mapping", [] {
+    ehanc::run_test("Smaps coverage", &test_smaps_coverage);
+    ehanc::run_test("Alignment", &test_page_mapping_alignment);
+    ehanc::run_test("Huge page arena", &test_huge_page_arena);
+  });
+}
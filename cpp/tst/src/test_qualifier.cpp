@@ -0,0 +1,107 @@
+#include "test_qualifier.h"
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "bracket.h"
+#include "tournament.h"
+
+namespace {
+
+/// Abilities fall with the slot, 50 points apart
+auto ladder(const std::size_t count) -> std::vector<Wrestler>
+{
+  std::vector<Wrestler> roster;
+  for ( std::size_t slot {0}; slot != count; ++slot ) {
+    const int rank {static_cast<int>(slot)};
+    roster.emplace_back(rank, 17, 150, 2000 - 50 * rank);
+  }
+  return roster;
+}
+
+} // namespace
+
+auto test_simulate_bracket() -> ehanc::test
+{
+  ehanc::test results;
+
+  // the stronger wrestler always wins
+  Probability_table certain {8};
+  for ( std::size_t lhs {0}; lhs != 8; ++lhs ) {
+    for ( std::size_t rhs {lhs + 1}; rhs != 8; ++rhs ) {
+      certain.set(lhs, rhs, 1.0);
+    }
+  }
+  const std::vector<int> strength {8, 7, 6, 5, 4, 3, 2, 1};
+
+  std::vector<std::size_t> everyone(8);
+  std::iota(everyone.begin(), everyone.end(), std::size_t {0});
+  Rng rng {1};
+  results.add_case(
+      simulate_bracket(seeded_lines(everyone, strength), certain, rng, 8),
+      everyone, "Chalk places everyone by seed");
+
+  const std::vector<std::size_t> six {0, 1, 2, 3, 4, 5};
+  const auto lines = seeded_lines(six, strength);
+  results.add_case(lines[1], bye_line, "Top seed draws a bye");
+  results.add_case(simulate_bracket(lines, certain, rng, 4),
+                   std::vector<std::size_t> {0, 1, 2, 3},
+                   "Stops after the places asked for");
+
+  return results;
+}
+
+auto test_qualifier_odds() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto roster = ladder(24);
+  Qualifier_format format;
+  format.regions = 2;
+  for ( std::size_t district {0}; district != 4; ++district ) {
+    Qualifier_district entry;
+    for ( std::size_t slot {district}; slot < 24; slot += 4 ) {
+      entry.entrants.push_back(slot);
+    }
+    entry.region = district % 2;
+    format.districts.push_back(entry);
+  }
+
+  Qualifier_params params;
+  params.trials  = 400;
+  params.batch   = 150;
+  params.seed    = 3;
+  params.threads = 1;
+  const auto serial = simulate_qualifiers(roster, format, params);
+  params.threads = 4;
+  params.batch   = 37;
+  const auto parallel = simulate_qualifiers(roster, format, params);
+
+  const double qualifiers {std::accumulate(serial.reach_state.begin(),
+                                           serial.reach_state.end(), 0.0)};
+  double champions {0.0};
+  for ( std::size_t slot {0}; slot != roster.size(); ++slot ) {
+    champions += serial.place(slot, 1);
+  }
+
+  results.add_case(std::abs(qualifiers - 8.0) < 1e-9, true,
+                   "Four from each region reach state");
+  results.add_case(std::abs(champions - 1.0) < 1e-9, true,
+                   "One state champion");
+  results.add_case(serial.reach_state[0] > 0.9, true);
+  results.add_case(serial.reach_state[0] > serial.reach_state[20], true,
+                   "Stronger wrestlers qualify more often");
+  results.add_case(serial.place_probability, parallel.place_probability,
+                   "Independent of threads and batching");
+
+  return results;
+}
+
+void test_qualifier()
+{
+  ehanc::test_section("Qualifier", [] {
+    ehanc::run_test("Simulate bracket", &test_simulate_bracket);
+    ehanc::run_test("Qualifier odds", &test_qualifier_odds);
+  });
+}
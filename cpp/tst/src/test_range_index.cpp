@@ -0,0 +1,119 @@
+#include "test_range_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "random.h"
+
+namespace {
+
+auto random_roster(const std::size_t size) -> std::vector<Wrestler>
+{
+  std::vector<Wrestler> roster;
+  Rng rng {73, 0};
+  for ( std::size_t row {0}; row != size; ++row ) {
+    roster.emplace_back(static_cast<int>(row),
+                        13 + static_cast<int>(rng.below(7)),
+                        100 + static_cast<int>(rng.below(60)), 1500);
+  }
+  return roster;
+}
+
+auto matches(const Wrestler& wrestler, const Range_query& query) -> bool
+{
+  return wrestler.weight() >= query.min_weight
+      && wrestler.weight() <= query.max_weight
+      && wrestler.age() >= query.min_age
+      && wrestler.age() <= query.max_age;
+}
+
+} // namespace
+
+auto test_range_query() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> roster {random_roster(5000)};
+  const Range_index index {roster};
+  Rng rng {74, 0};
+  bool agrees {true};
+  bool maximal {true};
+  for ( int trial {0}; trial != 200; ++trial ) {
+    const int weight {95 + static_cast<int>(rng.below(70))};
+    const int age {12 + static_cast<int>(rng.below(9))};
+    const Range_query query {weight,
+                             weight + static_cast<int>(rng.below(12)), age,
+                             age + static_cast<int>(rng.below(4))};
+    const std::vector<Index_slice> slices {index.query(query)};
+
+    std::vector<std::uint32_t> found;
+    for ( std::size_t slice {0}; slice != slices.size(); ++slice ) {
+      const auto rows = index.rows(slices[slice]);
+      found.insert(found.end(), rows.begin(), rows.end());
+      maximal = maximal
+             && (slice == 0
+                 || slices[slice - 1].end < slices[slice].begin);
+    }
+    std::sort(found.begin(), found.end());
+    std::vector<std::uint32_t> expected;
+    for ( std::size_t row {0}; row != roster.size(); ++row ) {
+      if ( matches(roster[row], query) ) {
+        expected.push_back(static_cast<std::uint32_t>(row));
+      }
+    }
+    agrees = agrees && found == expected;
+  }
+  results.add_case(agrees, true, "Same rows as a full scan");
+  results.add_case(maximal, true, "Touching slices are merged");
+
+  // one slice per weight, the ages being contiguous within each
+  const std::vector<Index_slice> slices {index.query({120, 126, 14, 15})};
+  results.add_case(slices.size(), std::size_t {7});
+  results.add_case(index.query({126, 120, 14, 15}).empty(), true,
+                   "Empty range");
+
+  const std::vector<std::int32_t> weights {120, 121};
+  const std::vector<std::int32_t> ages {15};
+  bool threw {false};
+  try {
+    const Range_index mismatched {{weights.data(), weights.size()},
+                                  {ages.data(), ages.size()}};
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Columns must be the same length");
+
+  return results;
+}
+
+auto test_range_bitmap() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> roster {random_roster(1000)};
+  const Range_index index {roster};
+  const Range_query query {110, 130, 15, 17};
+  const std::vector<std::uint64_t> bits {index.bitmap(query)};
+
+  bool agrees {true};
+  std::size_t count {0};
+  for ( std::size_t row {0}; row != roster.size(); ++row ) {
+    const bool set {(bits[row / 64] >> (row % 64) & 1U) != 0};
+    agrees = agrees && set == matches(roster[row], query);
+    count += set ? 1 : 0;
+  }
+  results.add_case(agrees, true, "Bitmap over original rows");
+  results.add_case(count, slice_rows(index.query(query)));
+
+  return results;
+}
+
+void test_range_index()
+{
+  ehanc::test_section("Range index", [] {
+    ehanc::run_test("Query", &test_range_query);
+    ehanc::run_test("Bitmap", &test_range_bitmap);
+  });
+}
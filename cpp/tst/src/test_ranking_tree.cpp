@@ -0,0 +1,148 @@
+#include "test_ranking_tree.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "random.h"
+
+namespace {
+
+auto same(const std::vector<Ranked>& lhs, const std::vector<Ranked>& rhs)
+    -> bool
+{
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                    [](const Ranked& left, const Ranked& right) {
+                      return left.ability == right.ability
+                          && left.id == right.id;
+                    });
+}
+
+} // namespace
+
+auto test_ranking_tree_order() -> ehanc::test
+{
+  ehanc::test results;
+
+  // a sorted vector is the reference, through enough inserts and erases
+  // to split, merge and refill nodes at every level
+  Ranking_tree tree;
+  std::vector<Ranked> expected;
+  Rng rng {74, 0};
+  bool agrees {true};
+  bool refused {true};
+  for ( int step {0}; step != 20000; ++step ) {
+    const Ranked key {static_cast<int>(rng.below(400)),
+                      static_cast<int>(rng.below(40))};
+    const auto at = std::lower_bound(expected.begin(), expected.end(), key,
+                                     ranks_before);
+    const bool present {at != expected.end() && at->ability == key.ability
+                        && at->id == key.id};
+    const bool grow {step < 12000 ? rng.below(4) != 0
+                                  : rng.below(4) == 0};
+    if ( grow ) {
+      refused = refused && tree.insert(key) != present;
+      if ( !present ) {
+        expected.insert(at, key);
+      }
+    } else {
+      refused = refused && tree.erase(key) == present;
+      if ( present ) {
+        expected.erase(at);
+      }
+    }
+    agrees = agrees && tree.size() == expected.size()
+          && tree.contains(key) == grow
+          && tree.position(key)
+                 == static_cast<std::size_t>(
+                     std::lower_bound(expected.begin(), expected.end(),
+                                      key, ranks_before)
+                     - expected.begin());
+    if ( !expected.empty() ) {
+      const std::size_t position {rng.below(
+          static_cast<std::uint32_t>(expected.size()))};
+      const Ranked selected {tree.select(position)};
+      agrees = agrees && selected.ability == expected[position].ability
+            && selected.id == expected[position].id;
+    }
+  }
+  results.add_case(agrees, true, "Position, select and size");
+  results.add_case(refused, true, "Duplicate insert and absent erase");
+
+  std::vector<Ranked> all;
+  tree.read(0, expected.size() + 10, all);
+  results.add_case(same(all, expected), true, "Leaves read in order");
+  std::vector<Ranked> middle;
+  tree.read(5, 100, middle);
+  results.add_case(
+      same(middle, {expected.begin() + 5, expected.begin() + 105}), true,
+      "Read from a position");
+  tree.read(expected.size(), 10, middle);
+  results.add_case(middle.empty(), true, "Read past the end");
+
+  for ( const Ranked& key : expected ) {
+    static_cast<void>(tree.erase(key));
+  }
+  results.add_case(tree.size(), std::size_t {0}, "Emptied");
+  results.add_case(tree.insert({1, 1}), true, "Reused after emptying");
+
+  return results;
+}
+
+auto test_class_rankings() -> ehanc::test
+{
+  ehanc::test results;
+
+  Class_rankings rankings {std::size_t {2}};
+  rankings.add({1, 16, 120, 1500}, 0);
+  rankings.add({2, 16, 120, 1600}, 0);
+  rankings.add({3, 16, 120, 1500}, 0);
+  rankings.add({4, 17, 150, 1400}, 1);
+
+  results.add_case(rankings.rank(2), std::size_t {1});
+  results.add_case(rankings.rank(1), std::size_t {2}, "Lower id first");
+  results.add_case(rankings.rank(4), std::size_t {1}, "Ranked by class");
+
+  rankings.update(3, 1700);
+  results.add_case(rankings.rank(3), std::size_t {1}, "Update moves up");
+  results.add_case(rankings.at(0, 3).id, 1);
+  const std::vector<Ranked> top {rankings.top(0, 2)};
+  results.add_case(top.size(), std::size_t {2});
+  results.add_case(top[1].id, 2);
+
+  rankings.remove(2);
+  results.add_case(rankings.size(0), std::size_t {2}, "Removed");
+
+  bool threw {false};
+  try {
+    rankings.add({1, 16, 120, 1500}, 1);
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Duplicate id throws");
+  threw = false;
+  try {
+    rankings.update(2, 1500);
+  } catch ( const std::out_of_range& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Unknown id throws");
+  threw = false;
+  try {
+    static_cast<void>(rankings.at(1, 2));
+  } catch ( const std::out_of_range& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Rank past the class throws");
+
+  return results;
+}
+
+void test_ranking_tree()
+{
+  ehanc::test_section("Ranking tree", [] {
+    ehanc::run_test("Order", &test_ranking_tree_order);
+    ehanc::run_test("Class rankings", &test_class_rankings);
+  });
+}
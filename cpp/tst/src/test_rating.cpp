@@ -0,0 +1,114 @@
+#include "test_rating.h"
+
+#include <cmath>
+#include <vector>
+
+auto test_elo_update() -> ehanc::test
+{
+  ehanc::test results;
+
+  Elo_engine engine {2};
+  engine.update(0, 1);
+
+  results.add_case(std::abs(engine.rating(0) - 1516.0) < 1e-9, true,
+                   "Winner gains half the K factor");
+  results.add_case(std::abs(engine.rating(1) - 1484.0) < 1e-9, true,
+                   "Loser drops half the K factor");
+
+  engine.update(0, 1);
+  results.add_case(engine.rating(0) < 1516.0 + 16.0, true,
+                   "Expected wins are worth less");
+
+  return results;
+}
+
+auto test_elo_process() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> roster {
+      {10, 16, 120, 0},
+      {20, 17, 120, 0},
+  };
+  const Slot_map slots {roster};
+
+  std::vector<Bout> bouts(3);
+  bouts[0].winner = 10;
+  bouts[0].loser  = 20;
+  bouts[1].winner = 20;
+  bouts[1].loser  = 99;
+  bouts[2].winner = 10;
+  bouts[2].loser  = 20;
+
+  Elo_engine engine {roster.size()};
+  engine.process(bouts, slots);
+
+  Elo_engine expected {roster.size()};
+  expected.update(0, 1);
+  expected.update(0, 1);
+
+  results.add_case(std::abs(engine.rating(0) - expected.rating(0)) < 1e-9,
+                   true, "Unknown ids are skipped");
+  results.add_case(
+      std::abs(engine.rating(0) + engine.rating(1) - 3000.0) < 1e-9, true,
+      "Elo is zero-sum");
+
+  return results;
+}
+
+auto test_glicko2_update() -> ehanc::test
+{
+  ehanc::test results;
+
+  Glicko2_engine engine {2};
+  engine.update(0, 1);
+
+  results.add_case(engine.rating(0) > 1500.0, true, "Winner gains");
+  results.add_case(engine.rating(1) < 1500.0, true, "Loser drops");
+  results.add_case(engine.deviation(0) < 350.0, true,
+                   "Deviation shrinks after a bout");
+  results.add_case(std::abs(engine.rating(0) - 1500.0
+                            - (1500.0 - engine.rating(1)))
+                       < 1e-9,
+                   true, "Symmetric for identical priors");
+
+  // reference values for one win between two unrated players
+  results.add_case(std::abs(engine.rating(0) - 1662.31) < 0.01, true,
+                   "Winner's rating");
+  results.add_case(std::abs(engine.deviation(0) - 290.32) < 0.01, true,
+                   "Winner's deviation");
+  results.add_case(std::abs(engine.volatility(0) - 0.06) < 1e-4, true,
+                   "Volatility barely moves after one bout");
+
+  return results;
+}
+
+auto test_apply_ratings() -> ehanc::test
+{
+  ehanc::test results;
+
+  std::vector<Wrestler> roster {
+      {1, 16, 120, 0},
+      {2, 17, 126, 0},
+  };
+
+  Elo_engine engine {roster.size()};
+  engine.update(1, 0);
+  apply_ratings(roster, engine);
+
+  results.add_case(roster[0].ability(), 1484);
+  results.add_case(roster[1].ability(), 1516);
+  results.add_case(roster[1].weight(), 126, "Other fields untouched");
+
+  return results;
+}
+
+void test_rating()
+{
+  ehanc::test_section("Rating", [] {
+    ehanc::run_test("Elo update", &test_elo_update);
+    ehanc::run_test("Elo bout log", &test_elo_process);
+    ehanc::run_test("Glicko-2 update", &test_glicko2_update);
+    ehanc::run_test("Apply ratings", &test_apply_ratings);
+  });
+}
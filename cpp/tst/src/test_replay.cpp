@@ -0,0 +1,179 @@
+#include "test_replay.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+auto sample_field() -> std::vector<Wrestler>
+{
+  std::vector<Wrestler> field;
+  for ( int index {0}; index != 16; ++index ) {
+    field.emplace_back(100 + index, 17, 152, 1000 + 40 * index);
+  }
+  return field;
+}
+
+auto same_bouts(const std::vector<Bout_event>& lhs,
+                const std::vector<Bout_event>& rhs,
+                const std::size_t first, const std::size_t last) -> bool
+{
+  for ( std::size_t bout {first}; bout != last; ++bout ) {
+    if ( lhs[bout].winner != rhs[bout].winner
+         || lhs[bout].loser != rhs[bout].loser
+         || lhs[bout].winner_score != rhs[bout].winner_score
+         || lhs[bout].duration != rhs[bout].duration ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+auto test_replay_determinism() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> field {sample_field()};
+  const Replay_engine engine {field};
+
+  const Replay first {engine.replay(5, 17)};
+  const Replay again {engine.replay(engine.key(5, 17))};
+  results.add_case(first.bouts.size() == again.bouts.size()
+                       && same_bouts(first.bouts, again.bouts, 0,
+                                     first.bouts.size()),
+                   true, "Same key, same bouts");
+  results.add_case(first.placings, again.placings, "Same placings");
+  results.add_case(first.placings.size(), std::size_t {8});
+
+  // the final closes the championship bracket's 15 bouts
+  results.add_case(first.bouts[14].winner,
+                   field[first.placings.front()].id(), "Final decides");
+  results.add_case(first.bouts[14].loser,
+                   field[first.placings[1]].id(), "Runner-up");
+  results.add_case(first.bouts.front().tournament, std::uint64_t {17});
+
+  bool rejected {false};
+  try {
+    const Replay_engine other_rules {field, {4, 360, 8, 15}};
+    static_cast<void>(other_rules.replay(first.key));
+  } catch ( const std::invalid_argument& ) {
+    rejected = true;
+  }
+  results.add_case(rejected, true, "Key from other rules rejected");
+
+  return results;
+}
+
+auto test_replay_find_champion() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> field {sample_field()};
+  const Replay_engine engine {field};
+
+  results.add_case(field[engine.seeded(1)].id(), 115, "Top seed");
+
+  const std::size_t twelfth {engine.seeded(12)};
+  const std::uint64_t found {engine.find_champion(3, twelfth, 0, 100000)};
+  results.add_case(found != Replay_engine::not_found, true,
+                   "Found an upset");
+  results.add_case(engine.replay(3, found).placings.front(), twelfth,
+                   "Replaying it shows the upset");
+  results.add_case(found == 0
+                       || engine.find_champion(3, twelfth, 0, found)
+                              == Replay_engine::not_found,
+                   true, "Earliest such replay");
+
+  return results;
+}
+
+auto test_replay_injection() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> field {sample_field()};
+  const Replay_engine plain {field};
+  const Replay original {plain.replay(9, 4)};
+
+  Divergence_log log;
+  log.inject({9, 4, 0, original.bouts[0].loser, Result_type::forfeit});
+  log.inject({9, 5, 3, 0, Result_type::forfeit});
+  results.add_case(log.of(9, 4).size(), std::size_t {1});
+  results.add_case(log.of(8, 4).size(), std::size_t {0},
+                   "Injections belong to one seed");
+
+  const Replay_engine engine {field, {}, &log};
+  const Replay changed {engine.replay(9, 4)};
+  results.add_case(changed.bouts[0].winner, original.bouts[0].loser,
+                   "Injected winner");
+  results.add_case(changed.bouts[0].result == Result_type::forfeit, true);
+  results.add_case(changed.bouts[0].duration, std::uint16_t {0});
+  results.add_case(same_bouts(changed.bouts, original.bouts, 1, 8), true,
+                   "Unaffected bouts unchanged");
+
+  results.add_case(same_bouts(engine.replay(9, 6).bouts,
+                              plain.replay(9, 6).bouts, 0, 15),
+                   true, "Other replays unchanged");
+  results.add_case(same_bouts(engine.replay(8, 4).bouts,
+                              plain.replay(8, 4).bouts, 0, 15),
+                   true, "Other seeds unchanged");
+
+  bool stale {false};
+  try {
+    static_cast<void>(engine.replay(original.key));
+  } catch ( const std::invalid_argument& ) {
+    stale = true;
+  }
+  results.add_case(stale, true, "Key without the injections rejected");
+  results.add_case(engine.replay(changed.key).bouts[0].winner,
+                   original.bouts[0].loser, "Key with them accepted");
+
+  // a key stays good while its own replay is left alone
+  const Replay_key untouched {engine.key(9, 6)};
+  log.inject({9, 7, 0, original.bouts[0].loser, Result_type::forfeit});
+  results.add_case(same_bouts(engine.replay(untouched).bouts,
+                              plain.replay(9, 6).bouts, 0, 15),
+                   true, "Unrelated injection keeps other keys");
+
+  return results;
+}
+
+auto test_replay_unreached_injection() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> field {sample_field()};
+  const auto rejects = [&](const Replay_rules& rules,
+                           const std::uint32_t slot) {
+    const Replay plain {Replay_engine {field, rules}.replay(1, 0)};
+    Divergence_log log;
+    log.inject({1, 0, slot, plain.bouts.front().winner});
+    try {
+      static_cast<void>(Replay_engine {field, rules, &log}.replay(1, 0));
+    } catch ( const std::runtime_error& ) {
+      return true;
+    }
+    return false;
+  };
+
+  results.add_case(rejects({}, 0), false, "Played bout accepted");
+  results.add_case(rejects({}, 500), true, "Slot past the last bout");
+  // two places need no consolation bouts after the final
+  results.add_case(rejects({2, 360, 8, 15}, 15), true,
+                   "Consolation bout that is never wrestled");
+
+  return results;
+}
+
+void test_replay()
+{
+  ehanc::test_section("Replay", [] {
+    ehanc::run_test("Determinism", &test_replay_determinism);
+    ehanc::run_test("Find champion", &test_replay_find_champion);
+    ehanc::run_test("Injected results", &test_replay_injection);
+    ehanc::run_test("Unreached injection",
+                    &test_replay_unreached_injection);
+  });
+}
@@ -0,0 +1,202 @@
+#include "test_result_writer.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Sink that keeps every byte it is given
+auto collecting_sink(std::vector<unsigned char>& bytes) -> Byte_sink
+{
+  return [&bytes](const unsigned char* data, const std::size_t size) {
+    bytes.insert(bytes.end(), data, data + size);
+  };
+}
+
+} // namespace
+
+auto test_result_encoding() -> ehanc::test
+{
+  ehanc::test results;
+
+  Result_record record;
+  record.replay = 0x0123456789abcdefULL;
+  record.bout   = {-7, 42, 19000, 3, 12, -1, Result_type::tech_fall};
+
+  std::vector<unsigned char> bytes(result_record_bytes, 0xff);
+  encode_result(record, bytes.data());
+  const Result_record decoded {decode_result(bytes.data())};
+
+  results.add_case(decoded.replay, record.replay, "Replay");
+  results.add_case(decoded.bout.winner, -7, "Negative id");
+  results.add_case(decoded.bout.loser_score, std::int16_t {-1});
+  results.add_case(decoded.bout.result == Result_type::tech_fall, true);
+  results.add_case(bytes.back(), static_cast<unsigned char>(0),
+                   "Padding is zeroed");
+
+  return results;
+}
+
+auto test_result_producers() -> ehanc::test
+{
+  ehanc::test results;
+
+  constexpr std::size_t producers {4};
+  constexpr int per_producer {20000};
+  std::vector<unsigned char> bytes;
+
+  Result_writer writer {collecting_sink(bytes), {256, 4096}};
+  std::vector<std::thread> threads;
+  for ( std::size_t producer {0}; producer != producers; ++producer ) {
+    threads.emplace_back([&writer, producer] {
+      for ( int sequence {0}; sequence != per_producer; ++sequence ) {
+        writer.submit({producer, {0, 1, sequence, 0, 0, 0}});
+      }
+    });
+  }
+  for ( std::thread& thread : threads ) {
+    thread.join();
+  }
+  writer.close();
+
+  const Result_writer_stats stats {writer.stats()};
+  const std::uint64_t total {producers * per_producer};
+  results.add_case(stats.submitted, total, "Every record accepted");
+  results.add_case(stats.written, total, "Every record written");
+  results.add_case(bytes.size(), total * result_record_bytes);
+  results.add_case(stats.writes < total / 8, true, "Writes are batched");
+
+  std::vector<int> next(producers, 0);
+  bool ordered {true};
+  for ( std::size_t offset {0}; offset < bytes.size();
+        offset += result_record_bytes ) {
+    const Result_record record {decode_result(bytes.data() + offset)};
+    ordered = ordered && record.bout.date == next[record.replay]++;
+  }
+  results.add_case(ordered, true, "Each producer's records in order");
+
+  return results;
+}
+
+auto test_result_backpressure() -> ehanc::test
+{
+  ehanc::test results;
+
+  std::atomic<bool> released {false};
+  std::vector<unsigned char> bytes;
+  const Byte_sink slow_sink {[&](const unsigned char* data,
+                                 const std::size_t size) {
+    while ( !released.load() ) {
+      std::this_thread::yield();
+    }
+    bytes.insert(bytes.end(), data, data + size);
+  }};
+
+  // the writer can hold one batch of two records plus four in the ring
+  Result_writer writer {slow_sink, {4, 2 * result_record_bytes}};
+  int accepted {0};
+  while ( accepted != 100 && writer.try_submit({0, {accepted}}) ) {
+    ++accepted;
+  }
+  results.add_case(accepted <= 6, true, "Full ring refuses records");
+  results.add_case(writer.stats().rejected, std::uint64_t {1});
+
+  released.store(true);
+  for ( int next {accepted}; next != 100; ++next ) {
+    writer.submit({0, {next}});
+  }
+  writer.close();
+
+  results.add_case(writer.stats().written, std::uint64_t {100},
+                   "Nothing dropped");
+  results.add_case(decode_result(bytes.data() + 99 * result_record_bytes)
+                       .bout.winner,
+                   99);
+
+  return results;
+}
+
+auto test_result_sink_failure() -> ehanc::test
+{
+  ehanc::test results;
+
+  Result_writer writer {
+      [](const unsigned char*, std::size_t) {
+        throw std::runtime_error {"disk full"};
+      },
+      {16, result_record_bytes}};
+
+  bool refused {false};
+  try {
+    for ( int record {0}; record != 1000; ++record ) {
+      writer.submit({0, {record}});
+    }
+  } catch ( const std::runtime_error& ) {
+    refused = true;
+  }
+  results.add_case(refused, true, "Submit throws once the sink fails");
+
+  bool reported {false};
+  try {
+    writer.close();
+  } catch ( const std::runtime_error& ) {
+    reported = true;
+  }
+  results.add_case(reported, true, "Close rethrows the sink's error");
+  results.add_case(writer.stats().written, std::uint64_t {0});
+
+  return results;
+}
+
+auto test_result_failure_unwinding() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto failing = [](const unsigned char*, std::size_t) {
+    throw std::runtime_error {"disk full"};
+  };
+
+  // the submit's error propagates out through the writer's destructor
+  bool propagated {false};
+  try {
+    Result_writer writer {failing, {16, result_record_bytes}};
+    for ( int record {0}; record != 1000; ++record ) {
+      writer.submit({0, {record}});
+    }
+  } catch ( const std::runtime_error& ) {
+    propagated = true;
+  }
+  results.add_case(propagated, true, "Submit error survives unwinding");
+
+  // a failure already reported by submit is not raised again
+  bool handled {false};
+  {
+    Result_writer writer {failing, {16, result_record_bytes}};
+    try {
+      for ( int record {0};; ++record ) {
+        if ( !writer.try_submit({0, {record}}) ) {
+          std::this_thread::yield();
+        }
+      }
+    } catch ( const std::runtime_error& ) {
+      handled = true;
+    }
+  }
+  results.add_case(handled, true, "Reported failure not raised again");
+
+  return results;
+}
+
+void test_result_writer()
+{
+  ehanc::test_section("Result writer", [] {
+    ehanc::run_test("Record encoding", &test_result_encoding);
+    ehanc::run_test("Many producers", &test_result_producers);
+    ehanc::run_test("Backpressure", &test_result_backpressure);
+    ehanc::run_test("Sink failure", &test_result_sink_failure);
+    ehanc::run_test("Failure while unwinding",
+                    &test_result_failure_unwinding);
+  });
+}
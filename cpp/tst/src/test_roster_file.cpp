@@ -0,0 +1,171 @@
+#include "test_roster_file.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto scratch_file(const char* name) -> std::string
+{
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+auto same(const Roster_record& lhs, const Roster_record& rhs) -> bool
+{
+  return lhs.id == rhs.id && lhs.team == rhs.team && lhs.age == rhs.age
+      && lhs.weight == rhs.weight && lhs.ability == rhs.ability;
+}
+
+} // namespace
+
+auto test_roster_generator() -> ehanc::test
+{
+  ehanc::test results;
+
+  Roster_params params;
+  params.teams = 50;
+  params.seed  = 71;
+  const Roster_generator generator {params};
+  std::vector<Roster_record> whole;
+  std::vector<Roster_record> slice;
+  generator.generate(0, 20'000, whole);
+  generator.generate(12'345, 10, slice);
+
+  bool matches {true};
+  for ( std::size_t index {0}; index != slice.size(); ++index ) {
+    matches = matches && same(slice[index], whole[12'345 + index]);
+  }
+  results.add_case(matches, true, "Slices match the whole roster");
+
+  bool in_range {true};
+  std::vector<double> weight(5, 0.0);
+  std::vector<double> ability(5, 0.0);
+  std::vector<double> count(5, 0.0);
+  for ( const Roster_record& record : whole ) {
+    in_range = in_range && record.age >= 14 && record.age <= 18
+            && record.weight >= 100 && record.weight <= 285
+            && record.team >= 0 && record.team < 50;
+    const auto age = static_cast<std::size_t>(record.age - 14);
+    weight[age] += record.weight;
+    ability[age] += record.ability;
+    count[age] += 1.0;
+  }
+  results.add_case(in_range, true, "Within the configured ranges");
+  results.add_case(weight[4] / count[4] > weight[0] / count[0] + 10.0,
+                   true, "Older wrestlers weigh more");
+  results.add_case(ability[4] / count[4] > ability[0] / count[0] + 100.0,
+                   true, "Older wrestlers are stronger");
+
+  params.min_age = 19;
+  bool threw {false};
+  try {
+    const Roster_generator invalid {params};
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Rejects an empty age range");
+
+  return results;
+}
+
+auto test_roster_binary() -> ehanc::test
+{
+  ehanc::test results;
+
+  Roster_params params;
+  params.seed    = 5;
+  params.threads = 1;
+  const std::string serial_path {scratch_file("roster_serial.bin")};
+  const std::string parallel_path {scratch_file("roster_parallel.bin")};
+  Roster_generator {params}.write(serial_path, 100'000,
+                                  Roster_encoding::binary);
+  params.threads = 3;
+  Roster_generator {params}.write(parallel_path, 100'000,
+                                  Roster_encoding::binary);
+
+  const Roster_file serial {serial_path};
+  const Roster_file parallel {parallel_path};
+  std::vector<Roster_record> expected;
+  Roster_generator {params}.generate(0, 100'000, expected);
+  std::vector<Roster_record> read;
+  serial.read(99'990, 100, read);
+
+  bool matches {true};
+  for ( std::size_t index {0}; index != serial.size(); ++index ) {
+    matches = matches && same(serial[index], expected[index])
+           && same(parallel[index], expected[index]);
+  }
+  results.add_case(serial.size(), std::size_t {100'000});
+  results.add_case(matches, true, "Same roster on any thread count");
+  results.add_case(read.size(), std::size_t {10},
+                   "Reads clamp at the end");
+
+  std::ofstream {serial_path, std::ios::app} << 'x';
+  bool threw {false};
+  try {
+    const Roster_file truncated {serial_path};
+  } catch ( const std::runtime_error& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Rejects a partial record");
+
+  const std::string huge_path {scratch_file("roster_huge.bin")};
+  bool refused {false};
+  try {
+    Roster_generator {params}.write(huge_path, std::size_t {1} << 31U,
+                                    Roster_encoding::binary);
+  } catch ( const std::invalid_argument& ) {
+    refused = true;
+  }
+  results.add_case(refused && !std::filesystem::exists(huge_path), true,
+                   "Too many ids refused up front");
+
+  std::filesystem::remove(serial_path);
+  std::filesystem::remove(parallel_path);
+  return results;
+}
+
+auto test_roster_csv() -> ehanc::test
+{
+  ehanc::test results;
+
+  Text_buffer text;
+  const std::vector<Roster_record> records {{3, 1, 15, 126, 1480},
+                                            {4, 0, 17, 285, 1710}};
+  encode_roster({records.data(), records.size()}, Roster_encoding::csv,
+                text);
+  results.add_case(text.str(),
+                   std::string {"3,1,15,126,1480\n4,0,17,285,1710\n"});
+
+  const std::string path {scratch_file("roster.csv")};
+  Roster_params params;
+  params.seed = 9;
+  Roster_generator {params}.write(path, 1000, Roster_encoding::csv);
+  std::ifstream file {path};
+  std::string header;
+  std::string line;
+  std::size_t lines {0};
+  std::getline(file, header);
+  while ( std::getline(file, line) ) {
+    ++lines;
+  }
+  results.add_case(header + '\n', std::string {roster_csv_header});
+  results.add_case(lines, std::size_t {1000});
+
+  std::filesystem::remove(path);
+  return results;
+}
+
+void test_roster_file()
+{
+  ehanc::test_section("Roster file", [] {
+    ehanc::run_test("Generator", &test_roster_generator);
+    ehanc::run_test("Binary", &test_roster_binary);
+    ehanc::run_test("CSV", &test_roster_csv);
+  });
+}
@@ -0,0 +1,141 @@
+#include "test_roster_validation.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "random.h"
+
+namespace {
+
+/// `rows` valid 17-year-olds at 150 lbs with distinct ids
+auto valid_roster(const std::size_t rows) -> Roster_columns
+{
+  Roster_columns roster;
+  for ( std::size_t row {0}; row != rows; ++row ) {
+    roster.id.push_back(static_cast<std::int32_t>(row * 7));
+    roster.age.push_back(17);
+    roster.weight.push_back(150);
+    roster.ability.push_back(1500);
+  }
+  return roster;
+}
+
+} // namespace
+
+auto test_validate_ranges() -> ehanc::test
+{
+  ehanc::test results;
+
+  Roster_columns roster {valid_roster(1000)};
+  roster.age[3]       = 4;
+  roster.age[64]      = 26;
+  roster.weight[999]  = 401;
+  roster.ability[130] = -1;
+  roster.ability[131] = 4000;
+
+  const auto classes = Weight_classes::high_school();
+  const Roster_violations violations {validate_roster(roster, classes)};
+  results.add_case(violations.count(Violation::age), std::size_t {2});
+  results.add_case(violations.has(64, Violation::age), true,
+                   "Block boundaries");
+  results.add_case(violations.has(999, Violation::weight), true,
+                   "Partial last block");
+  results.add_case(violations.count(Violation::ability), std::size_t {1},
+                   "Limits are inclusive");
+  results.add_case(violations.violating_rows(),
+                   std::vector<std::size_t> {3, 64, 130, 999});
+
+  const Roster_violations serial {validate_roster(roster, classes, {}, 1)};
+  results.add_case(serial.bitmap(Violation::age),
+                   violations.bitmap(Violation::age),
+                   "Independent of threads");
+
+  roster.ability.pop_back();
+  bool threw {false};
+  try {
+    static_cast<void>(validate_roster(roster, classes));
+  } catch ( const std::invalid_argument& ) {
+    threw = true;
+  }
+  results.add_case(threw, true, "Columns must be the same length");
+
+  return results;
+}
+
+auto test_validate_classes() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto classes = Weight_classes::high_school();
+  Roster_limits limits;
+  limits.allowance = 2;
+  Roster_columns roster {valid_roster(200)};
+  Rng rng {72, 0};
+  bool matches {true};
+  for ( std::size_t row {0}; row != roster.size(); ++row ) {
+    roster.weight[row] = 95 + static_cast<int>(rng.below(200));
+    roster.weight_class.push_back(
+        static_cast<std::uint8_t>(rng.below(16)));
+  }
+  const Roster_violations violations {
+      validate_roster(roster, classes, limits)};
+  for ( std::size_t row {0}; row != roster.size(); ++row ) {
+    const bool eligible {classes.eligible(roster.weight[row],
+                                          roster.weight_class[row],
+                                          limits.allowance,
+                                          limits.classes_up)};
+    matches = matches
+           && violations.has(row, Violation::weight_class) == !eligible;
+  }
+  results.add_case(matches, true, "Agrees with Weight_classes::eligible");
+  results.add_case(violations.count(Violation::weight_class) > 0, true);
+
+  roster.weight_class.clear();
+  results.add_case(validate_roster(roster, classes, limits)
+                       .count(Violation::weight_class),
+                   std::size_t {0}, "No declared classes, no check");
+
+  return results;
+}
+
+auto test_validate_duplicates() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto classes = Weight_classes::high_school();
+  Roster_columns roster {valid_roster(50'000)};
+  roster.id[10]     = roster.id[49'000];
+  roster.id[20]     = roster.id[30];
+  roster.id[40]     = roster.id[30];
+  roster.id[12'345] = -5;
+  const Roster_violations violations {validate_roster(roster, classes)};
+
+  results.add_case(violations.count(Violation::duplicate_id),
+                   std::size_t {5}, "Every copy is marked");
+  results.add_case(violations.has(49'000, Violation::duplicate_id), true);
+  results.add_case(violations.has(40, Violation::duplicate_id), true);
+  results.add_case(violations.has(12'345, Violation::duplicate_id), false);
+
+  // ids too spread out for a bitmap of their range
+  for ( std::size_t row {0}; row != roster.size(); ++row ) {
+    roster.id[row] = static_cast<std::int32_t>(row * 40'000) - 1'000'000;
+  }
+  roster.id[7]      = roster.id[44'444];
+  roster.id[40'000] = roster.id[44'444];
+  const Roster_violations sparse {validate_roster(roster, classes)};
+  results.add_case(sparse.violating_rows(),
+                   std::vector<std::size_t> {7, 40'000, 44'444},
+                   "Sparse ids are partitioned");
+
+  return results;
+}
+
+void test_roster_validation()
+{
+  ehanc::test_section("Roster validation", [] {
+    ehanc::run_test("Ranges", &test_validate_ranges);
+    ehanc::run_test("Classes", &test_validate_classes);
+    ehanc::run_test("Duplicates", &test_validate_duplicates);
+  });
+}
@@ -0,0 +1,116 @@
+#include "test_seeding.h"
+
+#include <vector>
+
+#include "test_bouts.hpp"
+
+namespace {
+
+auto ids_of(const std::vector<Wrestler>& roster,
+            const std::vector<std::size_t>& slots) -> std::vector<int>
+{
+  std::vector<int> ids;
+  for ( const auto slot : slots ) {
+    ids.push_back(roster[slot].id());
+  }
+  return ids;
+}
+
+auto cycle_roster() -> std::vector<Wrestler>
+{
+  return {
+      {1, 16, 120, 50},
+      {2, 16, 120, 60},
+      {3, 16, 120, 70},
+      {4, 16, 120, 10},
+      {5, 16, 120, 0},
+  };
+}
+
+void add_cycle_results(Seeding_engine& engine)
+{
+  engine.add_result(make_bout(1, 2));
+  engine.add_result(make_bout(2, 3));
+  engine.add_result(make_bout(3, 1));
+  for ( int id {1}; id != 4; ++id ) {
+    engine.add_result(make_bout(id, 4));
+  }
+  engine.add_result(make_bout(4, 5));
+}
+
+} // namespace
+
+auto test_seeding_circular_head_to_head() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto roster = cycle_roster();
+  Seeding_engine engine {roster,
+                         {0, 0, 0, 0, 0},
+                         {Seed_criterion::head_to_head,
+                          Seed_criterion::ability}};
+  add_cycle_results(engine);
+
+  results.add_case(ids_of(roster, engine.seeds(0)),
+                   std::vector<int> {3, 2, 1, 4, 5},
+                   "Cycle is tied and broken by ability");
+
+  return results;
+}
+
+auto test_seeding_incremental() -> ehanc::test
+{
+  ehanc::test results;
+
+  const auto roster = cycle_roster();
+  Seeding_engine engine {roster,
+                         {0, 0, 0, 0, 0},
+                         {Seed_criterion::head_to_head,
+                          Seed_criterion::ability}};
+  add_cycle_results(engine);
+  engine.reseed_all();
+
+  engine.add_result(make_bout(5, 4));
+  engine.add_result(make_bout(5, 4));
+
+  results.add_case(ids_of(roster, engine.seeds(0)),
+                   std::vector<int> {3, 2, 1, 5, 4},
+                   "New results reach the next lookup");
+
+  return results;
+}
+
+auto test_seeding_common_opponents() -> ehanc::test
+{
+  ehanc::test results;
+
+  const std::vector<Wrestler> roster {
+      {6, 16, 132, 10},
+      {7, 16, 132, 90},
+      {8, 16, 138, 50},
+  };
+  Seeding_engine engine {roster,
+                         {0, 0, 1},
+                         {Seed_criterion::head_to_head,
+                          Seed_criterion::common_opponents,
+                          Seed_criterion::ability}};
+  engine.add_result(make_bout(6, 8));
+  engine.add_result(make_bout(8, 7));
+
+  results.add_case(ids_of(roster, engine.seeds(0)),
+                   std::vector<int> {6, 7},
+                   "Common opponent outranks ability");
+  results.add_case(ids_of(roster, engine.seeds(1)), std::vector<int> {8});
+
+  return results;
+}
+
+void test_seeding()
+{
+  ehanc::test_section("Seeding", [] {
+    ehanc::run_test("Circular head to head",
+                    &test_seeding_circular_head_to_head);
+    ehanc::run_test("Incremental reseed", &test_seeding_incremental);
+    ehanc::run_test("Common opponents", &test_seeding_common_opponents);
+  });
+}
@@ -0,0 +1,129 @@
+#include "test_seeding_optimizer.h"
+
+#include <cmath>
+#include <vector>
+
+#include "bracket.h"
+
+namespace {
+
+auto close(const double lhs, const double rhs) -> bool
+{
+  return std::abs(lhs - rhs) < 1e-9;
+}
+
+/// `count` wrestlers 40 points apart, strongest first
+auto ladder_table(const std::size_t count) -> Probability_table
+{
+  std::vector<Wrestler> wrestlers;
+  for ( std::size_t index {0}; index != count; ++index ) {
+    const int rank {static_cast<int>(index)};
+    wrestlers.emplace_back(rank, 17, 150, 1800 - 40 * rank);
+  }
+  return Probability_table {wrestlers};
+}
+
+} // namespace
+
+auto test_bracket_probabilities() -> ehanc::test
+{
+  ehanc::test results;
+
+  Probability_table pair {2};
+  pair.set(0, 1, 0.7);
+  const Bracket_evaluator final {pair, {1, 0}};
+  results.add_case(close(final.reach(1, 1), 0.7), true, "Two entrants");
+
+  const Probability_table table {ladder_table(6)};
+  const Bracket_evaluator draw {
+      table, {0, bye_line, 4, 3, 1, bye_line, 2, 5}};
+
+  double champions {0.0};
+  for ( std::size_t line {0}; line != 8; ++line ) {
+    champions += draw.reach(draw.rounds(), line);
+  }
+  results.add_case(close(champions, 1.0), true,
+                   "Championship chances sum to one");
+  results.add_case(close(draw.reach(1, 0), 1.0), true,
+                   "Bye advances automatically");
+  results.add_case(close(draw.reach(1, 2), table(4, 3)), true,
+                   "First-round bout");
+
+  return results;
+}
+
+auto test_incremental_swap() -> ehanc::test
+{
+  ehanc::test results;
+
+  const Probability_table table {ladder_table(13)};
+  std::vector<std::size_t> lines(16, bye_line);
+  for ( std::size_t entrant {0}; entrant != 13; ++entrant ) {
+    lines[(entrant * 5) % 16] = entrant;
+  }
+
+  Bracket_evaluator draw {table, lines};
+
+  draw.swap(0, 11);
+  draw.swap(3, 4);
+  Bracket_evaluator fresh {table, draw.lines()};
+  results.add_case(close(draw.objective(), fresh.objective()), true,
+                   "Incremental matches full evaluation");
+  results.add_case(close(draw.reach(4, 3), fresh.reach(4, 3)), true,
+                   "Probabilities match after swaps");
+
+  draw.undo();
+  draw.swap(3, 4);
+  draw.undo();
+  draw.undo();
+  fresh = Bracket_evaluator {table, draw.lines()};
+  results.add_case(close(draw.objective(), fresh.objective()), true,
+                   "Undo restores the state");
+  std::swap(lines[0], lines[11]);
+  results.add_case(draw.lines(), lines, "Undo reverts only the last swap");
+  draw.undo();
+  results.add_case(draw.lines(), lines, "Only one level of undo");
+
+  return results;
+}
+
+auto test_optimize_seeding() -> ehanc::test
+{
+  ehanc::test results;
+
+  const Probability_table table {ladder_table(12)};
+  std::vector<std::size_t> lines(16, bye_line);
+  for ( std::size_t entrant {0}; entrant != 12; ++entrant ) {
+    lines[(entrant * 7 + 3) % 16] = entrant;
+  }
+  std::vector<bool> pinned(16, false);
+  pinned[3] = true;
+
+  Tempering_params params;
+  params.replicas = 4;
+  params.sweeps   = 40;
+  params.seed     = 5;
+
+  params.threads = 1;
+  const auto serial = optimize_seeding(table, lines, pinned, params);
+  params.threads = 4;
+  const auto parallel = optimize_seeding(table, lines, pinned, params);
+
+  results.add_case(serial.objective < serial.initial_objective, true,
+                   "Search improves the draw");
+  results.add_case(serial.lines[3], lines[3], "Pinned line kept");
+  results.add_case(serial.lines[5], bye_line, "Byes stay in place");
+  results.add_case(serial.lines, parallel.lines,
+                   "Same seed, same draw at any thread count");
+
+  return results;
+}
+
+void test_seeding_optimizer()
+{
+  ehanc::test_section("Seeding optimizer", [] {
+    ehanc::run_test("Bracket probabilities", &test_bracket_probabilities);
+    ehanc::run_test("Incremental swap", &test_incremental_swap);
+    ehanc::run_test("Optimize seeding", &test_optimize_seeding);
+  });
+}
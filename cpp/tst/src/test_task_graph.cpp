@@ -0,0 +1,221 @@
+#include "test_task_graph.h"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "work_deque.h"
+
+namespace {
+
+/// Layers of `width` tasks, each depending on two tasks of the layer
+/// before; `log` receives task ids in the order they ran
+void layered_graph(Task_graph& graph, const std::size_t layers,
+                   const std::size_t width, std::mutex& mutex,
+                   std::vector<std::size_t>& log)
+{
+  std::vector<Task_graph::Task_id> previous;
+  for ( std::size_t layer {0}; layer != layers; ++layer ) {
+    std::vector<Task_graph::Task_id> current;
+    for ( std::size_t index {0}; index != width; ++index ) {
+      std::vector<Task_graph::Task_id> after;
+      if ( !previous.empty() ) {
+        after.push_back(previous[index]);
+        after.push_back(previous[(index * 7 + 1) % width]);
+      }
+      const std::size_t id {graph.size()};
+      current.push_back(graph.add(
+          [&mutex, &log, id] {
+            const std::lock_guard<std::mutex> lock {mutex};
+            log.push_back(id);
+          },
+          after));
+    }
+    previous = std::move(current);
+  }
+}
+
+} // namespace
+
+auto test_work_deque() -> ehanc::test
+{
+  ehanc::test results;
+
+  Work_deque deque {3};
+  deque.push(1);
+  deque.push(2);
+  deque.push(3);
+  deque.push(4);
+
+  results.add_case(deque.steal(), std::size_t {1},
+                   "Thieves take the oldest");
+  results.add_case(deque.pop(), std::size_t {4}, "Owner takes the newest");
+  results.add_case(deque.pop(), std::size_t {3});
+  results.add_case(deque.steal(), std::size_t {2});
+  results.add_case(deque.pop(), Work_deque::empty);
+  results.add_case(deque.steal(), Work_deque::empty);
+
+  return results;
+}
+
+auto test_task_graph_order() -> ehanc::test
+{
+  ehanc::test results;
+
+  // a diamond per layer: 0 -> {1, 2} -> 3 -> {4, 5} -> 6
+  std::mutex mutex;
+  std::vector<std::size_t> finished;
+  Task_graph graph;
+  const auto record = [&](const std::size_t task) {
+    return [&, task] {
+      const std::lock_guard<std::mutex> lock {mutex};
+      finished.push_back(task);
+    };
+  };
+  const auto root = graph.add(record(0));
+  const auto left = graph.add(record(1), {root});
+  const auto right = graph.add(record(2), {root});
+  const auto join = graph.add(record(3), {left, right});
+  const auto again = graph.add(record(4), {join});
+  const auto other = graph.add(record(5), {join});
+  graph.add(record(6), {again, other});
+  graph.run(3);
+
+  std::vector<std::size_t> position(7);
+  for ( std::size_t index {0}; index != finished.size(); ++index ) {
+    position[finished[index]] = index;
+  }
+
+  results.add_case(finished.size(), std::size_t {7}, "Every task ran");
+  results.add_case(position[0] < position[1] && position[0] < position[2]
+                       && position[1] < position[3]
+                       && position[2] < position[3]
+                       && position[3] < position[4]
+                       && position[5] < position[6],
+                   true, "Dependencies respected");
+
+  return results;
+}
+
+auto test_task_graph_failure() -> ehanc::test
+{
+  ehanc::test results;
+
+  bool later_ran {false};
+  Task_graph graph;
+  const auto failing =
+      graph.add([] { throw std::runtime_error {"stage failed"}; });
+  graph.add([&] { later_ran = true; }, {failing});
+
+  bool caught {false};
+  try {
+    graph.run(2);
+  } catch ( const std::runtime_error& ) {
+    caught = true;
+  }
+
+  results.add_case(caught, true, "Failure rethrown");
+  results.add_case(later_ran, false, "Dependents skipped");
+
+  return results;
+}
+
+auto test_task_graph_deterministic() -> ehanc::test
+{
+  ehanc::test results;
+
+  std::mutex mutex;
+  std::vector<std::size_t> first;
+  std::vector<std::size_t> second;
+
+  Task_graph graph;
+  layered_graph(graph, 6, 5, mutex, first);
+  graph.run_deterministic();
+
+  Task_graph again;
+  layered_graph(again, 6, 5, mutex, second);
+  again.run_deterministic();
+
+  results.add_case(first.size(), std::size_t {30});
+  results.add_case(first, second, "Same graph, same order");
+
+  return results;
+}
+
+auto test_task_graph_stealing() -> ehanc::test
+{
+  ehanc::test results;
+
+  // one root fans out to many tasks, so the other workers must steal
+  constexpr std::size_t leaves {2000};
+  std::vector<std::atomic<int>> runs(leaves);
+  std::atomic<int> joined {0};
+
+  Task_graph graph;
+  const auto root = graph.add([] {});
+  std::vector<Task_graph::Task_id> fan;
+  for ( std::size_t leaf {0}; leaf != leaves; ++leaf ) {
+    fan.push_back(graph.add([&runs, leaf] { ++runs[leaf]; }, {root}));
+  }
+  graph.add([&] { ++joined; }, fan);
+  graph.run(4);
+
+  bool once {true};
+  for ( const auto& count : runs ) {
+    once = once && count.load() == 1;
+  }
+
+  results.add_case(once, true, "Every task ran exactly once");
+  results.add_case(joined.load(), 1, "Join ran after the fan-out");
+
+  return results;
+}
+
+auto test_task_graph_idle() -> ehanc::test
+{
+  ehanc::test results;
+
+  // a chain leaves all but one worker idle; they should sleep, not spin
+  Task_graph graph;
+  std::size_t done {0};
+  Task_graph::Task_id previous {graph.add([&done] { ++done; })};
+  for ( int task {0}; task != 20; ++task ) {
+    previous = graph.add(
+        [&done] {
+          std::this_thread::sleep_for(std::chrono::milliseconds {2});
+          ++done;
+        },
+        {previous});
+  }
+
+  const std::clock_t cpu_start {std::clock()};
+  const auto wall_start = std::chrono::steady_clock::now();
+  graph.run(4);
+  const double cpu {static_cast<double>(std::clock() - cpu_start)
+                    / CLOCKS_PER_SEC};
+  const std::chrono::duration<double> wall {
+      std::chrono::steady_clock::now() - wall_start};
+
+  results.add_case(done, std::size_t {21});
+  results.add_case(cpu < wall.count() / 2, true,
+                   "Idle workers sleep instead of spinning");
+
+  return results;
+}
+
+void test_task_graph()
+{
+  ehanc::test_section("Task graph", [] {
+    ehanc::run_test("Work deque", &test_work_deque);
+    ehanc::run_test("Order", &test_task_graph_order);
+    ehanc::run_test("Failure", &test_task_graph_failure);
+    ehanc::run_test("Deterministic", &test_task_graph_deterministic);
+    ehanc::run_test("Stealing", &test_task_graph_stealing);
+    ehanc::run_test("Idle workers", &test_task_graph_idle);
+  });
+}
@@ -0,0 +1,95 @@
+#include "test_text_format.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+auto test_format_numbers() -> ehanc::test
+{
+  ehanc::test results;
+
+  Text_buffer text;
+  text << 42 << ' ' << -7L << ' ' << std::uint64_t {18446744073709551615U};
+  results.add_case(text.str(), std::string {"42 -7 18446744073709551615"});
+
+  text.clear();
+  text << Fixed {0.125, 2} << ' ' << Fixed {1.0 / 3.0, 4} << ' '
+       << Fixed {2.5, 0} << ' ' << Fixed {-0.05, 1};
+  results.add_case(text.str(), std::string {"0.12 0.3333 2 -0.1"},
+                   "Rounds like std::fixed");
+
+  text.clear();
+  text << Fixed {std::numeric_limits<double>::quiet_NaN(), 3} << ' '
+       << Fixed {-std::numeric_limits<double>::infinity(), 3};
+  results.add_case(text.str(), std::string {"nan -inf"});
+
+  text.clear();
+  text << true << ' ' << "text" << ' ' << std::string {"string"} << 'c';
+  results.add_case(text.str(), std::string {"true text stringc"},
+                   "Literals are text, not bool");
+
+  return results;
+}
+
+auto test_format_padding() -> ehanc::test
+{
+  ehanc::test results;
+
+  Text_buffer text;
+  text << Padded {"name", 8, '.'} << '|'
+       << Padded {17, 5, ' ', Align::right} << '|'
+       << Padded {Fixed {0.5, 2}, 6, '0', Align::right} << '|'
+       << Padded {"too long", 3};
+  results.add_case(text.str(),
+                   std::string {"name....|   17|000.50|too long"});
+
+  // a padded string keeps its own copy of the text
+  const Padded owned {std::string {"kept"}, 6, '-', Align::right};
+  text.clear();
+  text << owned;
+  results.add_case(text.str(), std::string {"--kept"},
+                   "Padded string outlives its source");
+
+  // colour codes pass through untouched
+  text.clear();
+  text << "\033[31m" << "red" << "\033[0m";
+  results.add_case(text.size(), std::size_t {12});
+
+  return results;
+}
+
+auto test_format_flush() -> ehanc::test
+{
+  ehanc::test results;
+
+  std::FILE* const file {std::tmpfile()};
+  {
+    Text_buffer text {file, 16};
+    for ( int row {0}; row != 1000; ++row ) {
+      text << row << ',' << Fixed {row / 1000.0, 3} << '\n';
+    }
+    results.add_case(text.size() < 1024, true, "Flushes as it fills");
+  }
+  const long bytes {std::ftell(file)};
+  std::string last(16, '\0');
+  std::fseek(file, bytes - 10, SEEK_SET);
+  last.resize(std::fread(last.data(), 1, last.size(), file));
+  std::fclose(file);
+
+  // 10 + 90 * 2 + 900 * 3 digits, 1000 times ",0.xxx\n"
+  results.add_case(bytes, long {2890 + 7000});
+  results.add_case(last, std::string {"999,0.999\n"},
+                   "Flushed on destruction");
+
+  return results;
+}
+
+void test_text_format()
+{
+  ehanc::test_section("Text format", [] {
+    ehanc::run_test("Numbers", &test_format_numbers);
+    ehanc::run_test("Padding", &test_format_padding);
+    ehanc::run_test("Flush", &test_format_flush);
+  });
+}